@@ -0,0 +1,19 @@
+/**
+ * @file baseline.h
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Header file for the baseline correction related functions & data.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#pragma once
+
+/* */
+#define BASELINE_MIN_ORDER  1
+#define BASELINE_MAX_ORDER  6
+
+/* Functions prototype */
+int baseline_poly_remove( float *, const int, const int );
+int baseline_segment_remove( float *, const int, const int, const int );
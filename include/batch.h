@@ -0,0 +1,21 @@
+/**
+ * @file batch.h
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Header file for the batch (multi-thread) job dispatcher.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#pragma once
+
+/* */
+#define BATCH_MAX_THREADS  256
+
+/* The job function, it will be called with the user argument & the job index */
+typedef void (*BATCH_JOB_FUNC)( void *, const int );
+
+/* Functions prototype */
+int batch_threads_default( void );
+int batch_jobs_run( const int, const int, BATCH_JOB_FUNC, void * );
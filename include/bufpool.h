@@ -0,0 +1,42 @@
+/**
+ * @file bufpool.h
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Header file for the size-class buffer pool related functions & data.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#pragma once
+
+/* */
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/* */
+#define BUFPOOL_ALIGNMENT       64                  /* Bytes, also the size of the block header */
+#define BUFPOOL_MIN_CLASS       12                  /* 4 KiB */
+#define BUFPOOL_MAX_CLASS       34                  /* 16 GiB, the larger one won't be pooled */
+#define BUFPOOL_NUM_CLASSES     (BUFPOOL_MAX_CLASS - BUFPOOL_MIN_CLASS + 1)
+#define BUFPOOL_CACHE_DEPTH     4                   /* Max cached buffers of each class per thread */
+#define BUFPOOL_CACHE_LIMIT     ((size_t)1 << 30)   /* Max cached bytes per thread */
+#define BUFPOOL_HUGE_THRESHOLD  ((size_t)2 << 20)   /* The larger one is mapped & hinted for the huge pages */
+
+/*----------------------------------------------------------------------*
+ * Definition of the statistics, the bytes are the requested sizes      *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	uint64_t pool_count;   /* Number of the requests served from the pool */
+	uint64_t pool_bytes;
+	uint64_t fresh_count;  /* Number of the requests served by the fresh allocation */
+	uint64_t fresh_bytes;
+} BUFPOOL_STATS;
+
+/* Functions prototype */
+void *bufpool_alloc( const size_t );
+void bufpool_free( void * );
+void bufpool_thread_flush( void );
+BUFPOOL_STATS *bufpool_stats_get( BUFPOOL_STATS * );
+void bufpool_stats_report( FILE * );
@@ -0,0 +1,37 @@
+/**
+ * @file despike.h
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Header file for the despike (running median & MAD) related functions & data.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#pragma once
+
+/* */
+#define DESPIKE_DEF_FACTOR      6.0     /* Spike when |x - median| > factor * 1.4826 * MAD */
+#define DESPIKE_MAD_SCALE       1.4826
+#define DESPIKE_MIN_WINDOW      5
+
+/*----------------------------------------------------------------------*
+ * Definition of the running median, two heaps share one index array    *
+ * which is centered at the median: the positive side is the min-heap   *
+ * of the upper half & the negative side is the max-heap of the lower   *
+ * half. Each update is O(log w)                                        *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	float *data;    /* Circular buffer of the values within window */
+	int   *pos;     /* Position in the heap of each value */
+	int   *heap;    /* Centered heap of the indexes into data */
+	int    window;
+	int    idx;     /* Next position of the circular buffer */
+	int    count;   /* Number of values within window */
+} RUN_MEDIAN;
+
+/* Functions prototype */
+int despike_run_median_init( RUN_MEDIAN *, const int );
+float despike_run_median_push( RUN_MEDIAN *, const float );
+void despike_run_median_free( RUN_MEDIAN * );
+int despike_process( float *, const int, const int, const double );
@@ -0,0 +1,32 @@
+/**
+ * @file eew.h
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Header file for the earthquake early warning parameters (Tau-c & Pd) related functions & data.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#pragma once
+
+/* */
+#define EEW_HP_CORNER_FREQ  0.075  /* Same as the high pass filter of sac_int */
+#define EEW_HP_ORDER        2
+#define EEW_WINDOW_MIN_SEC  0.5
+#define EEW_WINDOW_MAX_SEC  3.0
+
+/*----------------------------------------------------------------------*
+ * Definition of the EEW parameters within the window after P arrival   *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	double window;  /* Length of the window after P arrival (sec) */
+	double tauc;    /* Tau-c, 2 * pi * sqrt(sum(u^2) / sum(v^2)) (sec) */
+	double pd;      /* Peak displacement */
+	double pv;      /* Peak velocity */
+	double pa;      /* Peak acceleration */
+} EEW_PARAM;
+
+/* Functions prototype */
+int eew_window_count( const double );
+int eew_tauc_pd_calc( const float *, const int, const double, const int, EEW_PARAM *, const int );
@@ -0,0 +1,37 @@
+/**
+ * @file fft.h
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Header file for the self-contained mixed radix FFT related functions & data.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#pragma once
+
+/* */
+#include <complex.h>
+
+/* */
+#define FFT_MAX_FACTORS  32
+
+/*----------------------------------------------------------------------*
+ * Definition of FFT plan structure, the plans are cached by length     *
+ * & shared between threads, so they should be treated as read-only     *
+ *----------------------------------------------------------------------*/
+typedef struct fft_plan {
+	int               n;       /* Length of the real sequence */
+	int               ncpx;    /* Length of the complex transform, n / 2 for even n, n for odd n */
+	int               factors[FFT_MAX_FACTORS * 2];
+	double _Complex  *twiddles;      /* Twiddles of the complex transform */
+	double _Complex  *super_twiddles;  /* Twiddles for splitting the packed real transform */
+	struct fft_plan  *next;
+} FFT_PLAN;
+
+/* Functions prototype */
+const FFT_PLAN *fft_plan_get( const int );
+void fft_plan_cache_free( void );
+int  fft_size_good( const int );
+int  fft_real_forward( const FFT_PLAN *, const double *, double _Complex * );
+int  fft_real_inverse( const FFT_PLAN *, const double _Complex *, double * );
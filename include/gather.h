@@ -0,0 +1,53 @@
+/**
+ * @file gather.h
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Header file for the event gather (multi-station, three components) related functions & data.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#pragma once
+
+/* */
+#include <sachead.h>
+
+/* */
+#define GATHER_ALIGNMENT       64   /* Bytes, the alignment of each trace within the arena */
+#define GATHER_NUM_COMPONENTS  3
+#define GATHER_COMP_Z          0
+#define GATHER_COMP_N          1
+#define GATHER_COMP_E          2
+
+/*----------------------------------------------------------------------*
+ * Definition of one station of the gather, the headers are the ones    *
+ * of the original files & the mask marks the loaded components         *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	char           sta[K_LEN + 1];
+	char           net[K_LEN + 1];
+	char           loc[K_LEN + 1];
+	int            mask;                       /* Bit c is set if the component c is loaded */
+	struct SAChead sh[GATHER_NUM_COMPONENTS];
+} GATHER_STATION;
+
+/*----------------------------------------------------------------------*
+ * Definition of the gather, all the traces are cut to the common time  *
+ * window & stored in one arena by component then station, so all the  *
+ * traces of one component are contiguous with the fixed stride         *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	int             nstations;
+	int             npts;        /* Common number of samples */
+	int             stride;      /* Samples between the successive traces, multiple of the alignment */
+	double          delta;       /* Common sampling interval (sec) */
+	double          starttime;   /* Common absolute time of the first sample */
+	float          *arena;
+	float         **comp[GATHER_NUM_COMPONENTS];  /* comp[c][station], NULL if it is missing */
+	GATHER_STATION *stations;    /* Sorted by network, station & location */
+} SAC_GATHER;
+
+/* Functions prototype */
+int gather_load( char * const *, const int, const int, SAC_GATHER * );
+void gather_free( SAC_GATHER * );
@@ -0,0 +1,30 @@
+/**
+ * @file geodesic.h
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Header file for the event-station geometry related functions & data.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#pragma once
+
+/* */
+#define GEODESIC_EARTH_RADIUS  6371.0                 /* Mean radius of the Earth (km) */
+#define GEODESIC_FLATTENING    (1.0 / 298.257223563)  /* WGS84 */
+
+/*----------------------------------------------------------------------*
+ * Definition of the geometry results of the stations, each member is   *
+ * one array (structure of arrays), so the calculation of all the       *
+ * stations can be done in one loop                                     *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	float *dist;   /* Epicentral distance (km) */
+	float *az;     /* Event to station azimuth (deg) */
+	float *baz;    /* Station to event azimuth (deg) */
+	float *gcarc;  /* Great circle arc distance (deg) */
+} GEODESIC_RESULT;
+
+/* Functions prototype */
+void geodesic_distaz( const double, const double, const double *restrict, const double *restrict, const int, GEODESIC_RESULT * );
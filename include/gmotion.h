@@ -0,0 +1,32 @@
+/**
+ * @file gmotion.h
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Header file for the ground motion metrics related functions & data.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#pragma once
+
+/* */
+#define GM_GRAVITY_GAL     980.665  /* Standard gravity in gal (cm/s^2) */
+#define GM_DURATION_START  0.05     /* Significant duration from 5% ... */
+#define GM_DURATION_END    0.95     /* ... to 95% of the Arias intensity */
+
+/*----------------------------------------------------------------------*
+ * Definition of the ground motion metrics of one component, the input  *
+ * acceleration is in gal & the times are relative to the first sample  *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	double pga;     /* Peak ground acceleration (gal) */
+	double arias;   /* Arias intensity (m/s) */
+	double cav;     /* Cumulative absolute velocity (cm/s) */
+	double t_start; /* Time of 5% Arias intensity (sec) */
+	double t_end;   /* Time of 95% Arias intensity (sec) */
+	double dur;     /* Significant duration, t_end - t_start (sec) */
+} GM_METRICS;
+
+/* Functions prototype */
+int gmotion_metrics_calc( const float *, const int, const double, GM_METRICS * );
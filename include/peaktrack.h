@@ -0,0 +1,44 @@
+/**
+ * @file peaktrack.h
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Header file for the sliding-window peak tracker related functions & data.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#pragma once
+
+/*----------------------------------------------------------------------*
+ * Definition of the monotonic deque, the ring buffer keeps the sample  *
+ * index & value which might still become the extreme of the window     *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	long  *index;
+	float *value;
+	int    head;
+	int    size;
+} PEAK_DEQUE;
+
+/*----------------------------------------------------------------------*
+ * Definition of the streaming state of the peak tracker                *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	int        window;    /* Length of the window in samples */
+	int        capacity;  /* Capacity of the ring buffers, it is window + 1 */
+	long       count;     /* Total pushed samples */
+	PEAK_DEQUE max;
+	PEAK_DEQUE min;
+} PEAK_TRACKER;
+
+/* Functions prototype */
+int   peaktrack_init( PEAK_TRACKER *, const int );
+void  peaktrack_push( PEAK_TRACKER *, const float );
+float peaktrack_max( const PEAK_TRACKER * );
+float peaktrack_min( const PEAK_TRACKER * );
+float peaktrack_absmax( const PEAK_TRACKER * );
+void  peaktrack_reset( PEAK_TRACKER * );
+void  peaktrack_free( PEAK_TRACKER * );
+int   peaktrack_running_absmax( const float *, const int, const int, float * );
+float *peaktrack_vector_magnitude( const float *, const float *, const float *, const int, float * );
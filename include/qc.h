@@ -0,0 +1,72 @@
+/**
+ * @file qc.h
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Header file for the data quality control metrics related functions & data.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#pragma once
+
+/* */
+#define QC_BLOCK_SAMPLES       4096        /* Block size of the streaming pass, also the window of spike detection */
+#define QC_DEF_CLIP_LEVEL      8388000.0   /* Close to the full scale of 24-bit digitizer in counts */
+#define QC_DEF_SPIKE_FACTOR    10.0        /* Spike when |x - median| > factor * 1.4826 * MAD */
+#define QC_DEF_DEAD_STD        1.0         /* Dead channel when the standard deviation is below this (counts) */
+#define QC_DEF_DC_RATIO        3.0         /* DC offset when |mean| > ratio * standard deviation */
+#define QC_MIN_CLIP_RUN        2           /* Minimum number of continuous samples of one clipped run */
+#define QC_MAD_SCALE           1.4826
+
+/*----------------------------------------------------------------------*
+ * Definition of the thresholds of the QC flags                         *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	double clip_level;
+	double spike_factor;
+	double dead_std;
+	double dc_ratio;
+} QC_PARAM;
+
+/*----------------------------------------------------------------------*
+ * Definition of the QC metrics of one channel, all the statistics are  *
+ * only over the defined samples                                        *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	int    npts;          /* Total number of samples */
+	int    ngaps;         /* Number of the gap runs */
+	int    gap_samples;   /* Number of the undefined samples */
+	double avail;         /* Data availability (%) */
+	double mean;
+	double rms;
+	double min;
+	double max;
+	int    clip_runs;     /* Number of the clipped runs */
+	int    clip_samples;  /* Number of the samples within clipped runs */
+	int    spikes;        /* Number of the MAD-based spike samples */
+	int    dead;          /* Dead channel flag */
+	int    dc;            /* DC offset flag */
+} QC_METRICS;
+
+/*----------------------------------------------------------------------*
+ * Definition of the streaming state, the samples are fed block by      *
+ * block & all the metrics are accumulated within the same pass         *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	QC_PARAM   param;
+	QC_METRICS metrics;
+	double     sum;
+	double     sqsum;
+	int        defined;       /* Number of the defined samples */
+	int        in_gap;        /* The last sample is undefined */
+	int        clip_run;      /* Length of the current clipped run */
+	int        nwork;         /* Number of the defined samples in work buffer */
+	float      work[QC_BLOCK_SAMPLES];
+	float      dev[QC_BLOCK_SAMPLES];
+} QC_STATE;
+
+/* Functions prototype */
+void qc_state_init( QC_STATE *, const QC_PARAM * );
+void qc_state_update( QC_STATE *, const float *, const int );
+void qc_state_finish( QC_STATE *, QC_METRICS * );
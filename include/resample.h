@@ -0,0 +1,53 @@
+/**
+ * @file resample.h
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Header file for the polyphase FIR resampling related functions & data.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#pragma once
+
+/* */
+#define RESAMPLE_MAX_FACTOR   1000
+#define RESAMPLE_HALF_ZEROS   10      /* Zero crossings of the sinc on each side */
+#define RESAMPLE_KAISER_BETA  5.0
+#define RESAMPLE_SIMD_WIDTH   8       /* Taps of each phase are padded to this width */
+
+/*----------------------------------------------------------------------*
+ * Definition of resampling kernel, the kernels are cached by ratio &   *
+ * shared between threads, so they should be treated as read-only       *
+ *----------------------------------------------------------------------*/
+typedef struct resample_kernel {
+	int    up;       /* Interpolation factor */
+	int    down;     /* Decimation factor */
+	int    half_len; /* Half length of the prototype filter at the upsampled rate */
+	int    ntaps;    /* Padded number of taps of each phase */
+	float *taps;     /* Reversed taps of all the phases, up * ntaps */
+	struct resample_kernel *next;
+} RESAMPLE_KERNEL;
+
+/*----------------------------------------------------------------------*
+ * Definition of the streaming state of the resampler                   *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	const RESAMPLE_KERNEL *kernel;
+	float *buffer;      /* Input samples from absolute index buf_start */
+	int    buf_len;
+	int    buf_cap;
+	long   buf_start;
+	long   in_count;    /* Total input samples */
+	long   out_count;   /* Total output samples */
+} RESAMPLE_STATE;
+
+/* Functions prototype */
+const RESAMPLE_KERNEL *resample_kernel_get( const int, const int );
+void resample_kernel_cache_free( void );
+int  resample_ratio_reduce( int *, int * );
+long resample_output_length( const long, const int, const int );
+int  resample_state_init( RESAMPLE_STATE *, const int, const int );
+int  resample_process( RESAMPLE_STATE *, const float *, const int, float *, const int );
+int  resample_flush( RESAMPLE_STATE *, float *, const int );
+void resample_state_free( RESAMPLE_STATE * );
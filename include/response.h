@@ -0,0 +1,57 @@
+/**
+ * @file response.h
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Header file for the instrument response (poles & zeros) removal related functions & data.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#pragma once
+
+/* */
+#include <complex.h>
+/* */
+#include <sac.h>
+
+/* */
+#define RESP_MAX_PZ          32
+#define RESP_DEF_WATER_LEVEL 60.0   /* In dB below the maximum amplitude */
+#define RESP_TIME_TAPER      0.05   /* Ratio of the cosine taper at each end of the trace */
+
+/*----------------------------------------------------------------------*
+ * Definition of the poles & zeros response, the unused poles & zeros   *
+ * are kept as zero, so two identical responses are equal by memcmp     *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	int             nzeros;
+	int             npoles;
+	double          constant;
+	double _Complex zeros[RESP_MAX_PZ];
+	double _Complex poles[RESP_MAX_PZ];
+} RESP_PZ;
+
+/*----------------------------------------------------------------------*
+ * Definition of the response of one channel                            *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	char    scnl[SAC_MAX_SCNL_LENGTH];
+	RESP_PZ pz;
+} RESP_CHANNEL;
+
+/*----------------------------------------------------------------------*
+ * Definition of the removal parameters, the pre-filter is the cosine   *
+ * taper in frequency domain, it will be turned off when freqs[3] <= 0  *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	double water_level;
+	double freqs[4];
+} RESP_PARAM;
+
+/* Functions prototype */
+int  response_file_load( const char *, RESP_CHANNEL ** );
+const RESP_CHANNEL *response_channel_find( const RESP_CHANNEL *, const int, const char * );
+const double _Complex *response_inverse_get( const RESP_PZ *, const int, const double, const RESP_PARAM * );
+void response_cache_free( void );
+int  response_remove( float *, const int, const double, const RESP_PZ *, const RESP_PARAM * );
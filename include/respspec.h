@@ -0,0 +1,33 @@
+/**
+ * @file respspec.h
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Header file for the elastic response spectrum related functions & data.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#pragma once
+
+/* */
+#define RSP_DEF_NUM_PERIODS  100
+#define RSP_DEF_MIN_PERIOD   0.01
+#define RSP_DEF_MAX_PERIOD   10.0
+#define RSP_DEF_DAMPING      0.05
+
+/*----------------------------------------------------------------------*
+ * Definition of single oscillator's result, total size is 48 bytes     *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	double period;   /* Natural period of the oscillator (sec) */
+	double damping;  /* Damping ratio of the oscillator */
+	double sd;       /* Peak relative displacement */
+	double psv;      /* Pseudo-spectral velocity, omega * sd */
+	double psa;      /* Pseudo-spectral acceleration, omega^2 * sd */
+	double sa;       /* Peak absolute acceleration */
+} RSP_RESULT;
+
+/* Functions prototype */
+int respspec_periods_gen( double *, const int, const double, const double );
+int respspec_calc( const float *, const int, const double, const double *, const int, const double *, const int, RSP_RESULT * );
@@ -0,0 +1,30 @@
+/**
+ * @file rotate.h
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Header file for the horizontal components rotation related functions & data.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#pragma once
+
+/* */
+#define ROTATE_MIN_ORTHOGONAL  0.1   /* Minimum |sin| between the two input azimuths */
+
+/*----------------------------------------------------------------------*
+ * Definition of the 2x2 rotation matrix, it maps the two recorded      *
+ * horizontal components to the two target azimuths:                    *
+ *   out1 = m11 * in1 + m12 * in2                                       *
+ *   out2 = m21 * in1 + m22 * in2                                       *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	float m11, m12;
+	float m21, m22;
+} ROTATE_MATRIX;
+
+/* Functions prototype */
+int rotate_matrix_calc( const double, const double, const double, const double, ROTATE_MATRIX * );
+void rotate_horizontal( float *restrict, float *restrict, const int, const ROTATE_MATRIX * );
+double rotate_azimuth_normalize( const double );
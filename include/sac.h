@@ -3,15 +3,73 @@
  */
 #pragma once
 /* */
+#include <stdio.h>
 #include <sachead.h>
+#include <sacz.h>
+#include <bufpool.h>
 /* */
 #define SAC_FILE_NAME_FORMAT  "%s/%s.%s.%s.%s"
 #define SAC_MAX_SCNL_LENGTH   64
+#define SAC_SCNL_KEY_LENGTH   (K_LEN * 4)  /* Packed station, channel, network & location */
+#define SAC_MAX_PATH_LENGTH   1024
+/* The layout of the file, the return value of the header reading */
+#define SAC_FILE_NATIVE       0
+#define SAC_FILE_SWAPPED      1
+#define SAC_FILE_COMPRESSED   2
+/* */
+#define SAC_STREAM_SCAN_BLOCK 4096  /* Samples of each read while scanning the stream */
+
+/*
+ * Definition of the streaming SAC reader, the samples will be read block by block
+ */
+typedef struct {
+	FILE        *fp;
+	int          swap;     /* Byte swapping is needed or the compressed container */
+	int          remain;   /* Number of samples not read yet */
+	SACZ_READER *zreader;  /* Only for the compressed container */
+} SAC_STREAM;
+
+/*
+ * Definition of the run-length gap map, each run is one span of the undefined (SACUNDEF) samples
+ */
+typedef struct {
+	int start;   /* Index of the first undefined sample */
+	int length;  /* Number of the continuous undefined samples */
+} SAC_GAP;
+
+typedef struct {
+	SAC_GAP *gaps;
+	int      count;     /* Number of the gap runs */
+	int      capacity;  /* Number of the allocated gap runs */
+	int      total;     /* Total number of the undefined samples */
+} SAC_GAP_MAP;
 
 /* */
 int sac_file_load( const char *, struct SAChead *, float ** );
+int sac_file_load_gapmap( const char *, struct SAChead *, float **, SAC_GAP_MAP * );
 struct SAChead *sac_scnl_modify( struct SAChead *, const char *, const char *, const char *, const char * );
 struct SAChead *sac_az_inc_modify( struct SAChead *, const float, const float );
-const char *sac_scnl_print( struct SAChead * );
-double sac_reftime_fetch( struct SAChead * );
+struct SAChead *sac_kevnm_modify( struct SAChead *, const char * );
+const char *sac_scnl_print( const struct SAChead * );
+void sac_code_pack( char *, const char * );
+void sac_scnl_key_pack( char *, const char *, const char *, const char *, const char * );
+void sac_scnl_key_fetch( char *, const struct SAChead * );
+double sac_reftime_fetch( const struct SAChead * );
+struct SAChead *sac_reftime_modify( struct SAChead *, const double );
+double sac_time_parse( const char * );
+int sac_header_pread( const int, struct SAChead * );
+int sac_header_pwrite( const int, const int, const struct SAChead * );
+int sac_data_pread( const int, const int, float *, const int, const int );
+int sac_file_writev( const int, const struct SAChead *, const float * );
+int sac_file_same( const char *, const char * );
 float *sac_data_preprocess( struct SAChead *, float *, const float );
+float *sac_data_preprocess_gapmap( struct SAChead *, float *, const float, const SAC_GAP_MAP * );
+int sac_gapmap_build( const float *, const int, SAC_GAP_MAP * );
+void sac_gapmap_free( SAC_GAP_MAP * );
+double sac_gapmap_report( FILE *, struct SAChead *, const SAC_GAP_MAP * );
+int sac_stream_open( const char *, struct SAChead *, SAC_STREAM * );
+int sac_stream_read( SAC_STREAM *, float *, const int );
+int sac_stream_rewind( SAC_STREAM *, const struct SAChead * );
+int sac_stream_mean_scan( SAC_STREAM *, const struct SAChead *, const float, float * );
+int sac_block_preprocess( float *, const int, const float, const float );
+void sac_stream_close( SAC_STREAM * );
@@ -0,0 +1,75 @@
+/**
+ * @file sacbundle.h
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Header file for the multi-trace event bundle related functions & data.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#pragma once
+
+/* */
+#include <stdint.h>
+#include <stddef.h>
+#include <sachead.h>
+
+/* */
+#define SACB_MAGIC       0x4c444e5542434153ULL  /* "SACBUNDL" in little-endian */
+#define SACB_VERSION     1
+#define SACB_PAGE_SIZE   4096                   /* Alignment of the sample blocks */
+#define SACB_KEY_LENGTH  (K_LEN * 4)            /* Packed station, channel, network & location */
+
+/*----------------------------------------------------------------------*
+ * Definition of the bundle file header, it is followed by the          *
+ * directory (count of entries sorted by the key), then the page        *
+ * aligned sample blocks of the traces                                  *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	uint64_t magic;
+	uint32_t version;
+	uint32_t entry_size;
+	uint32_t count;
+	uint32_t page_size;
+	uint64_t size;        /* Total size of the file */
+} SACB_FILE_HEADER;
+
+/*----------------------------------------------------------------------*
+ * Definition of one directory entry, the header is in the native byte  *
+ * order & the key is the SCNL zero padded to K_LEN of each code        *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	struct SAChead sh;
+	char           key[SACB_KEY_LENGTH];
+	uint64_t       offset;    /* Offset of the samples, page aligned */
+	uint64_t       reserved;
+} SACB_ENTRY;
+
+/*----------------------------------------------------------------------*
+ * Definition of one trace, both pointers are into the mapped bundle    *
+ * or the caller's own buffers when writing                             *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	struct SAChead *sh;
+	float          *seis;
+} SACB_TRACE;
+
+/*----------------------------------------------------------------------*
+ * Definition of the opened bundle, the mapping is private, so the      *
+ * traces can be modified in place without touching the file           *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	void       *map;
+	size_t      map_size;
+	int         count;
+	SACB_ENTRY *entries;
+	SACB_TRACE *traces;   /* In the same order of the entries */
+} SAC_BUNDLE;
+
+/* Functions prototype */
+int sacbundle_open( const char *, SAC_BUNDLE * );
+void sacbundle_close( SAC_BUNDLE * );
+const SACB_TRACE *sacbundle_find( const SAC_BUNDLE *, const char *, const char *, const char *, const char * );
+const SACB_TRACE *sacbundle_find_sac( const SAC_BUNDLE *, const struct SAChead * );
+long sacbundle_write( const char *, const SACB_TRACE *, const int );
@@ -0,0 +1,43 @@
+/**
+ * @file sacfield.h
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Header file for accessing the SAC header fields by name.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#pragma once
+
+/* */
+#include <stdint.h>
+#include <sachead.h>
+
+/* */
+#define SAC_FIELD_NAME_LENGTH   16
+#define SAC_FIELD_VALUE_LENGTH  64
+/* */
+#define SAC_FIELD_FLOAT   0
+#define SAC_FIELD_INT     1
+#define SAC_FIELD_STRING  2
+#define SAC_FIELD_TIME    3  /* Pseudo field, the absolute time (epoch sec) of the relative time field */
+
+/*----------------------------------------------------------------------*
+ * Definition of the header field, the value is at the fixed offset of  *
+ * the header                                                           *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	char     name[SAC_FIELD_NAME_LENGTH];
+	uint16_t offset;
+	uint8_t  type;
+	uint8_t  length;
+} SAC_FIELD;
+
+/* Functions prototype */
+const SAC_FIELD *sacfield_find( const char * );
+int sacfield_is_numeric( const SAC_FIELD * );
+double sacfield_number_get( const struct SAChead *, const SAC_FIELD * );
+char *sacfield_string_get( const struct SAChead *, const SAC_FIELD *, char * );
+int sacfield_value_print( const struct SAChead *, const SAC_FIELD *, char *, const int );
+int sacfield_value_set( struct SAChead *, const SAC_FIELD *, const char * );
@@ -0,0 +1,57 @@
+/**
+ * @file sacfilter.h
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Header file for the SAC header filter expression related functions & data.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#pragma once
+
+/* */
+#include <stdint.h>
+#include <sachead.h>
+#include <sacfield.h>
+
+/* */
+#define SAC_FILTER_MAX_INSNS  128
+/* Operations */
+#define SAC_FILTER_OP_CMP  0
+#define SAC_FILTER_OP_AND  1
+#define SAC_FILTER_OP_OR   2
+#define SAC_FILTER_OP_NOT  3
+/* Relations of the comparison */
+#define SAC_FILTER_REL_EQ      0
+#define SAC_FILTER_REL_NE      1
+#define SAC_FILTER_REL_LT      2
+#define SAC_FILTER_REL_LE      3
+#define SAC_FILTER_REL_GT      4
+#define SAC_FILTER_REL_GE      5
+#define SAC_FILTER_REL_MATCH   6  /* Glob pattern of the string field */
+#define SAC_FILTER_REL_NMATCH  7
+
+/*----------------------------------------------------------------------*
+ * Definition of one instruction, the expression is compiled into the   *
+ * postfix instructions which are evaluated on a small stack            *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	uint8_t          op;
+	uint8_t          rel;
+	const SAC_FIELD *field;
+	double           number;
+	char             string[SAC_FIELD_VALUE_LENGTH];
+} SAC_FILTER_INSN;
+
+/*----------------------------------------------------------------------*
+ * Definition of the compiled filter, the empty one matches all         *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	int             count;
+	SAC_FILTER_INSN insns[SAC_FILTER_MAX_INSNS];
+} SAC_FILTER;
+
+/* Functions prototype */
+int sacfilter_compile( const char *, SAC_FILTER * );
+int sacfilter_match( const SAC_FILTER *, const struct SAChead * );
@@ -0,0 +1,81 @@
+/**
+ * @file sacz.h
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Header file for the compressed SAC container (SACZ) related functions & data.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#pragma once
+
+/* */
+#include <stdint.h>
+#include <stddef.h>
+#include <sachead.h>
+
+/* */
+#define SACZ_MAGIC              0x5a434153  /* "SACZ" in little-endian */
+#define SACZ_VERSION            1
+#define SACZ_DEF_FRAME_SAMPLES  4096
+#define SACZ_BLOCK_SAMPLES      16          /* Samples share the same bit width */
+#define SACZ_FRAME_PADDING      8           /* The decoder loads 8 bytes at once */
+/* Codecs of the frame */
+#define SACZ_CODEC_RAW          0           /* The float samples as is */
+#define SACZ_CODEC_INT          1           /* Integer (quantized) samples, zig-zag of 1st/2nd order differences */
+#define SACZ_CODEC_FLOAT        2           /* XOR of the successive float bit patterns */
+/* */
+/* The encoder might overrun the raw size by one block before it falls back to the raw samples */
+#define SACZ_FRAME_MAX_SIZE(__NSAMP) \
+		(sizeof(SACZ_FRAME_HEADER) + ((__NSAMP) + SACZ_BLOCK_SAMPLES) * sizeof(float) + \
+		(__NSAMP) / SACZ_BLOCK_SAMPLES + 1 + SACZ_FRAME_PADDING)
+
+/*----------------------------------------------------------------------*
+ * Definition of the container header, it follows the SAC header. Then  *
+ * the frame index (nframes + 1 file offsets) & the frames              *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t flags;
+	uint32_t npts;
+	uint32_t frame_samples;  /* Multiple of the block samples */
+	uint32_t nframes;
+	uint32_t reserved;
+} SACZ_FILE_HEADER;
+
+/*----------------------------------------------------------------------*
+ * Definition of the frame header, it is followed by the bit widths of  *
+ * the blocks & the packed residuals, or the raw samples                *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	uint8_t  codec;
+	uint8_t  order;   /* Order of the differences for the integer codec */
+	uint16_t reserved;
+	uint32_t first;   /* The first sample, int32 or float bit pattern */
+} SACZ_FRAME_HEADER;
+
+/*----------------------------------------------------------------------*
+ * Definition of the reader, the last decoded frame is cached           *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	int       fd;
+	int       npts;
+	int       frame_samples;
+	int       nframes;
+	uint64_t *offsets;
+	uint8_t  *cbuf;     /* Compressed frame */
+	float    *frame;    /* Decoded frame */
+	int       cached;   /* Index of the decoded frame, -1 for none */
+} SACZ_READER;
+
+/* Functions prototype */
+int sacz_file_check( const int, const struct SAChead * );
+long sacz_file_write( const char *, const struct SAChead *, const float *, const int );
+int sacz_data_pread( const int, float *, const int, const int );
+int sacz_reader_open( SACZ_READER *, const int );
+int sacz_reader_read( SACZ_READER *, float *, const int, const int );
+void sacz_reader_close( SACZ_READER * );
+size_t sacz_frame_encode( const float *, const int, uint8_t * );
+int sacz_frame_decode( const uint8_t *, const size_t, const int, float * );
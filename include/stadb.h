@@ -0,0 +1,75 @@
+/**
+ * @file stadb.h
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Header file for the station metadata database related functions & data.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#pragma once
+
+/* */
+#include <stdint.h>
+#include <stddef.h>
+#include <sachead.h>
+
+/* */
+#define STADB_SNAPSHOT_MAGIC    0x4244415453434153ULL  /* "SACSTADB" in little-endian */
+#define STADB_SNAPSHOT_VERSION  1
+#define STADB_KEY_LENGTH        (K_LEN * 4)            /* Packed station, channel, network & location */
+#define STADB_MAX_LINE_LENGTH   512
+#define STADB_NUM_COMPONENTS    3
+
+/*----------------------------------------------------------------------*
+ * Definition of one channel entry, the key is the packed SCNL which    *
+ * is zero padded to K_LEN of each code. The entries are stored in the  *
+ * open addressing hash table directly, so the table can be persisted   *
+ * & mapped back as is                                                  *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	char    key[STADB_KEY_LENGTH];
+	double  latitude;
+	double  longitude;
+	double  elevation;
+	double  gain;      /* Gain factor, the same as the -g of the tools */
+	float   cmpaz;     /* Component azimuth (deg) */
+	float   cmpinc;    /* Component inclination (deg) */
+	int32_t used;
+	int32_t padding;
+} STADB_ENTRY;
+
+/*----------------------------------------------------------------------*
+ * Definition of the snapshot file header, it is followed by the whole  *
+ * hash table (capacity of entries)                                     *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	uint64_t magic;
+	uint32_t version;
+	uint32_t entry_size;
+	uint32_t capacity;
+	uint32_t count;
+} STADB_SNAPSHOT_HEADER;
+
+/*----------------------------------------------------------------------*
+ * Definition of the database, the table is either allocated from the   *
+ * station list or mapped from the snapshot                             *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	STADB_ENTRY *table;
+	uint32_t     capacity;  /* Always power of 2 */
+	uint32_t     count;
+	void        *map;       /* The mapped snapshot, NULL if it is allocated */
+	size_t       map_size;
+} STADB;
+
+/* Functions prototype */
+int stadb_open( const char *, STADB * );
+int stadb_list_load( const char *, STADB * );
+int stadb_snapshot_save( const STADB *, const char * );
+int stadb_snapshot_map( const char *, STADB * );
+void stadb_close( STADB * );
+const STADB_ENTRY *stadb_find( const STADB *, const char *, const char *, const char *, const char * );
+const STADB_ENTRY *stadb_find_sac( const STADB *, const struct SAChead * );
+struct SAChead *stadb_header_fill( struct SAChead *, const STADB_ENTRY * );
@@ -0,0 +1,194 @@
+/**
+ * @file baseline.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Main source code for the baseline correction. The least-squares polynomial comes from the
+ *        running moment sums of one pass & the small normal equations, the time axis is mapped
+ *        into [-1, 1] to keep the equations well conditioned up to the 6th order.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+/* */
+#include <baseline.h>
+
+/* */
+#define NORM_TIME(__I, __SCALE)  ((__I) * (__SCALE) - 1.0)
+
+/* */
+static int poly_fit( const float *, const int, const int, const int, double * );
+static int solve_normal_equations( double [][BASELINE_MAX_ORDER + 1], double *, const int );
+
+/**
+ * @brief Remove the least-squares polynomial of the order from the whole trace.
+ *
+ * @param data
+ * @param npts
+ * @param order
+ * @return int
+ * @returns: 0 on success
+ *          -1 on invalid arguments or singular equations
+ */
+int baseline_poly_remove( float *data, const int npts, const int order )
+{
+	double coef[BASELINE_MAX_ORDER + 1];
+	double scale;
+	double t, fit;
+
+/* */
+	if ( order < BASELINE_MIN_ORDER || order > BASELINE_MAX_ORDER || npts <= order )
+		return -1;
+	if ( poly_fit( data, 0, npts, order, coef ) )
+		return -1;
+/* Horner's method on the same normalized time */
+	scale = 2.0 / (npts - 1);
+	for ( int i = 0; i < npts; i++ ) {
+		t   = NORM_TIME(i, scale);
+		fit = coef[order];
+		for ( int k = order - 1; k >= 0; k-- )
+			fit = fit * t + coef[k];
+		data[i] -= fit;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Segmented baseline: the mean of the pre-event segment [0, pre_end) is removed from the whole
+ *        trace, then a line is fitted to the post-event segment [post_start, npts) & removed from it,
+ *        and the samples between them are corrected by the ramp from zero to the start of the line.
+ *
+ * @param data
+ * @param npts
+ * @param pre_end
+ * @param post_start
+ * @return int
+ * @returns: 0 on success
+ *          -1 on invalid arguments or singular equations
+ */
+int baseline_segment_remove( float *data, const int npts, const int pre_end, const int post_start )
+{
+	double mean = 0.0;
+	double coef[2];
+	double scale;
+	double post_fit;
+
+/* */
+	if ( pre_end <= 0 || post_start < pre_end || npts - post_start < 2 )
+		return -1;
+/* Pre-event mean */
+	for ( int i = 0; i < pre_end; i++ )
+		mean += data[i];
+	mean /= pre_end;
+	for ( int i = 0; i < npts; i++ )
+		data[i] -= mean;
+/* Post-event line, the time is normalized within the post-event segment */
+	if ( poly_fit( data, post_start, npts, 1, coef ) )
+		return -1;
+	scale = 2.0 / (npts - post_start - 1);
+	for ( int i = post_start; i < npts; i++ )
+		data[i] -= coef[0] + coef[1] * NORM_TIME(i - post_start, scale);
+/* The ramp within the event, it reaches the post-event line at post_start */
+	post_fit = coef[0] - coef[1];
+	for ( int i = pre_end; i < post_start; i++ )
+		data[i] -= post_fit * (i - pre_end) / (post_start - pre_end);
+
+	return 0;
+}
+
+/**
+ * @brief Least-squares polynomial fitting of the samples [start, end), the time of each sample is
+ *        normalized into [-1, 1] within the range. All the moment sums come from one pass.
+ *
+ * @param data
+ * @param start
+ * @param end
+ * @param order
+ * @param coef
+ * @return int
+ */
+static int poly_fit( const float *data, const int start, const int end, const int order, double *coef )
+{
+	const int    n     = end - start;
+	const double scale = 2.0 / (n - 1);
+
+	double tsum[BASELINE_MAX_ORDER * 2 + 1] = { 0.0 };
+	double matrix[BASELINE_MAX_ORDER + 1][BASELINE_MAX_ORDER + 1];
+	double power;
+	double t;
+
+/* The running moment sums, sum(t^k) for k = 0 ~ 2 * order & sum(y * t^k) for k = 0 ~ order */
+	memset(coef, 0, (order + 1) * sizeof(double));
+	for ( int i = 0; i < n; i++ ) {
+		t     = NORM_TIME(i, scale);
+		power = 1.0;
+		for ( int k = 0; k <= order; k++ ) {
+			tsum[k] += power;
+			coef[k] += data[start + i] * power;
+			power   *= t;
+		}
+		for ( int k = order + 1; k <= order * 2; k++ ) {
+			tsum[k] += power;
+			power   *= t;
+		}
+	}
+/* The normal equations is the Hankel matrix of the moment sums */
+	for ( int i = 0; i <= order; i++ )
+		for ( int j = 0; j <= order; j++ )
+			matrix[i][j] = tsum[i + j];
+
+	return solve_normal_equations( matrix, coef, order + 1 );
+}
+
+/**
+ * @brief Gaussian elimination with partial pivoting, the solution will replace the right-hand side.
+ *
+ * @param matrix
+ * @param rhs
+ * @param n
+ * @return int
+ */
+static int solve_normal_equations( double matrix[][BASELINE_MAX_ORDER + 1], double *rhs, const int n )
+{
+	int    pivot;
+	double tmp;
+
+/* */
+	for ( int col = 0; col < n; col++ ) {
+		pivot = col;
+		for ( int row = col + 1; row < n; row++ )
+			if ( fabs(matrix[row][col]) > fabs(matrix[pivot][col]) )
+				pivot = row;
+		if ( fabs(matrix[pivot][col]) < 1.0e-12 )
+			return -1;
+		if ( pivot != col ) {
+			for ( int k = col; k < n; k++ ) {
+				tmp              = matrix[col][k];
+				matrix[col][k]   = matrix[pivot][k];
+				matrix[pivot][k] = tmp;
+			}
+			tmp        = rhs[col];
+			rhs[col]   = rhs[pivot];
+			rhs[pivot] = tmp;
+		}
+	/* */
+		for ( int row = col + 1; row < n; row++ ) {
+			tmp = matrix[row][col] / matrix[col][col];
+			for ( int k = col; k < n; k++ )
+				matrix[row][k] -= tmp * matrix[col][k];
+			rhs[row] -= tmp * rhs[col];
+		}
+	}
+/* Back substitution */
+	for ( int row = n - 1; row >= 0; row-- ) {
+		for ( int k = row + 1; k < n; k++ )
+			rhs[row] -= matrix[row][k] * rhs[k];
+		rhs[row] /= matrix[row][row];
+	}
+
+	return 0;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file batch.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief A tiny job dispatcher which farms out independent jobs (files, stations...)
+ *        to a fixed number of POSIX threads.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+/* */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+/* */
+#include <batch.h>
+
+/* */
+typedef struct {
+	int            njobs;
+	int            next;
+	BATCH_JOB_FUNC func;
+	void          *arg;
+} BATCH_QUEUE;
+
+/* */
+static void *batch_worker( void * );
+
+/**
+ * @brief Return the number of online processors, it will be used as the default number of threads.
+ *
+ * @return int
+ */
+int batch_threads_default( void )
+{
+	long result = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if ( result < 1 )
+		result = 1;
+	else if ( result > BATCH_MAX_THREADS )
+		result = BATCH_MAX_THREADS;
+
+	return (int)result;
+}
+
+/**
+ * @brief Run the job function over the job index 0 ~ njobs - 1 with nthreads threads. Each
+ *        thread pulls the next index from a shared counter, so the jobs with uneven cost are
+ *        still balanced.
+ *
+ * @param njobs
+ * @param nthreads
+ * @param func
+ * @param arg
+ * @return int
+ * @returns: number of threads actually used
+ */
+int batch_jobs_run( const int njobs, const int nthreads, BATCH_JOB_FUNC func, void *arg )
+{
+	pthread_t   tids[BATCH_MAX_THREADS];
+	BATCH_QUEUE queue = { njobs, 0, func, arg };
+	int         _nthreads = nthreads;
+	int         result;
+
+/* */
+	if ( njobs <= 0 )
+		return 0;
+	if ( _nthreads < 1 )
+		_nthreads = batch_threads_default();
+	if ( _nthreads > BATCH_MAX_THREADS )
+		_nthreads = BATCH_MAX_THREADS;
+	if ( _nthreads > njobs )
+		_nthreads = njobs;
+/* Single thread, just do it in the caller */
+	if ( _nthreads == 1 ) {
+		batch_worker( &queue );
+		return 1;
+	}
+/* */
+	for ( result = 0; result < _nthreads - 1; result++ ) {
+		if ( pthread_create(&tids[result], NULL, batch_worker, &queue) ) {
+			fprintf(stderr, "ERROR! Can't create the batch thread #%d!\n", result);
+			break;
+		}
+	}
+/* The caller will also pull the remained jobs */
+	batch_worker( &queue );
+	for ( int i = 0; i < result; i++ )
+		pthread_join(tids[i], NULL);
+
+	return result + 1;
+}
+
+/**
+ * @brief
+ *
+ * @param arg
+ * @return void*
+ */
+static void *batch_worker( void *arg )
+{
+	BATCH_QUEUE *queue = (BATCH_QUEUE *)arg;
+	int          index;
+
+/* */
+	while ( (index = __atomic_fetch_add(&queue->next, 1, __ATOMIC_RELAXED)) < queue->njobs )
+		queue->func( queue->arg, index );
+
+	return NULL;
+}
@@ -0,0 +1,271 @@
+/**
+ * @file bufpool.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Main source code for the size-class buffer pool. Each request is rounded up to the power
+ *        of 2 class & the freed buffer is kept in the per-thread cache of its class, so the next
+ *        trace of the batch reuses the buffer whose pages are already faulted in. The large
+ *        buffers are mapped directly & hinted for the transparent huge pages.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sys/mman.h>
+/* */
+#include <bufpool.h>
+
+/*----------------------------------------------------------------------*
+ * Definition of the block header, it is just before the buffer & the   *
+ * size of it is the alignment, so the buffer is also aligned           *
+ *----------------------------------------------------------------------*/
+typedef struct BUFPOOL_BLOCK {
+	struct BUFPOOL_BLOCK *next;
+	size_t                size;    /* Whole size of the block, header included */
+	int                   cls;     /* Index of the class, -1 for the oversized one */
+	int                   mapped;
+} BUFPOOL_BLOCK;
+
+/* */
+typedef struct {
+	BUFPOOL_BLOCK *heads[BUFPOOL_NUM_CLASSES];
+	int            depth[BUFPOOL_NUM_CLASSES];
+	size_t         cached;
+	int            registered;
+} BUFPOOL_CACHE;
+
+/* */
+static void           init_cache_key( void );
+static void           flush_cache( void * );
+static int            size_class( const size_t );
+static BUFPOOL_BLOCK *fresh_block( const size_t, const int );
+static void           release_block( BUFPOOL_BLOCK * );
+/* */
+static __thread BUFPOOL_CACHE Cache;
+static pthread_key_t          CacheKey;
+static pthread_once_t         CacheKeyOnce = PTHREAD_ONCE_INIT;
+static BUFPOOL_STATS          Stats;
+
+/**
+ * @brief Allocate the buffer from the cache of the calling thread, or the fresh one if the cache
+ *        of the class is empty. The buffer is aligned to BUFPOOL_ALIGNMENT.
+ *
+ * @param size
+ * @return void*
+ * @returns: the buffer on success
+ *           NULL on out of memory
+ */
+void *bufpool_alloc( const size_t size )
+{
+	const int      cls   = size_class( size );
+	BUFPOOL_BLOCK *block = NULL;
+
+/* */
+	if ( cls >= 0 && (block = Cache.heads[cls]) ) {
+		Cache.heads[cls] = block->next;
+		Cache.depth[cls]--;
+		Cache.cached -= block->size;
+		__atomic_fetch_add(&Stats.pool_count, 1, __ATOMIC_RELAXED);
+		__atomic_fetch_add(&Stats.pool_bytes, size, __ATOMIC_RELAXED);
+	}
+	else {
+		if ( (block = fresh_block( size, cls )) == NULL )
+			return NULL;
+		__atomic_fetch_add(&Stats.fresh_count, 1, __ATOMIC_RELAXED);
+		__atomic_fetch_add(&Stats.fresh_bytes, size, __ATOMIC_RELAXED);
+	}
+	block->next = NULL;
+
+	return (uint8_t *)block + BUFPOOL_ALIGNMENT;
+}
+
+/**
+ * @brief Return the buffer to the cache of the calling thread, it will be released if the cache is
+ *        full. The cache will be flushed when the thread exits.
+ *
+ * @param buffer
+ */
+void bufpool_free( void *buffer )
+{
+	BUFPOOL_BLOCK *block;
+
+/* */
+	if ( buffer == NULL )
+		return;
+	block = (BUFPOOL_BLOCK *)((uint8_t *)buffer - BUFPOOL_ALIGNMENT);
+	if (
+		block->cls < 0 || Cache.depth[block->cls] >= BUFPOOL_CACHE_DEPTH ||
+		Cache.cached + block->size > BUFPOOL_CACHE_LIMIT
+	) {
+		release_block( block );
+		return;
+	}
+/* Register the cache, so the destructor will flush it at the thread exit */
+	if ( !Cache.registered ) {
+		pthread_once(&CacheKeyOnce, init_cache_key);
+		pthread_setspecific(CacheKey, &Cache);
+		Cache.registered = 1;
+	}
+	block->next             = Cache.heads[block->cls];
+	Cache.heads[block->cls] = block;
+	Cache.depth[block->cls]++;
+	Cache.cached += block->size;
+
+	return;
+}
+
+/**
+ * @brief Release all the cached buffers of the calling thread.
+ *
+ */
+void bufpool_thread_flush( void )
+{
+	flush_cache( &Cache );
+	return;
+}
+
+/**
+ * @brief
+ *
+ * @param stats
+ * @return BUFPOOL_STATS*
+ */
+BUFPOOL_STATS *bufpool_stats_get( BUFPOOL_STATS *stats )
+{
+	stats->pool_count  = __atomic_load_n(&Stats.pool_count, __ATOMIC_RELAXED);
+	stats->pool_bytes  = __atomic_load_n(&Stats.pool_bytes, __ATOMIC_RELAXED);
+	stats->fresh_count = __atomic_load_n(&Stats.fresh_count, __ATOMIC_RELAXED);
+	stats->fresh_bytes = __atomic_load_n(&Stats.fresh_bytes, __ATOMIC_RELAXED);
+
+	return stats;
+}
+
+/**
+ * @brief
+ *
+ * @param fp
+ */
+void bufpool_stats_report( FILE *fp )
+{
+	BUFPOOL_STATS stats;
+
+/* */
+	bufpool_stats_get( &stats );
+	fprintf(
+		fp, "Buffer pool: %lu bytes (%lu buffers) from the pool, %lu bytes (%lu buffers) freshly allocated!\n",
+		(unsigned long)stats.pool_bytes, (unsigned long)stats.pool_count,
+		(unsigned long)stats.fresh_bytes, (unsigned long)stats.fresh_count
+	);
+
+	return;
+}
+
+/**
+ * @brief
+ *
+ */
+static void init_cache_key( void )
+{
+	pthread_key_create(&CacheKey, flush_cache);
+	return;
+}
+
+/**
+ * @brief Release all the cached buffers, it is also the destructor of the thread specific key.
+ *
+ * @param arg
+ */
+static void flush_cache( void *arg )
+{
+	BUFPOOL_CACHE *cache = (BUFPOOL_CACHE *)arg;
+	BUFPOOL_BLOCK *block;
+
+/* */
+	for ( int i = 0; i < BUFPOOL_NUM_CLASSES; i++ ) {
+		while ( (block = cache->heads[i]) ) {
+			cache->heads[i] = block->next;
+			release_block( block );
+		}
+		cache->depth[i] = 0;
+	}
+	cache->cached = 0;
+
+	return;
+}
+
+/**
+ * @brief
+ *
+ * @param size
+ * @return int
+ * @returns: index of the class
+ *           -1 if the size is larger than the max class
+ */
+static int size_class( const size_t size )
+{
+	const size_t total = size + BUFPOOL_ALIGNMENT;
+	int          result;
+
+/* */
+	if ( total > ((size_t)1 << BUFPOOL_MAX_CLASS) || total < size )
+		return -1;
+	for ( result = BUFPOOL_MIN_CLASS; ((size_t)1 << result) < total; result++ );
+
+	return result - BUFPOOL_MIN_CLASS;
+}
+
+/**
+ * @brief
+ *
+ * @param size
+ * @param cls
+ * @return BUFPOOL_BLOCK*
+ */
+static BUFPOOL_BLOCK *fresh_block( const size_t size, const int cls )
+{
+	const size_t   total  = cls >= 0 ? (size_t)1 << (cls + BUFPOOL_MIN_CLASS) : size + BUFPOOL_ALIGNMENT;
+	BUFPOOL_BLOCK *result = NULL;
+	void          *map;
+
+/* */
+	if ( total < size )
+		return NULL;
+	if ( total >= BUFPOOL_HUGE_THRESHOLD ) {
+		if ( (map = mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) == MAP_FAILED )
+			return NULL;
+#ifdef MADV_HUGEPAGE
+		madvise(map, total, MADV_HUGEPAGE);
+#endif
+		result         = (BUFPOOL_BLOCK *)map;
+		result->mapped = 1;
+	}
+	else {
+		if ( posix_memalign((void **)&result, BUFPOOL_ALIGNMENT, total) )
+			return NULL;
+		result->mapped = 0;
+	}
+	result->size = total;
+	result->cls  = cls;
+
+	return result;
+}
+
+/**
+ * @brief
+ *
+ * @param block
+ */
+static void release_block( BUFPOOL_BLOCK *block )
+{
+	if ( block->mapped )
+		munmap(block, block->size);
+	else
+		free(block);
+
+	return;
+}
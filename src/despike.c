@@ -0,0 +1,376 @@
+/**
+ * @file despike.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Main source code for the despike stage. The running median comes from the double-heap
+ *        of O(log w) per sample, and the MAD of each centered window is selected from the
+ *        deviations of the window around its median with O(w) per sample.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+/* */
+#include <despike.h>
+
+/* */
+#define MIN_COUNT(__RM)  (((__RM)->count - 1) / 2)  /* Number of the values in the min-heap */
+#define MAX_COUNT(__RM)  ((__RM)->count / 2)        /* Number of the values in the max-heap */
+
+/* */
+static int  check_window_center( float *, const float *, const int, const int, const int, const int, const float *, const double, float * );
+static float select_median( float *, const int );
+static int  heap_less( const RUN_MEDIAN *, const int, const int );
+static int  heap_cmp_exchange( RUN_MEDIAN *, const int, const int );
+static void min_sort_down( RUN_MEDIAN *, int );
+static void max_sort_down( RUN_MEDIAN *, int );
+static int  min_sort_up( RUN_MEDIAN *, int );
+static int  max_sort_up( RUN_MEDIAN *, int );
+
+/**
+ * @brief
+ *
+ * @param rm
+ * @param window
+ * @return int
+ * @returns: 0 on success
+ *          -2 on out of memory
+ */
+int despike_run_median_init( RUN_MEDIAN *rm, const int window )
+{
+	memset(rm, 0, sizeof(RUN_MEDIAN));
+	rm->data = (float *)calloc(window, sizeof(float));
+	rm->pos  = (int *)calloc(window, sizeof(int));
+	rm->heap = (int *)calloc(window, sizeof(int));
+	if ( !rm->data || !rm->pos || !rm->heap ) {
+		despike_run_median_free( rm );
+		return -2;
+	}
+/* Center the heap, then spread the initial positions alternately to both sides */
+	rm->heap  += window / 2;
+	rm->window = window;
+	for ( int i = window - 1; i >= 0; i-- ) {
+		rm->pos[i]           = ((i + 1) / 2) * ((i & 1) ? -1 : 1);
+		rm->heap[rm->pos[i]] = i;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Push the new value into the window, the oldest value will be dropped when the window is full.
+ *
+ * @param rm
+ * @param value
+ * @return float the median of the values within window
+ */
+float despike_run_median_push( RUN_MEDIAN *rm, const float value )
+{
+	const int   is_new = rm->count < rm->window;
+	const float old    = rm->data[rm->idx];
+	int         p      = rm->pos[rm->idx];
+
+/* */
+	rm->data[rm->idx] = value;
+	if ( ++rm->idx == rm->window )
+		rm->idx = 0;
+	rm->count += is_new;
+/* The new value replaces the old one at the same heap position, then restore both heaps */
+	if ( p > 0 ) {
+		if ( !is_new && old < value )
+			min_sort_down( rm, p * 2 );
+		else if ( min_sort_up( rm, p ) )
+			max_sort_down( rm, -1 );
+	}
+	else if ( p < 0 ) {
+		if ( !is_new && value < old )
+			max_sort_down( rm, p * 2 );
+		else if ( max_sort_up( rm, p ) && rm->count > 1 )
+			min_sort_down( rm, 1 );
+	}
+	else {
+		if ( MAX_COUNT(rm) )
+			max_sort_down( rm, -1 );
+		if ( MIN_COUNT(rm) )
+			min_sort_down( rm, 1 );
+	}
+
+	return (rm->count & 1) ? rm->data[rm->heap[0]] : (rm->data[rm->heap[0]] + rm->data[rm->heap[-1]]) * 0.5f;
+}
+
+/**
+ * @brief
+ *
+ * @param rm
+ */
+void despike_run_median_free( RUN_MEDIAN *rm )
+{
+	if ( rm->heap )
+		free(rm->heap - rm->window / 2);
+	free(rm->data);
+	free(rm->pos);
+	memset(rm, 0, sizeof(RUN_MEDIAN));
+
+	return;
+}
+
+/**
+ * @brief Flag the samples which are far from the median of the centered window in the unit of the
+ *        scaled MAD of the window, and replace them with the median. The decision of each sample
+ *        is delayed by half window, until the whole centered window is within the circular buffer
+ *        of the running median. The samples near both edges are decided one by one against their
+ *        own truncated windows. The input should be gap filled.
+ *
+ * @param seis
+ * @param npts
+ * @param window window length in samples, it will be forced to be odd
+ * @param factor
+ * @return int
+ * @returns: number of the replaced spikes on success
+ *          -1 on invalid arguments
+ *          -2 on out of memory
+ */
+int despike_process( float *seis, const int npts, const int window, const double factor )
+{
+	const int w    = window | 1;
+	const int half = w / 2;
+
+	RUN_MEDIAN rm;
+	float     *scratch;
+	float      median;
+	int        center;
+	int        result = 0;
+
+/* */
+	if ( w < DESPIKE_MIN_WINDOW || npts < w * 2 )
+		return -1;
+	if ( (scratch = (float *)malloc(w * sizeof(float))) == NULL )
+		return -2;
+	if ( despike_run_median_init( &rm, w ) ) {
+		free(scratch);
+		return -2;
+	}
+/* The original values of the window are kept in the circular buffer, the index is i % w */
+	for ( int i = 0; i < npts; i++ ) {
+		median = despike_run_median_push( &rm, seis[i] );
+		if ( i < w - 1 )
+			continue;
+	/* The head before the first whole centered window */
+		if ( i == w - 1 ) {
+			for ( center = 0; center < half; center++ )
+				result += check_window_center( seis, rm.data, w, center, 0, center + half, NULL, factor, scratch );
+		}
+		center  = i - half;
+		result += check_window_center( seis, rm.data, w, center, center - half, i, &median, factor, scratch );
+	}
+/* The tail after the last whole centered window */
+	for ( center = npts - half; center < npts; center++ )
+		result += check_window_center( seis, rm.data, w, center, center - half, npts - 1, NULL, factor, scratch );
+/* */
+	despike_run_median_free( &rm );
+	free(scratch);
+
+	return result;
+}
+
+/**
+ * @brief Check the center sample against the MAD of its window [from, to] around the median, the
+ *        original values are taken from the circular buffer, so the replaced samples won't affect
+ *        the following windows.
+ *
+ * @param seis
+ * @param data the circular buffer of the original values, the index is i % w
+ * @param w
+ * @param center
+ * @param from
+ * @param to
+ * @param median the median of the window, or NULL to select it within the window
+ * @param factor
+ * @param scratch the work space of w samples
+ * @return int
+ * @returns: 1 if the center sample is replaced
+ *           0 if not
+ */
+static int check_window_center(
+	float *seis, const float *data, const int w, const int center, const int from, const int to,
+	const float *median, const double factor, float *scratch
+) {
+	const int count = to - from + 1;
+	float     _median;
+	float     mad;
+
+/* */
+	if ( median ) {
+		_median = *median;
+	}
+	else {
+		for ( int i = 0; i < count; i++ )
+			scratch[i] = data[(from + i) % w];
+		_median = select_median( scratch, count );
+	}
+/* Second pass over the window, the deviations from the median of this window */
+	for ( int i = 0; i < count; i++ )
+		scratch[i] = fabsf(data[(from + i) % w] - _median);
+	mad = select_median( scratch, count ) * factor * DESPIKE_MAD_SCALE;
+	if ( mad > 0.0f && fabsf(data[center % w] - _median) > mad ) {
+		seis[center] = _median;
+		return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Select the median of the values by the quickselect, the values will be reordered. The
+ *        median of the even count is the mean of the two middle values, like the running median.
+ *
+ * @param values
+ * @param count
+ * @return float
+ */
+static float select_median( float *values, const int count )
+{
+	const int k = count / 2;
+
+	float pivot, tmp;
+	float lower;
+	int   left  = 0;
+	int   right = count - 1;
+	int   i, j;
+
+/* Hoare's selection of the k-th smallest value */
+	while ( left < right ) {
+		pivot = values[(left + right) / 2];
+		for ( i = left, j = right; i <= j; ) {
+			while ( values[i] < pivot )
+				i++;
+			while ( pivot < values[j] )
+				j--;
+			if ( i <= j ) {
+				tmp       = values[i];
+				values[i] = values[j];
+				values[j] = tmp;
+				i++;
+				j--;
+			}
+		}
+		if ( j < k )
+			left = i;
+		if ( k < i )
+			right = j;
+	}
+	if ( count & 1 )
+		return values[k];
+/* The largest value below the k-th one is the other middle value */
+	lower = values[0];
+	for ( i = 1; i < k; i++ )
+		lower = values[i] > lower ? values[i] : lower;
+
+	return (values[k] + lower) * 0.5f;
+}
+
+/**
+ * @brief
+ *
+ * @param rm
+ * @param i
+ * @param j
+ * @return int
+ */
+static int heap_less( const RUN_MEDIAN *rm, const int i, const int j )
+{
+	return rm->data[rm->heap[i]] < rm->data[rm->heap[j]];
+}
+
+/**
+ * @brief Exchange the two heap nodes if the first one is less than the second one.
+ *
+ * @param rm
+ * @param i
+ * @param j
+ * @return int
+ */
+static int heap_cmp_exchange( RUN_MEDIAN *rm, const int i, const int j )
+{
+	int tmp;
+
+/* */
+	if ( !heap_less( rm, i, j ) )
+		return 0;
+	tmp                  = rm->heap[i];
+	rm->heap[i]          = rm->heap[j];
+	rm->heap[j]          = tmp;
+	rm->pos[rm->heap[i]] = i;
+	rm->pos[rm->heap[j]] = j;
+
+	return 1;
+}
+
+/**
+ * @brief
+ *
+ * @param rm
+ * @param i
+ */
+static void min_sort_down( RUN_MEDIAN *rm, int i )
+{
+	for ( ; i <= MIN_COUNT(rm); i *= 2 ) {
+		if ( i > 1 && i < MIN_COUNT(rm) && heap_less( rm, i + 1, i ) )
+			i++;
+		if ( !heap_cmp_exchange( rm, i, i / 2 ) )
+			break;
+	}
+
+	return;
+}
+
+/**
+ * @brief
+ *
+ * @param rm
+ * @param i
+ */
+static void max_sort_down( RUN_MEDIAN *rm, int i )
+{
+	for ( ; i >= -MAX_COUNT(rm); i *= 2 ) {
+		if ( i < -1 && i > -MAX_COUNT(rm) && heap_less( rm, i, i - 1 ) )
+			i--;
+		if ( !heap_cmp_exchange( rm, i / 2, i ) )
+			break;
+	}
+
+	return;
+}
+
+/**
+ * @brief
+ *
+ * @param rm
+ * @param i
+ * @return int 1 if the node reaches the median
+ */
+static int min_sort_up( RUN_MEDIAN *rm, int i )
+{
+	while ( i > 0 && heap_cmp_exchange( rm, i, i / 2 ) )
+		i /= 2;
+
+	return i == 0;
+}
+
+/**
+ * @brief
+ *
+ * @param rm
+ * @param i
+ * @return int 1 if the node reaches the median
+ */
+static int max_sort_up( RUN_MEDIAN *rm, int i )
+{
+	while ( i < 0 && heap_cmp_exchange( rm, i / 2, i ) )
+		i /= 2;
+
+	return i == 0;
+}
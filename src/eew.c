@@ -0,0 +1,106 @@
+/**
+ * @file eew.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Main source code for the earthquake early warning parameters. The acceleration is
+ *        integrated & high pass filtered causally twice (the same recurrence as sac_int), and
+ *        the time-growing Tau-c & Pd are reported at every sample of one pass.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+/* */
+#include <eew.h>
+#include <iirfilter.h>
+
+/**
+ * @brief Number of the reported windows (EEW_WINDOW_MIN_SEC ~ EEW_WINDOW_MAX_SEC after P arrival)
+ *        for the sampling interval.
+ *
+ * @param delta
+ * @return int
+ */
+int eew_window_count( const double delta )
+{
+	return (int)(EEW_WINDOW_MAX_SEC / delta + 0.5) - (int)(EEW_WINDOW_MIN_SEC / delta + 0.5) + 1;
+}
+
+/**
+ * @brief Calculate the Tau-c, Pd, Pv & Pa at every sample from EEW_WINDOW_MIN_SEC to EEW_WINDOW_MAX_SEC
+ *        after the P arrival (e.g. from pickwu_p_arrival_pick()). The input acceleration should be
+ *        gap filled & demeaned, and the stream starts from the first sample to warm up the filters.
+ *
+ * @param acc
+ * @param npts
+ * @param delta
+ * @param p_arrival
+ * @param output
+ * @param max_output
+ * @return int
+ * @returns: number of the output windows, it might be less than eew_window_count() when the trace is short
+ *          -1 on invalid arguments
+ */
+int eew_tauc_pd_calc(
+	const float *acc, const int npts, const double delta, const int p_arrival, EEW_PARAM *output, const int max_output
+) {
+	const int    pos_min    = p_arrival + (int)(EEW_WINDOW_MIN_SEC / delta + 0.5);
+	const int    pos_max    = p_arrival + (int)(EEW_WINDOW_MAX_SEC / delta + 0.5);
+	const double half_delta = delta * 0.5;
+
+	IIR_FILTER filter;
+	IIR_STAGE  stage_vel[MAX_NUM_SECTIONS];
+	IIR_STAGE  stage_dis[MAX_NUM_SECTIONS];
+	double     last_acc = 0.0, last_vel = 0.0, last_dis = 0.0;
+	double     last_vel_proc = 0.0;
+	double     vel, dis, tmp;
+	double     sum_dis2 = 0.0, sum_vel2 = 0.0;
+	double     pd = 0.0, pv = 0.0, pa = 0.0;
+	int        result = 0;
+
+/* */
+	if ( p_arrival <= 0 || p_arrival >= npts || delta <= 0.0 || max_output < 1 )
+		return -1;
+/* Causal high pass filter, the same as the one used by sac_int */
+	filter = iirfilter_design( EEW_HP_ORDER, IIR_HIGHPASS_FILTER, IIR_BUTTERWORTH, EEW_HP_CORNER_FREQ, 0.0, delta );
+	memset(stage_vel, 0, sizeof(stage_vel));
+	memset(stage_dis, 0, sizeof(stage_dis));
+/* The one pass stream */
+	for ( int i = 0; i < npts && i <= pos_max && result < max_output; i++ ) {
+	/* Acceleration to velocity */
+		vel      = (acc[i] + last_acc) * half_delta + last_vel;
+		last_acc = acc[i];
+		last_vel = vel;
+		vel      = iirfilter_apply( vel, &filter, stage_vel );
+	/* Velocity to displacement */
+		dis           = (vel + last_vel_proc) * half_delta + last_dis;
+		last_vel_proc = vel;
+		last_dis      = dis;
+		dis           = iirfilter_apply( dis, &filter, stage_dis );
+	/* Accumulate after P arrival */
+		if ( i < p_arrival )
+			continue;
+		sum_dis2 += dis * dis;
+		sum_vel2 += vel * vel;
+		if ( (tmp = fabs(dis)) > pd )
+			pd = tmp;
+		if ( (tmp = fabs(vel)) > pv )
+			pv = tmp;
+		if ( (tmp = fabs(acc[i])) > pa )
+			pa = tmp;
+	/* Report at every sample within the window */
+		if ( i >= pos_min ) {
+			output[result].window = (i - p_arrival) * delta;
+			output[result].tauc   = sum_vel2 > 0.0 ? 2.0 * M_PI * sqrt(sum_dis2 / sum_vel2) : 0.0;
+			output[result].pd     = pd;
+			output[result].pv     = pv;
+			output[result].pa     = pa;
+			result++;
+		}
+	}
+
+	return result;
+}
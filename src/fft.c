@@ -0,0 +1,501 @@
+/**
+ * @file fft.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Main source code for the mixed radix (2, 3, 4, 5 & generic) FFT. The real sequence
+ *        with even length is packed into a half-length complex sequence, and the plans are
+ *        cached by length.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <complex.h>
+#include <math.h>
+#include <pthread.h>
+/* */
+#include <fft.h>
+
+/* */
+#define FFT_GENERIC_STACK_RADIX  64
+
+/* */
+static FFT_PLAN *plan_create( const int );
+static int  factorize( int, int * );
+static void cfft_work(
+	double _Complex *, const double _Complex *, const int, const int *, const double _Complex *, const int
+);
+static void bfly2( double _Complex *, const int, const double _Complex *, const int );
+static void bfly3( double _Complex *, const int, const double _Complex *, const int );
+static void bfly4( double _Complex *, const int, const double _Complex *, const int );
+static void bfly5( double _Complex *, const int, const double _Complex *, const int );
+static void bfly_generic( double _Complex *, const int, const double _Complex *, const int, const int, const int );
+/* */
+static FFT_PLAN       *PlanCache = NULL;
+static pthread_mutex_t PlanMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Fetch the plan of the real sequence length from the cache, the plan will be designed
+ *        and inserted into the cache at the first time.
+ *
+ * @param n
+ * @return const FFT_PLAN*
+ */
+const FFT_PLAN *fft_plan_get( const int n )
+{
+	FFT_PLAN *result;
+
+/* */
+	if ( n < 1 )
+		return NULL;
+/* */
+	pthread_mutex_lock(&PlanMutex);
+	for ( result = PlanCache; result; result = result->next )
+		if ( result->n == n )
+			break;
+	if ( !result && (result = plan_create( n )) ) {
+		result->next = PlanCache;
+		PlanCache    = result;
+	}
+	pthread_mutex_unlock(&PlanMutex);
+
+	return result;
+}
+
+/**
+ * @brief Free all the cached plans, the plans fetched before should not be used anymore.
+ *
+ */
+void fft_plan_cache_free( void )
+{
+	FFT_PLAN *next;
+
+/* */
+	pthread_mutex_lock(&PlanMutex);
+	for ( ; PlanCache; PlanCache = next ) {
+		next = PlanCache->next;
+		free(PlanCache->twiddles);
+		free(PlanCache->super_twiddles);
+		free(PlanCache);
+	}
+	pthread_mutex_unlock(&PlanMutex);
+
+	return;
+}
+
+/**
+ * @brief Return the smallest length which is larger or equal to n & only has the factors 2, 3 & 5.
+ *
+ * @param n
+ * @return int
+ */
+int fft_size_good( const int n )
+{
+	int result = n > 1 ? n : 1;
+	int tmp;
+
+/* */
+	while ( 1 ) {
+		tmp = result;
+		while ( (tmp % 2) == 0 ) tmp /= 2;
+		while ( (tmp % 3) == 0 ) tmp /= 3;
+		while ( (tmp % 5) == 0 ) tmp /= 5;
+		if ( tmp <= 1 )
+			break;
+		result++;
+	}
+
+	return result;
+}
+
+/**
+ * @brief Forward transform of the real sequence, only the non-negative frequency part
+ *        (n / 2 + 1 complex values) will be output without any scaling.
+ *
+ * @param plan
+ * @param input
+ * @param output
+ * @return int
+ * @returns: 0 on success
+ *          -1 on out of memory
+ */
+int fft_real_forward( const FFT_PLAN *plan, const double *input, double _Complex *output )
+{
+	const int       ncpx = plan->ncpx;
+	double _Complex fk, fnk, f1k, f2k;
+	double _Complex *tmp;
+
+/* Odd length, just do the full complex transform */
+	if ( plan->n & 1 ) {
+		if ( (tmp = (double _Complex *)malloc(sizeof(double _Complex) * ncpx * 2)) == NULL )
+			return -1;
+		for ( int i = 0; i < ncpx; i++ )
+			tmp[i] = input[i];
+		cfft_work( tmp + ncpx, tmp, 1, plan->factors, plan->twiddles, ncpx );
+		memcpy(output, tmp + ncpx, sizeof(double _Complex) * (ncpx / 2 + 1));
+		free(tmp);
+		return 0;
+	}
+/* Even length, the real sequence is treated as the complex sequence with half length */
+	cfft_work( output, (const double _Complex *)input, 1, plan->factors, plan->twiddles, ncpx );
+/* Then split the packed result */
+	fk = output[0];
+	output[0]    = creal(fk) + cimag(fk);
+	output[ncpx] = creal(fk) - cimag(fk);
+	for ( int k = 1; k <= ncpx / 2; k++ ) {
+		fk  = output[k];
+		fnk = conj(output[ncpx - k]);
+		f1k = fk + fnk;
+		f2k = (fk - fnk) * plan->super_twiddles[k - 1];
+		output[k]        = 0.5 * (f1k + f2k);
+		output[ncpx - k] = 0.5 * conj(f1k - f2k);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Inverse transform to the real sequence from the non-negative frequency part, the
+ *        result is scaled by 1 / n, so the forward & inverse transforms are the identity.
+ *
+ * @param plan
+ * @param input
+ * @param output
+ * @return int
+ * @returns: 0 on success
+ *          -1 on out of memory
+ */
+int fft_real_inverse( const FFT_PLAN *plan, const double _Complex *input, double *output )
+{
+	const int        ncpx = plan->ncpx;
+	double _Complex  fk, fnk, fek, fok;
+	double _Complex *tmp;
+
+/* */
+	if ( (tmp = (double _Complex *)malloc(sizeof(double _Complex) * ncpx * 2)) == NULL )
+		return -1;
+/* Odd length, rebuild the hermitian spectrum & do the full complex transform */
+	if ( plan->n & 1 ) {
+		for ( int k = 0; k <= ncpx / 2; k++ )
+			tmp[k] = conj(input[k]);
+		for ( int k = ncpx / 2 + 1; k < ncpx; k++ )
+			tmp[k] = input[ncpx - k];
+		cfft_work( tmp + ncpx, tmp, 1, plan->factors, plan->twiddles, ncpx );
+		for ( int i = 0; i < ncpx; i++ )
+			output[i] = creal(tmp[ncpx + i]) / ncpx;
+		free(tmp);
+		return 0;
+	}
+/* Even length, merge into the packed spectrum (conjugated for the inverse) */
+	tmp[0] = conj((creal(input[0]) + creal(input[ncpx])) + (creal(input[0]) - creal(input[ncpx])) * _Complex_I);
+	for ( int k = 1; k <= ncpx / 2; k++ ) {
+		fk  = input[k];
+		fnk = conj(input[ncpx - k]);
+		fek = fk + fnk;
+		fok = (fk - fnk) * conj(plan->super_twiddles[k - 1]);
+		tmp[k]        = conj(fek + fok);
+		tmp[ncpx - k] = fek - fok;
+	}
+	cfft_work( tmp + ncpx, tmp, 1, plan->factors, plan->twiddles, ncpx );
+/* Unpack & scale */
+	for ( int i = 0; i < ncpx; i++ ) {
+		output[i * 2]     = creal(tmp[ncpx + i]) / plan->n;
+		output[i * 2 + 1] = -cimag(tmp[ncpx + i]) / plan->n;
+	}
+	free(tmp);
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ * @param n
+ * @return FFT_PLAN*
+ */
+static FFT_PLAN *plan_create( const int n )
+{
+	FFT_PLAN *result;
+	double    phase;
+
+/* */
+	if ( (result = (FFT_PLAN *)calloc(1, sizeof(FFT_PLAN))) == NULL )
+		return NULL;
+	result->n    = n;
+	result->ncpx = (n & 1) ? n : n / 2;
+	if ( factorize( result->ncpx, result->factors ) < 0 )
+		goto error_return;
+/* */
+	if ( (result->twiddles = (double _Complex *)malloc(sizeof(double _Complex) * result->ncpx)) == NULL )
+		goto error_return;
+	for ( int i = 0; i < result->ncpx; i++ ) {
+		phase = -2.0 * M_PI * i / result->ncpx;
+		result->twiddles[i] = cos(phase) + sin(phase) * _Complex_I;
+	}
+/* The super twiddles are -i * exp(-2 * pi * i * k / n) */
+	if ( !(n & 1) ) {
+		if ( (result->super_twiddles = (double _Complex *)malloc(sizeof(double _Complex) * (result->ncpx / 2 + 1))) == NULL )
+			goto error_return;
+		for ( int i = 0; i < result->ncpx / 2 + 1; i++ ) {
+			phase = -M_PI * ((double)(i + 1) / result->ncpx + 0.5);
+			result->super_twiddles[i] = cos(phase) + sin(phase) * _Complex_I;
+		}
+	}
+
+	return result;
+
+error_return:
+	free(result->twiddles);
+	free(result);
+	return NULL;
+}
+
+/**
+ * @brief Factorize the length into the (radix, remained length) pairs, radix 4 first.
+ *
+ * @param n
+ * @param factors
+ * @return int
+ */
+static int factorize( int n, int *factors )
+{
+	int p = 4;
+	int i = 0;
+
+/* */
+	do {
+		while ( n % p ) {
+			switch ( p ) {
+			case 4: p = 2; break;
+			case 2: p = 3; break;
+			default: p += 2; break;
+			}
+			if ( p * p > n )
+				p = n;
+		}
+		if ( i >= FFT_MAX_FACTORS )
+			return -1;
+		n /= p;
+		factors[i * 2]     = p;
+		factors[i * 2 + 1] = n;
+		i++;
+	} while ( n > 1 );
+
+	return i;
+}
+
+/**
+ * @brief The recursive decimation in time complex transform.
+ *
+ * @param output
+ * @param input
+ * @param fstride
+ * @param factors
+ * @param twiddles
+ * @param ncpx
+ */
+static void cfft_work(
+	double _Complex *output, const double _Complex *input, const int fstride, const int *factors,
+	const double _Complex *twiddles, const int ncpx
+) {
+	double _Complex      *out_beg = output;
+	const int             p       = *factors++;
+	const int             m       = *factors++;
+	const double _Complex *out_end = output + p * m;
+
+/* */
+	if ( m == 1 ) {
+		do {
+			*output = *input;
+			input  += fstride;
+		} while ( ++output != out_end );
+	}
+	else {
+		do {
+			cfft_work( output, input, fstride * p, factors, twiddles, ncpx );
+			input += fstride;
+		} while ( (output += m) != out_end );
+	}
+/* */
+	output = out_beg;
+	switch ( p ) {
+	case 2: bfly2( output, fstride, twiddles, m ); break;
+	case 3: bfly3( output, fstride, twiddles, m ); break;
+	case 4: bfly4( output, fstride, twiddles, m ); break;
+	case 5: bfly5( output, fstride, twiddles, m ); break;
+	default: bfly_generic( output, fstride, twiddles, m, p, ncpx ); break;
+	}
+
+	return;
+}
+
+/**
+ * @brief
+ *
+ * @param out
+ * @param fstride
+ * @param tw
+ * @param m
+ */
+static void bfly2( double _Complex *out, const int fstride, const double _Complex *tw, const int m )
+{
+	double _Complex *out2 = out + m;
+	double _Complex  t;
+
+/* */
+	for ( int k = 0; k < m; k++ ) {
+		t       = out2[k] * tw[k * fstride];
+		out2[k] = out[k] - t;
+		out[k] += t;
+	}
+
+	return;
+}
+
+/**
+ * @brief
+ *
+ * @param out
+ * @param fstride
+ * @param tw
+ * @param m
+ */
+static void bfly3( double _Complex *out, const int fstride, const double _Complex *tw, const int m )
+{
+	const double    epi3 = cimag(tw[fstride * m]);
+	double _Complex s0, s1, s2, s3;
+
+/* */
+	for ( int k = 0; k < m; k++ ) {
+		s1 = out[k + m] * tw[k * fstride];
+		s2 = out[k + 2 * m] * tw[k * fstride * 2];
+		s3 = s1 + s2;
+		s0 = s1 - s2;
+		out[k + m] = out[k] - 0.5 * s3;
+		s0 *= epi3;
+		out[k] += s3;
+		out[k + 2 * m] = out[k + m] + cimag(s0) - creal(s0) * _Complex_I;
+		out[k + m]     = out[k + m] - cimag(s0) + creal(s0) * _Complex_I;
+	}
+
+	return;
+}
+
+/**
+ * @brief
+ *
+ * @param out
+ * @param fstride
+ * @param tw
+ * @param m
+ */
+static void bfly4( double _Complex *out, const int fstride, const double _Complex *tw, const int m )
+{
+	double _Complex s0, s1, s2, s3, s4, s5;
+
+/* */
+	for ( int k = 0; k < m; k++ ) {
+		s0 = out[k + m] * tw[k * fstride];
+		s1 = out[k + 2 * m] * tw[k * fstride * 2];
+		s2 = out[k + 3 * m] * tw[k * fstride * 3];
+		s5 = out[k] - s1;
+		out[k] += s1;
+		s3 = s0 + s2;
+		s4 = s0 - s2;
+		out[k + 2 * m] = out[k] - s3;
+		out[k] += s3;
+	/* Forward transform, multiply by -i */
+		out[k + m]     = s5 + cimag(s4) - creal(s4) * _Complex_I;
+		out[k + 3 * m] = s5 - cimag(s4) + creal(s4) * _Complex_I;
+	}
+
+	return;
+}
+
+/**
+ * @brief
+ *
+ * @param out
+ * @param fstride
+ * @param tw
+ * @param m
+ */
+static void bfly5( double _Complex *out, const int fstride, const double _Complex *tw, const int m )
+{
+	const double _Complex ya = tw[fstride * m];
+	const double _Complex yb = tw[fstride * 2 * m];
+	double _Complex s[13];
+
+/* */
+	for ( int u = 0; u < m; u++ ) {
+		s[0] = out[u];
+		s[1] = out[u + m] * tw[u * fstride];
+		s[2] = out[u + 2 * m] * tw[2 * u * fstride];
+		s[3] = out[u + 3 * m] * tw[3 * u * fstride];
+		s[4] = out[u + 4 * m] * tw[4 * u * fstride];
+
+		s[7]  = s[1] + s[4];
+		s[10] = s[1] - s[4];
+		s[8]  = s[2] + s[3];
+		s[9]  = s[2] - s[3];
+
+		out[u] = s[0] + s[7] + s[8];
+
+		s[5]  = s[0] + creal(ya) * s[7] + creal(yb) * s[8];
+		s[6]  = (cimag(ya) * cimag(s[10]) + cimag(yb) * cimag(s[9])) -
+			(cimag(ya) * creal(s[10]) + cimag(yb) * creal(s[9])) * _Complex_I;
+		out[u + m]     = s[5] - s[6];
+		out[u + 4 * m] = s[5] + s[6];
+
+		s[11] = s[0] + creal(yb) * s[7] + creal(ya) * s[8];
+		s[12] = (cimag(ya) * cimag(s[9]) - cimag(yb) * cimag(s[10])) +
+			(cimag(yb) * creal(s[10]) - cimag(ya) * creal(s[9])) * _Complex_I;
+		out[u + 2 * m] = s[11] + s[12];
+		out[u + 3 * m] = s[11] - s[12];
+	}
+
+	return;
+}
+
+/**
+ * @brief
+ *
+ * @param out
+ * @param fstride
+ * @param tw
+ * @param m
+ * @param p
+ * @param ncpx
+ */
+static void bfly_generic(
+	double _Complex *out, const int fstride, const double _Complex *tw, const int m, const int p, const int ncpx
+) {
+	double _Complex  stack[FFT_GENERIC_STACK_RADIX];
+	double _Complex *scratch = p > FFT_GENERIC_STACK_RADIX ? (double _Complex *)malloc(sizeof(double _Complex) * p) : stack;
+	int              twidx;
+
+/* */
+	if ( scratch == NULL )
+		return;
+	for ( int u = 0; u < m; u++ ) {
+		for ( int q1 = 0, k = u; q1 < p; q1++, k += m )
+			scratch[q1] = out[k];
+		for ( int q1 = 0, k = u; q1 < p; q1++, k += m ) {
+			twidx  = 0;
+			out[k] = scratch[0];
+			for ( int q = 1; q < p; q++ ) {
+				twidx += fstride * k;
+				if ( twidx >= ncpx )
+					twidx -= ncpx;
+				out[k] += scratch[q] * tw[twidx];
+			}
+		}
+	}
+/* */
+	if ( scratch != stack )
+		free(scratch);
+
+	return;
+}
@@ -0,0 +1,302 @@
+/**
+ * @file gather.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Main source code for the event gather. The headers of all the input files are read in
+ *        parallel first, so the common time window & the layout of the arena are known before any
+ *        sample is loaded, then each trace is read by the threads directly into its own aligned
+ *        slot of the arena, no intermediate buffer is needed.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+/* */
+#include <sachead.h>
+#include <sac.h>
+#include <gather.h>
+#include <batch.h>
+
+/* */
+#define GATHER_ALIGN_SAMPLES  (GATHER_ALIGNMENT / (int)sizeof(float))
+#define GATHER_DELTA_EPSILON  1.0e-6   /* Relative tolerance of the sampling interval */
+/* */
+typedef struct {
+	const char    *path;
+	struct SAChead sh;
+	int            swap;
+	int            comp;
+	int            first;     /* Index of the first sample within the common window */
+	int            nsamp;     /* Number of samples within the common window */
+	float         *dest;
+	int            result;
+	char           sta[K_LEN + 1];
+	char           net[K_LEN + 1];
+	char           loc[K_LEN + 1];
+} GATHER_TRACE;
+
+/* */
+static void header_job_func( void *, const int );
+static void data_job_func( void *, const int );
+static int  compare_trace( const void *, const void * );
+static int  component_index( const char * );
+
+/**
+ * @brief Load the three components traces of all the stations into the gather, the traces are cut
+ *        to the common time window by the nearest sample & grouped by the station.
+ *
+ * @param files
+ * @param nfiles
+ * @param nthreads
+ * @param gather
+ * @return int
+ * @returns: number of the stations on success
+ *          -1 on error reading file or the traces can't be gathered
+ *          -2 on out of memory
+ */
+int gather_load( char * const *files, const int nfiles, const int nthreads, SAC_GATHER *gather )
+{
+	GATHER_TRACE *traces = NULL;
+	GATHER_TRACE *trace;
+	double        start, end, tstart;
+	int           station;
+	int           result = -1;
+
+/* */
+	memset(gather, 0, sizeof(SAC_GATHER));
+	if ( nfiles <= 0 )
+		return -1;
+	if ( (traces = (GATHER_TRACE *)calloc(nfiles, sizeof(GATHER_TRACE))) == NULL ) {
+		fprintf(stderr, "ERROR! Out of memory for %d traces\n", nfiles);
+		return -2;
+	}
+	for ( int i = 0; i < nfiles; i++ )
+		traces[i].path = files[i];
+/* Only the headers at first */
+	batch_jobs_run( nfiles, nthreads, header_job_func, traces );
+	for ( int i = 0; i < nfiles; i++ )
+		if ( traces[i].result )
+			goto end_process;
+	qsort(traces, nfiles, sizeof(GATHER_TRACE), compare_trace);
+/* The common sampling & time window */
+	gather->delta = traces[0].sh.delta;
+	start         = -HUGE_VAL;
+	end           = HUGE_VAL;
+	for ( int i = 0; i < nfiles; i++ ) {
+		trace = traces + i;
+		if ( fabs(trace->sh.delta - gather->delta) > GATHER_DELTA_EPSILON * gather->delta ) {
+			fprintf(stderr, "The sampling interval of %s is different from the others!\n", trace->path);
+			goto end_process;
+		}
+		if ( i && !compare_trace( trace - 1, trace ) ) {
+			fprintf(stderr, "SAC files: %s & %s are the same component!\n", (trace - 1)->path, trace->path);
+			goto end_process;
+		}
+		if ( !i || compare_trace( trace - 1, trace ) / 2 )
+			gather->nstations++;
+		tstart = sac_reftime_fetch( &trace->sh ) + trace->sh.b;
+		start  = tstart > start ? tstart : start;
+		end    = tstart + (trace->sh.npts - 1) * gather->delta < end ? tstart + (trace->sh.npts - 1) * gather->delta : end;
+	}
+	gather->starttime = start;
+	gather->npts      = (int)floor((end - start) / gather->delta + 0.5) + 1;
+	for ( int i = 0; i < nfiles; i++ ) {
+		trace        = traces + i;
+		trace->first = (int)floor((start - sac_reftime_fetch( &trace->sh ) - trace->sh.b) / gather->delta + 0.5);
+		if ( trace->sh.npts - trace->first < gather->npts )
+			gather->npts = trace->sh.npts - trace->first;
+	}
+	if ( gather->npts <= 0 ) {
+		fprintf(stderr, "There is no common time window within the traces!\n");
+		goto end_process;
+	}
+/* One arena for all the traces, the missing components are zero */
+	gather->stride = (gather->npts + GATHER_ALIGN_SAMPLES - 1) / GATHER_ALIGN_SAMPLES * GATHER_ALIGN_SAMPLES;
+	if (
+		posix_memalign((void **)&gather->arena, GATHER_ALIGNMENT, (size_t)gather->nstations * GATHER_NUM_COMPONENTS * gather->stride * sizeof(float)) ||
+		(gather->stations = (GATHER_STATION *)calloc(gather->nstations, sizeof(GATHER_STATION))) == NULL
+	) {
+		fprintf(stderr, "ERROR! Out of memory for the gather of %d stations\n", gather->nstations);
+		gather->arena = NULL;
+		result = -2;
+		goto end_process;
+	}
+	for ( int c = 0; c < GATHER_NUM_COMPONENTS; c++ ) {
+		if ( (gather->comp[c] = (float **)calloc(gather->nstations, sizeof(float *))) == NULL ) {
+			fprintf(stderr, "ERROR! Out of memory for the gather of %d stations\n", gather->nstations);
+			result = -2;
+			goto end_process;
+		}
+	}
+/* */
+	station = -1;
+	for ( int i = 0; i < nfiles; i++ ) {
+		trace = traces + i;
+		if ( !i || compare_trace( trace - 1, trace ) / 2 ) {
+			station++;
+			strcpy(gather->stations[station].sta, trace->sta);
+			strcpy(gather->stations[station].net, trace->net);
+			strcpy(gather->stations[station].loc, trace->loc);
+		}
+		trace->nsamp = gather->npts;
+		trace->dest  = gather->arena + ((size_t)trace->comp * gather->nstations + station) * gather->stride;
+		gather->comp[trace->comp][station]         = trace->dest;
+		gather->stations[station].sh[trace->comp]  = trace->sh;
+		gather->stations[station].mask            |= 1 << trace->comp;
+	}
+	for ( int c = 0; c < GATHER_NUM_COMPONENTS; c++ ) {
+		for ( int s = 0; s < gather->nstations; s++ ) {
+			float *slot = gather->arena + ((size_t)c * gather->nstations + s) * gather->stride;
+
+			if ( gather->comp[c][s] )
+				memset(slot + gather->npts, 0, (gather->stride - gather->npts) * sizeof(float));
+			else
+				memset(slot, 0, gather->stride * sizeof(float));
+		}
+	}
+/* Then the samples within the window, directly into the arena */
+	batch_jobs_run( nfiles, nthreads, data_job_func, traces );
+	for ( int i = 0; i < nfiles; i++ )
+		if ( traces[i].result )
+			goto end_process;
+	result = gather->nstations;
+
+end_process:
+	free(traces);
+	if ( result < 0 )
+		gather_free( gather );
+
+	return result;
+}
+
+/**
+ * @brief
+ *
+ * @param gather
+ */
+void gather_free( SAC_GATHER *gather )
+{
+	free(gather->arena);
+	for ( int c = 0; c < GATHER_NUM_COMPONENTS; c++ )
+		free(gather->comp[c]);
+	free(gather->stations);
+	memset(gather, 0, sizeof(SAC_GATHER));
+
+	return;
+}
+
+/**
+ * @brief Read the header of each trace, it will be called by the batch threads.
+ *
+ * @param arg
+ * @param index
+ */
+static void header_job_func( void *arg, const int index )
+{
+	GATHER_TRACE *trace = (GATHER_TRACE *)arg + index;
+	int           fd;
+
+/* */
+	trace->result = -1;
+	if ( (fd = open(trace->path, O_RDONLY)) < 0 ) {
+		fprintf(stderr, "Error opening %s\n", trace->path);
+		return;
+	}
+	if ( (trace->swap = sac_header_pread( fd, &trace->sh )) >= 0 ) {
+		if ( (trace->comp = component_index( trace->sh.kcmpnm )) < 0 ) {
+			fprintf(stderr, "Unknown component of %s: %s!\n", trace->path, sac_scnl_print( &trace->sh ));
+		}
+		else {
+		/* The last byte of each code is kept zero since the traces are cleared */
+			sac_code_pack( trace->sta, trace->sh.kstnm );
+			sac_code_pack( trace->net, trace->sh.knetwk );
+			sac_code_pack( trace->loc, trace->sh.khole );
+			trace->result = 0;
+		}
+	}
+	close(fd);
+
+	return;
+}
+
+/**
+ * @brief Read the samples within the common window into the arena, it will be called by the batch
+ *        threads.
+ *
+ * @param arg
+ * @param index
+ */
+static void data_job_func( void *arg, const int index )
+{
+	GATHER_TRACE *trace = (GATHER_TRACE *)arg + index;
+	int           fd;
+
+/* */
+	trace->result = -1;
+	if ( (fd = open(trace->path, O_RDONLY)) < 0 ) {
+		fprintf(stderr, "Error opening %s\n", trace->path);
+		return;
+	}
+	if ( sac_data_pread( fd, trace->swap, trace->dest, trace->first, trace->nsamp ) == trace->nsamp )
+		trace->result = 0;
+	close(fd);
+
+	return;
+}
+
+/**
+ * @brief Sort by the network, station, location & then the component. The return value is 2 times
+ *        of the comparison if the station is different, so it can be used for grouping.
+ *
+ * @param a
+ * @param b
+ * @return int
+ */
+static int compare_trace( const void *a, const void *b )
+{
+	const GATHER_TRACE *_a = (const GATHER_TRACE *)a;
+	const GATHER_TRACE *_b = (const GATHER_TRACE *)b;
+	int                 result;
+
+/* */
+	if (
+		(result = strcmp(_a->net, _b->net)) ||
+		(result = strcmp(_a->sta, _b->sta)) ||
+		(result = strcmp(_a->loc, _b->loc))
+	) {
+		return result > 0 ? 2 : -2;
+	}
+
+	return (_a->comp > _b->comp) - (_a->comp < _b->comp);
+}
+
+/**
+ * @brief Determine the component by the third character of the component name.
+ *
+ * @param kcmpnm
+ * @return int
+ */
+static int component_index( const char *kcmpnm )
+{
+	switch ( kcmpnm[2] ) {
+	case 'Z' :
+	case 'z' :
+		return GATHER_COMP_Z;
+	case 'N' :
+	case 'n' :
+	case '1' :
+		return GATHER_COMP_N;
+	case 'E' :
+	case 'e' :
+	case '2' :
+		return GATHER_COMP_E;
+	default :
+		return -1;
+	}
+}
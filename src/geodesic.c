@@ -0,0 +1,81 @@
+/**
+ * @file geodesic.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Main source code for the event-station geometry. The geographic latitudes are converted to
+ *        the geocentric ones, then the arc distance comes from the haversine formula & the azimuths
+ *        from the spherical triangle. The terms of the event are calculated once for all stations.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <math.h>
+/* */
+#include <geodesic.h>
+
+/* */
+#define DEG2RAD(__DEG)  ((__DEG) * 0.017453292519943295)
+#define RAD2DEG(__RAD)  ((__RAD) * 57.29577951308232)
+/* Geocentric latitude (rad) from the geographic one (deg) */
+#define GEOCENTRIC_LAT(__LAT) \
+		atan((1.0 - GEODESIC_FLATTENING) * (1.0 - GEODESIC_FLATTENING) * tan(DEG2RAD(__LAT)))
+
+/* */
+static inline double azimuth_normalize( const double );
+
+/**
+ * @brief Calculate the distance, azimuth, back-azimuth & arc distance from the event to all the
+ *        stations. The loop has no branch, so it can be vectorized by the compiler.
+ *
+ * @param evla
+ * @param evlo
+ * @param stla
+ * @param stlo
+ * @param nsta
+ * @param result
+ */
+void geodesic_distaz( const double evla, const double evlo, const double *restrict stla, const double *restrict stlo, const int nsta, GEODESIC_RESULT *result )
+{
+	const double ev_lat = GEOCENTRIC_LAT(evla);
+	const double ev_sin = sin(ev_lat);
+	const double ev_cos = cos(ev_lat);
+
+	float *restrict dist  = result->dist;
+	float *restrict az    = result->az;
+	float *restrict baz   = result->baz;
+	float *restrict gcarc = result->gcarc;
+
+/* */
+	for ( int i = 0; i < nsta; i++ ) {
+		const double st_lat  = GEOCENTRIC_LAT(stla[i]);
+		const double st_sin  = sin(st_lat);
+		const double st_cos  = cos(st_lat);
+		const double dlon    = DEG2RAD(stlo[i] - evlo);
+		const double dlon_s  = sin(dlon);
+		const double dlon_c  = cos(dlon);
+		const double hlat    = sin((st_lat - ev_lat) * 0.5);
+		const double hlon    = sin(dlon * 0.5);
+		const double arc     = 2.0 * asin(sqrt(hlat * hlat + ev_cos * st_cos * hlon * hlon));
+
+		dist[i]  = arc * GEODESIC_EARTH_RADIUS;
+		gcarc[i] = RAD2DEG(arc);
+		az[i]    = azimuth_normalize( atan2(dlon_s * st_cos, ev_cos * st_sin - ev_sin * st_cos * dlon_c) );
+		baz[i]   = azimuth_normalize( atan2(-dlon_s * ev_cos, st_cos * ev_sin - st_sin * ev_cos * dlon_c) );
+	}
+
+	return;
+}
+
+/**
+ * @brief Map the azimuth from atan2() (-pi, pi] to [0, 360) deg.
+ *
+ * @param azimuth
+ * @return double
+ */
+static inline double azimuth_normalize( const double azimuth )
+{
+	const double result = RAD2DEG(azimuth);
+
+	return result < 0.0 ? result + 360.0 : result;
+}
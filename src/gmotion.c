@@ -0,0 +1,95 @@
+/**
+ * @file gmotion.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Main source code for the ground motion metrics. All the metrics are derived from one
+ *        fused pass over the acceleration which keeps the running cumulative sums.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+/* */
+#include <gmotion.h>
+
+/* */
+static int cumsum_search( const double *, const int, const double );
+
+/**
+ * @brief Calculate the PGA, Arias intensity, CAV & 5-95% significant duration of the input
+ *        acceleration. The trace should be gap filled & demeaned before.
+ *
+ * @param acc
+ * @param npts
+ * @param delta
+ * @param metrics
+ * @return int
+ * @returns: 0 on success
+ *          -1 on invalid arguments
+ *          -2 on out of memory
+ */
+int gmotion_metrics_calc( const float *acc, const int npts, const double delta, GM_METRICS *metrics )
+{
+	double *cumsum;
+	double  sq_sum  = 0.0;
+	double  abs_sum = 0.0;
+	double  peak    = 0.0;
+	double  sample;
+
+/* */
+	memset(metrics, 0, sizeof(GM_METRICS));
+	if ( npts < 1 || delta <= 0.0 )
+		return -1;
+	if ( (cumsum = (double *)malloc(sizeof(double) * npts)) == NULL )
+		return -2;
+/* The fused pass, keep the cumulative squared sum for the duration */
+	for ( int i = 0; i < npts; i++ ) {
+		sample     = fabs(acc[i]);
+		peak       = sample > peak ? sample : peak;
+		abs_sum   += sample;
+		sq_sum    += sample * sample;
+		cumsum[i]  = sq_sum;
+	}
+/* */
+	metrics->pga   = peak;
+	metrics->cav   = abs_sum * delta;
+	metrics->arias = M_PI / (2.0 * GM_GRAVITY_GAL) * sq_sum * delta * 0.01;
+	if ( sq_sum > 0.0 ) {
+		metrics->t_start = cumsum_search( cumsum, npts, sq_sum * GM_DURATION_START ) * delta;
+		metrics->t_end   = cumsum_search( cumsum, npts, sq_sum * GM_DURATION_END ) * delta;
+		metrics->dur     = metrics->t_end - metrics->t_start;
+	}
+/* */
+	free(cumsum);
+
+	return 0;
+}
+
+/**
+ * @brief Find the first index where the cumulative sum reaches the level.
+ *
+ * @param cumsum
+ * @param npts
+ * @param level
+ * @return int
+ */
+static int cumsum_search( const double *cumsum, const int npts, const double level )
+{
+	int low  = 0;
+	int high = npts - 1;
+	int mid;
+
+/* */
+	while ( low < high ) {
+		mid = (low + high) / 2;
+		if ( cumsum[mid] < level )
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	return low;
+}
@@ -0,0 +1,241 @@
+/**
+ * @file peaktrack.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Main source code for the O(n) sliding-window peak tracker. The running maximum &
+ *        minimum are kept by two monotonic deques, each sample is pushed & popped at most once.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+/* */
+#include <peaktrack.h>
+
+/* */
+static int  deque_init( PEAK_DEQUE *, const int );
+static void deque_push( PEAK_DEQUE *, const int, const long, const float, const int );
+static void deque_expire( PEAK_DEQUE *, const int, const long );
+
+/**
+ * @brief
+ *
+ * @param tracker
+ * @param window
+ * @return int
+ * @returns: 0 on success
+ *          -1 on invalid window
+ *          -2 on out of memory
+ */
+int peaktrack_init( PEAK_TRACKER *tracker, const int window )
+{
+	memset(tracker, 0, sizeof(PEAK_TRACKER));
+	if ( window < 1 )
+		return -1;
+/* */
+	tracker->window   = window;
+	tracker->capacity = window + 1;
+	if ( deque_init( &tracker->max, tracker->capacity ) || deque_init( &tracker->min, tracker->capacity ) ) {
+		peaktrack_free( tracker );
+		return -2;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Push the next sample, the window will slide by one sample.
+ *
+ * @param tracker
+ * @param sample
+ */
+void peaktrack_push( PEAK_TRACKER *tracker, const float sample )
+{
+	const long index = tracker->count++;
+
+/* */
+	deque_push( &tracker->max, tracker->capacity, index, sample, 1 );
+	deque_push( &tracker->min, tracker->capacity, index, sample, 0 );
+	deque_expire( &tracker->max, tracker->capacity, index - tracker->window );
+	deque_expire( &tracker->min, tracker->capacity, index - tracker->window );
+
+	return;
+}
+
+/**
+ * @brief The maximum within the window, it should be called after at least one sample pushed.
+ *
+ * @param tracker
+ * @return float
+ */
+float peaktrack_max( const PEAK_TRACKER *tracker )
+{
+	return tracker->max.value[tracker->max.head];
+}
+
+/**
+ * @brief The minimum within the window, it should be called after at least one sample pushed.
+ *
+ * @param tracker
+ * @return float
+ */
+float peaktrack_min( const PEAK_TRACKER *tracker )
+{
+	return tracker->min.value[tracker->min.head];
+}
+
+/**
+ * @brief The peak absolute value within the window.
+ *
+ * @param tracker
+ * @return float
+ */
+float peaktrack_absmax( const PEAK_TRACKER *tracker )
+{
+	const float max = fabsf(peaktrack_max( tracker ));
+	const float min = fabsf(peaktrack_min( tracker ));
+
+	return max > min ? max : min;
+}
+
+/**
+ * @brief Reset the tracker to the empty window, the buffers will be kept.
+ *
+ * @param tracker
+ */
+void peaktrack_reset( PEAK_TRACKER *tracker )
+{
+	tracker->count    = 0;
+	tracker->max.head = tracker->max.size = 0;
+	tracker->min.head = tracker->min.size = 0;
+
+	return;
+}
+
+/**
+ * @brief
+ *
+ * @param tracker
+ */
+void peaktrack_free( PEAK_TRACKER *tracker )
+{
+	free(tracker->max.index);
+	free(tracker->max.value);
+	free(tracker->min.index);
+	free(tracker->min.value);
+	memset(tracker, 0, sizeof(PEAK_TRACKER));
+
+	return;
+}
+
+/**
+ * @brief The running peak absolute value over the last window samples at every sample, the
+ *        output can be the same buffer as the input.
+ *
+ * @param input
+ * @param npts
+ * @param window
+ * @param output
+ * @return int
+ */
+int peaktrack_running_absmax( const float *input, const int npts, const int window, float *output )
+{
+	PEAK_TRACKER tracker;
+	int          result;
+
+/* */
+	if ( (result = peaktrack_init( &tracker, window )) )
+		return result;
+	for ( int i = 0; i < npts; i++ ) {
+		peaktrack_push( &tracker, input[i] );
+		output[i] = peaktrack_absmax( &tracker );
+	}
+	peaktrack_free( &tracker );
+
+	return 0;
+}
+
+/**
+ * @brief The vector magnitude of the Z/N/E triplet, the peaks of it can be tracked like the
+ *        single component. The output can be the same buffer as any of the inputs.
+ *
+ * @param z
+ * @param n
+ * @param e
+ * @param npts
+ * @param output
+ * @return float*
+ */
+float *peaktrack_vector_magnitude( const float *z, const float *n, const float *e, const int npts, float *output )
+{
+	for ( int i = 0; i < npts; i++ )
+		output[i] = sqrtf(z[i] * z[i] + n[i] * n[i] + e[i] * e[i]);
+
+	return output;
+}
+
+/**
+ * @brief
+ *
+ * @param deque
+ * @param capacity
+ * @return int
+ */
+static int deque_init( PEAK_DEQUE *deque, const int capacity )
+{
+	deque->head  = 0;
+	deque->size  = 0;
+	deque->index = (long *)malloc(sizeof(long) * capacity);
+	deque->value = (float *)malloc(sizeof(float) * capacity);
+
+	return deque->index && deque->value ? 0 : -1;
+}
+
+/**
+ * @brief Push to the back, the samples which can't be the extreme anymore are popped from the back.
+ *
+ * @param deque
+ * @param capacity
+ * @param index
+ * @param value
+ * @param is_max
+ */
+static void deque_push( PEAK_DEQUE *deque, const int capacity, const long index, const float value, const int is_max )
+{
+	int back;
+
+/* */
+	while ( deque->size ) {
+		back = (deque->head + deque->size - 1) % capacity;
+		if ( is_max ? deque->value[back] > value : deque->value[back] < value )
+			break;
+		deque->size--;
+	}
+/* */
+	back = (deque->head + deque->size) % capacity;
+	deque->index[back] = index;
+	deque->value[back] = value;
+	deque->size++;
+
+	return;
+}
+
+/**
+ * @brief Pop the samples out of the window from the front.
+ *
+ * @param deque
+ * @param capacity
+ * @param oldest
+ */
+static void deque_expire( PEAK_DEQUE *deque, const int capacity, const long oldest )
+{
+	while ( deque->size && deque->index[deque->head] <= oldest ) {
+		deque->head = (deque->head + 1) % capacity;
+		deque->size--;
+	}
+
+	return;
+}
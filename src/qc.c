@@ -0,0 +1,216 @@
+/**
+ * @file qc.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Main source code for the data quality control metrics. The gaps, statistics & clipped
+ *        runs are accumulated sample by sample, and the spikes are detected by the median & MAD
+ *        of every block while it is still in cache, so all the metrics come from one pass.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <string.h>
+#include <math.h>
+#include <float.h>
+/* */
+#include <sachead.h>
+#include <qc.h>
+
+/* */
+#define QC_MIN_SPIKE_BLOCK  16  /* Minimum number of samples in the last block for spike detection */
+
+/* */
+static void  close_clip_run( QC_STATE * );
+static void  detect_block_spikes( QC_STATE * );
+static float select_kth( float *, const int, const int );
+
+/**
+ * @brief
+ *
+ * @param state
+ * @param param
+ */
+void qc_state_init( QC_STATE *state, const QC_PARAM *param )
+{
+	memset(state, 0, sizeof(QC_STATE));
+	state->param       = *param;
+	state->metrics.min = DBL_MAX;
+	state->metrics.max = -DBL_MAX;
+
+	return;
+}
+
+/**
+ * @brief Feed the next block of samples into the state.
+ *
+ * @param state
+ * @param input
+ * @param nsamp
+ */
+void qc_state_update( QC_STATE *state, const float *input, const int nsamp )
+{
+	QC_METRICS  *metrics    = &state->metrics;
+	const double clip_level = state->param.clip_level;
+
+/* */
+	for ( int i = 0; i < nsamp; i++ ) {
+		const float x = input[i];
+
+	/* Undefined sample, it also breaks the clipped run */
+		if ( x == SACUNDEF ) {
+			if ( !state->in_gap ) {
+				metrics->ngaps++;
+				state->in_gap = 1;
+			}
+			metrics->gap_samples++;
+			close_clip_run( state );
+			continue;
+		}
+		state->in_gap = 0;
+	/* Statistics */
+		state->sum   += x;
+		state->sqsum += (double)x * x;
+		if ( x < metrics->min )
+			metrics->min = x;
+		if ( x > metrics->max )
+			metrics->max = x;
+	/* Clipped run */
+		if ( fabs(x) >= clip_level )
+			state->clip_run++;
+		else
+			close_clip_run( state );
+	/* Spike detection of the full block */
+		state->work[state->nwork++] = x;
+		if ( state->nwork == QC_BLOCK_SAMPLES )
+			detect_block_spikes( state );
+	}
+	metrics->npts += nsamp;
+
+	return;
+}
+
+/**
+ * @brief Flush the remained block & derive the final metrics & flags.
+ *
+ * @param state
+ * @param metrics
+ */
+void qc_state_finish( QC_STATE *state, QC_METRICS *metrics )
+{
+	QC_METRICS *result  = &state->metrics;
+	const int   defined = result->npts - result->gap_samples;
+	double      std;
+
+/* */
+	close_clip_run( state );
+	if ( state->nwork >= QC_MIN_SPIKE_BLOCK )
+		detect_block_spikes( state );
+/* */
+	result->avail = result->npts > 0 ? 100.0 * defined / result->npts : 0.0;
+	if ( defined > 0 ) {
+		result->mean = state->sum / defined;
+		result->rms  = sqrt(state->sqsum / defined);
+		std          = result->rms * result->rms - result->mean * result->mean;
+		std          = std > 0.0 ? sqrt(std) : 0.0;
+		result->dead = std < state->param.dead_std;
+		result->dc   = fabs(result->mean) > state->param.dc_ratio * std;
+	}
+	else {
+		result->min  = result->max = 0.0;
+		result->dead = 1;
+	}
+/* */
+	*metrics = *result;
+
+	return;
+}
+
+/**
+ * @brief
+ *
+ * @param state
+ */
+static void close_clip_run( QC_STATE *state )
+{
+	if ( state->clip_run >= QC_MIN_CLIP_RUN ) {
+		state->metrics.clip_runs++;
+		state->metrics.clip_samples += state->clip_run;
+	}
+	state->clip_run = 0;
+
+	return;
+}
+
+/**
+ * @brief Count the samples of the work block which are far from the block median in the unit of
+ *        the scaled MAD.
+ *
+ * @param state
+ */
+static void detect_block_spikes( QC_STATE *state )
+{
+	const int n = state->nwork;
+	float     median;
+	float     threshold;
+
+/* Median of the block, selection works on the copy */
+	memcpy(state->dev, state->work, n * sizeof(float));
+	median = select_kth( state->dev, n, n >> 1 );
+/* MAD of the block */
+	for ( int i = 0; i < n; i++ )
+		state->dev[i] = fabsf(state->work[i] - median);
+	threshold = state->param.spike_factor * QC_MAD_SCALE * select_kth( state->dev, n, n >> 1 );
+/* */
+	if ( threshold > 0.0 )
+		for ( int i = 0; i < n; i++ )
+			state->metrics.spikes += fabsf(state->work[i] - median) > threshold;
+	state->nwork = 0;
+
+	return;
+}
+
+/**
+ * @brief Quickselect of the k-th smallest value, the input array will be partially reordered.
+ *
+ * @param array
+ * @param n
+ * @param k
+ * @return float
+ */
+static float select_kth( float *array, const int n, const int k )
+{
+	int   left  = 0;
+	int   right = n - 1;
+	float pivot;
+	float tmp;
+
+/* */
+	while ( left < right ) {
+		int i = left;
+		int j = right;
+
+		pivot = array[(left + right) >> 1];
+		while ( i <= j ) {
+			while ( array[i] < pivot )
+				i++;
+			while ( array[j] > pivot )
+				j--;
+			if ( i <= j ) {
+				tmp      = array[i];
+				array[i] = array[j];
+				array[j] = tmp;
+				i++;
+				j--;
+			}
+		}
+		if ( k <= j )
+			right = j;
+		else if ( k >= i )
+			left = i;
+		else
+			break;
+	}
+
+	return array[k];
+}
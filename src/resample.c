@@ -0,0 +1,385 @@
+/**
+ * @file resample.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Main source code for the polyphase FIR resampling by rational factors. Only the kept
+ *        output samples are computed, each of them is one dot product between the reversed
+ *        taps of its phase & the contiguous input history.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+/* */
+#include <resample.h>
+
+/* */
+typedef float v4sf __attribute__((vector_size(16)));
+/* */
+static RESAMPLE_KERNEL *kernel_create( const int, const int );
+static double bessel_i0( const double );
+static int    gcd_calc( int, int );
+static int    state_output( RESAMPLE_STATE *, float *, const int, const long );
+static inline float dot_product( const float *, const float *, const int );
+/* */
+static RESAMPLE_KERNEL *KernelCache = NULL;
+static pthread_mutex_t  KernelMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Fetch the kernel of the ratio from the cache, the kernel will be designed and
+ *        inserted into the cache at the first time.
+ *
+ * @param up
+ * @param down
+ * @return const RESAMPLE_KERNEL*
+ */
+const RESAMPLE_KERNEL *resample_kernel_get( const int up, const int down )
+{
+	RESAMPLE_KERNEL *result;
+	int              _up   = up;
+	int              _down = down;
+
+/* */
+	if ( resample_ratio_reduce( &_up, &_down ) )
+		return NULL;
+/* */
+	pthread_mutex_lock(&KernelMutex);
+	for ( result = KernelCache; result; result = result->next )
+		if ( result->up == _up && result->down == _down )
+			break;
+	if ( !result && (result = kernel_create( _up, _down )) ) {
+		result->next = KernelCache;
+		KernelCache  = result;
+	}
+	pthread_mutex_unlock(&KernelMutex);
+
+	return result;
+}
+
+/**
+ * @brief Free all the cached kernels, the kernels fetched before should not be used anymore.
+ *
+ */
+void resample_kernel_cache_free( void )
+{
+	RESAMPLE_KERNEL *next;
+
+/* */
+	pthread_mutex_lock(&KernelMutex);
+	for ( ; KernelCache; KernelCache = next ) {
+		next = KernelCache->next;
+		free(KernelCache->taps);
+		free(KernelCache);
+	}
+	pthread_mutex_unlock(&KernelMutex);
+
+	return;
+}
+
+/**
+ * @brief Reduce the ratio by the greatest common divisor.
+ *
+ * @param up
+ * @param down
+ * @return int
+ */
+int resample_ratio_reduce( int *up, int *down )
+{
+	int gcd;
+
+/* */
+	if ( *up < 1 || *down < 1 )
+		return -1;
+	gcd    = gcd_calc( *up, *down );
+	*up   /= gcd;
+	*down /= gcd;
+
+	return (*up > RESAMPLE_MAX_FACTOR || *down > RESAMPLE_MAX_FACTOR) ? -1 : 0;
+}
+
+/**
+ * @brief Number of output samples for the input length, it is ceil(npts * up / down).
+ *
+ * @param npts
+ * @param up
+ * @param down
+ * @return long
+ */
+long resample_output_length( const long npts, const int up, const int down )
+{
+	return (npts * up + down - 1) / down;
+}
+
+/**
+ * @brief
+ *
+ * @param state
+ * @param up
+ * @param down
+ * @return int
+ */
+int resample_state_init( RESAMPLE_STATE *state, const int up, const int down )
+{
+	memset(state, 0, sizeof(RESAMPLE_STATE));
+	if ( (state->kernel = resample_kernel_get( up, down )) == NULL )
+		return -1;
+/* The history before the first sample is treated as zeros */
+	state->buf_cap = state->kernel->ntaps * 2;
+	if ( (state->buffer = (float *)calloc(state->buf_cap, sizeof(float))) == NULL )
+		return -1;
+	state->buf_len   = state->kernel->ntaps;
+	state->buf_start = -state->kernel->ntaps;
+
+	return 0;
+}
+
+/**
+ * @brief Feed one block of input samples, & output all the samples which can be
+ *        determined now.
+ *
+ * @param state
+ * @param input
+ * @param nin
+ * @param output
+ * @param maxout
+ * @return int
+ * @returns: number of output samples
+ *          -1 on out of memory
+ */
+int resample_process( RESAMPLE_STATE *state, const float *input, const int nin, float *output, const int maxout )
+{
+	float *tmp;
+
+/* */
+	if ( state->buf_len + nin > state->buf_cap ) {
+		if ( (tmp = (float *)realloc(state->buffer, sizeof(float) * (state->buf_len + nin) * 2)) == NULL )
+			return -1;
+		state->buffer  = tmp;
+		state->buf_cap = (state->buf_len + nin) * 2;
+	}
+	memcpy(state->buffer + state->buf_len, input, sizeof(float) * nin);
+	state->buf_len  += nin;
+	state->in_count += nin;
+
+	return state_output( state, output, maxout, state->buf_start + state->buf_len );
+}
+
+/**
+ * @brief Output the remained samples at the end of the input, the samples after the end
+ *        are treated as zeros.
+ *
+ * @param state
+ * @param output
+ * @param maxout
+ * @return int
+ */
+int resample_flush( RESAMPLE_STATE *state, float *output, const int maxout )
+{
+	const RESAMPLE_KERNEL *kernel = state->kernel;
+	const long             target = resample_output_length( state->in_count, kernel->up, kernel->down );
+	const int              npad   = kernel->half_len / kernel->up + 2;
+	float                  zeros[RESAMPLE_SIMD_WIDTH * 32] = { 0 };
+	int                    result = 0;
+	int                    count;
+	int                    nzero;
+
+/* Pad the zeros after the end, it will not change the input count & the output will not exceed the target */
+	for ( int i = 0; i < npad; i += nzero ) {
+		nzero = npad - i < (int)(sizeof(zeros) / sizeof(float)) ? npad - i : (int)(sizeof(zeros) / sizeof(float));
+		count = target - state->out_count < maxout - result ? (int)(target - state->out_count) : maxout - result;
+		if ( (count = resample_process( state, zeros, nzero, output + result, count )) < 0 )
+			return -1;
+		result += count;
+	}
+	state->in_count -= npad;
+
+	return result;
+}
+
+/**
+ * @brief
+ *
+ * @param state
+ */
+void resample_state_free( RESAMPLE_STATE *state )
+{
+	if ( state->buffer )
+		free(state->buffer);
+	memset(state, 0, sizeof(RESAMPLE_STATE));
+
+	return;
+}
+
+/**
+ * @brief Design the Kaiser windowed sinc prototype & split it into the phases.
+ *
+ * @param up
+ * @param down
+ * @return RESAMPLE_KERNEL*
+ */
+static RESAMPLE_KERNEL *kernel_create( const int up, const int down )
+{
+	const int    max_fac  = up > down ? up : down;
+	const int    half_len = RESAMPLE_HALF_ZEROS * max_fac;
+	const int    flen     = half_len * 2 + 1;
+	const double fc       = 1.0 / max_fac;
+	const double i0beta   = bessel_i0( RESAMPLE_KAISER_BETA );
+
+	RESAMPLE_KERNEL *result;
+	double          *proto;
+	double           sum = 0.0;
+	double           x, r;
+	int              ntaps;
+
+/* */
+	if ( (proto = (double *)malloc(sizeof(double) * flen)) == NULL )
+		return NULL;
+	for ( int i = 0; i < flen; i++ ) {
+		x = (i - half_len) * fc;
+		r = (double)(i - half_len) / half_len;
+		proto[i]  = x == 0.0 ? 1.0 : sin(M_PI * x) / (M_PI * x);
+		proto[i] *= bessel_i0( RESAMPLE_KAISER_BETA * sqrt(1.0 - r * r) ) / i0beta;
+		sum      += proto[i];
+	}
+/* */
+	ntaps  = (flen + up - 1) / up;
+	ntaps  = (ntaps + RESAMPLE_SIMD_WIDTH - 1) / RESAMPLE_SIMD_WIDTH * RESAMPLE_SIMD_WIDTH;
+	if ( (result = (RESAMPLE_KERNEL *)calloc(1, sizeof(RESAMPLE_KERNEL))) == NULL ) {
+		free(proto);
+		return NULL;
+	}
+	if ( (result->taps = (float *)calloc((size_t)ntaps * up, sizeof(float))) == NULL ) {
+		free(result);
+		free(proto);
+		return NULL;
+	}
+	result->up       = up;
+	result->down     = down;
+	result->half_len = half_len;
+	result->ntaps    = ntaps;
+/* The gain of each phase should be unity, the taps are reversed for the dot product */
+	for ( int p = 0; p < up; p++ )
+		for ( int k = 0; p + k * up < flen; k++ )
+			result->taps[p * ntaps + ntaps - 1 - k] = proto[p + k * up] * up / sum;
+/* */
+	free(proto);
+
+	return result;
+}
+
+/**
+ * @brief Output the samples whose input history is ended before the limit.
+ *
+ * @param state
+ * @param output
+ * @param maxout
+ * @param limit
+ * @return int
+ */
+static int state_output( RESAMPLE_STATE *state, float *output, const int maxout, const long limit )
+{
+	const RESAMPLE_KERNEL *kernel = state->kernel;
+	long                   t, base;
+	long                   drop;
+	int                    result = 0;
+
+/* */
+	while ( result < maxout ) {
+		t    = state->out_count * kernel->down + kernel->half_len;
+		base = t / kernel->up;
+		if ( base >= limit )
+			break;
+		output[result++] = dot_product(
+			kernel->taps + (t % kernel->up) * kernel->ntaps,
+			state->buffer + (base - kernel->ntaps + 1 - state->buf_start),
+			kernel->ntaps
+		);
+		state->out_count++;
+	}
+/* Drop the input samples which will not be used anymore */
+	t    = state->out_count * kernel->down + kernel->half_len;
+	drop = t / kernel->up - kernel->ntaps + 1 - state->buf_start;
+	if ( drop > state->buf_len )
+		drop = state->buf_len;
+	if ( drop > 0 ) {
+		memmove(state->buffer, state->buffer + drop, sizeof(float) * (state->buf_len - drop));
+		state->buf_len   -= drop;
+		state->buf_start += drop;
+	}
+
+	return result;
+}
+
+/**
+ * @brief The dot product by the vector extension, the length should be the multiple of
+ *        RESAMPLE_SIMD_WIDTH.
+ *
+ * @param a
+ * @param b
+ * @param n
+ * @return float
+ */
+static inline float dot_product( const float *a, const float *b, const int n )
+{
+	v4sf acc0 = { 0.0f }, acc1 = { 0.0f };
+	v4sf va0, va1, vb0, vb1;
+
+/* */
+	for ( int i = 0; i < n; i += RESAMPLE_SIMD_WIDTH ) {
+		memcpy(&va0, a + i, sizeof(v4sf));
+		memcpy(&va1, a + i + 4, sizeof(v4sf));
+		memcpy(&vb0, b + i, sizeof(v4sf));
+		memcpy(&vb1, b + i + 4, sizeof(v4sf));
+		acc0 += va0 * vb0;
+		acc1 += va1 * vb1;
+	}
+	acc0 += acc1;
+
+	return acc0[0] + acc0[1] + acc0[2] + acc0[3];
+}
+
+/**
+ * @brief Modified Bessel function of the first kind, order zero.
+ *
+ * @param x
+ * @return double
+ */
+static double bessel_i0( const double x )
+{
+	double result = 1.0;
+	double term   = 1.0;
+
+/* */
+	for ( int k = 1; k < 50; k++ ) {
+		term   *= (x * 0.5 / k) * (x * 0.5 / k);
+		result += term;
+		if ( term < result * 1.0E-16 )
+			break;
+	}
+
+	return result;
+}
+
+/**
+ * @brief
+ *
+ * @param a
+ * @param b
+ * @return int
+ */
+static int gcd_calc( int a, int b )
+{
+	int tmp;
+
+	while ( b ) {
+		tmp = a % b;
+		a   = b;
+		b   = tmp;
+	}
+
+	return a;
+}
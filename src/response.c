@@ -0,0 +1,376 @@
+/**
+ * @file response.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Main source code for the instrument response removal by the spectral division. The
+ *        inverse response vectors (with water level & pre-filter) are cached by the response,
+ *        transform length & delta, so the identical sensors share one design.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <complex.h>
+#include <math.h>
+#include <pthread.h>
+/* */
+#include <response.h>
+#include <fft.h>
+
+/* */
+#define RESP_MAX_LINE_LENGTH  512
+/* */
+typedef struct resp_cache {
+	RESP_PZ            pz;
+	RESP_PARAM         param;
+	int                nfft;
+	double             delta;
+	double _Complex   *inverse;
+	struct resp_cache *next;
+} RESP_CACHE;
+
+/* */
+static double _Complex *inverse_design( const RESP_PZ *, const int, const double, const RESP_PARAM * );
+static double prefilter_taper( const double, const double * );
+static int    read_complex_lines( FILE *, double _Complex *, const int );
+/* */
+static RESP_CACHE     *RespCache = NULL;
+static pthread_mutex_t RespMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Load the responses of all the channels from the local file. The file is in the SAC
+ *        poles & zeros format with an extra "CHANNEL <SCNL>" line before each response, e.g.:
+ *
+ *        CHANNEL TEST.HHZ.TW.--
+ *        ZEROS 3
+ *        POLES 2
+ *        -0.0370 0.0370
+ *        -0.0370 -0.0370
+ *        CONSTANT 3.948580e+17
+ *
+ *        Like the SAC format, the zeros (or poles) not listed are at the origin.
+ *
+ * @param filename
+ * @param channels
+ * @return int
+ * @returns: number of channels on success
+ *          -1 on error opening or parsing file
+ *          -2 on out of memory
+ */
+int response_file_load( const char *filename, RESP_CHANNEL **channels )
+{
+	FILE         *fp;
+	RESP_CHANNEL *_channels = NULL;
+	RESP_CHANNEL *current   = NULL;
+	RESP_CHANNEL *tmp;
+	char          line[RESP_MAX_LINE_LENGTH];
+	char          key[RESP_MAX_LINE_LENGTH];
+	char          value[RESP_MAX_LINE_LENGTH];
+	int           count  = 0;
+	int           result = -1;
+	int           num;
+
+/* */
+	if ( (fp = fopen(filename, "r")) == (FILE *)NULL ) {
+		fprintf(stderr, "Error opening response file %s\n", filename);
+		return -1;
+	}
+/* */
+	while ( fgets(line, sizeof(line), fp) ) {
+		if ( sscanf(line, "%s %s", key, value) < 1 || key[0] == '#' || key[0] == '*' )
+			continue;
+	/* Start of a new channel */
+		if ( !strcmp(key, "CHANNEL") ) {
+			if ( (tmp = (RESP_CHANNEL *)realloc(_channels, sizeof(RESP_CHANNEL) * (count + 1))) == NULL ) {
+				result = -2;
+				goto end_process;
+			}
+			_channels = tmp;
+			current   = _channels + count++;
+			memset(current, 0, sizeof(RESP_CHANNEL));
+			strncpy(current->scnl, value, SAC_MAX_SCNL_LENGTH - 1);
+			current->pz.constant = 1.0;
+			continue;
+		}
+	/* */
+		if ( !current ) {
+			fprintf(stderr, "Response file %s: '%s' before any CHANNEL line!\n", filename, key);
+			goto end_process;
+		}
+		if ( !strcmp(key, "ZEROS") || !strcmp(key, "POLES") ) {
+			num = atoi(value);
+			if ( num < 0 || num > RESP_MAX_PZ ) {
+				fprintf(stderr, "Response file %s: too many %s for %s!\n", filename, key, current->scnl);
+				goto end_process;
+			}
+			if ( key[0] == 'Z' ) {
+				current->pz.nzeros = num;
+				if ( read_complex_lines( fp, current->pz.zeros, num ) < 0 )
+					goto end_process;
+			}
+			else {
+				current->pz.npoles = num;
+				if ( read_complex_lines( fp, current->pz.poles, num ) < 0 )
+					goto end_process;
+			}
+		}
+		else if ( !strcmp(key, "CONSTANT") ) {
+			current->pz.constant = atof(value);
+		}
+		else {
+			fprintf(stderr, "Response file %s: unknown keyword '%s'!\n", filename, key);
+			goto end_process;
+		}
+	}
+/* */
+	*channels = _channels;
+	_channels = NULL;
+	result    = count;
+
+end_process:
+	if ( _channels )
+		free(_channels);
+	fclose(fp);
+	return result;
+}
+
+/**
+ * @brief
+ *
+ * @param channels
+ * @param nchannels
+ * @param scnl
+ * @return const RESP_CHANNEL*
+ */
+const RESP_CHANNEL *response_channel_find( const RESP_CHANNEL *channels, const int nchannels, const char *scnl )
+{
+	for ( int i = 0; i < nchannels; i++ )
+		if ( !strcmp(channels[i].scnl, scnl) )
+			return channels + i;
+
+	return NULL;
+}
+
+/**
+ * @brief Fetch the inverse response vector (nfft / 2 + 1 values) from the cache, the vector
+ *        will be designed and inserted into the cache at the first time.
+ *
+ * @param pz
+ * @param nfft
+ * @param delta
+ * @param param
+ * @return const double _Complex*
+ */
+const double _Complex *response_inverse_get( const RESP_PZ *pz, const int nfft, const double delta, const RESP_PARAM *param )
+{
+	RESP_CACHE *cache;
+
+/* */
+	pthread_mutex_lock(&RespMutex);
+	for ( cache = RespCache; cache; cache = cache->next ) {
+		if (
+			cache->nfft == nfft && cache->delta == delta &&
+			!memcmp(&cache->pz, pz, sizeof(RESP_PZ)) && !memcmp(&cache->param, param, sizeof(RESP_PARAM))
+		) {
+			break;
+		}
+	}
+/* */
+	if ( !cache && (cache = (RESP_CACHE *)calloc(1, sizeof(RESP_CACHE))) ) {
+		if ( (cache->inverse = inverse_design( pz, nfft, delta, param )) ) {
+			cache->pz    = *pz;
+			cache->param = *param;
+			cache->nfft  = nfft;
+			cache->delta = delta;
+			cache->next  = RespCache;
+			RespCache    = cache;
+		}
+		else {
+			free(cache);
+			cache = NULL;
+		}
+	}
+	pthread_mutex_unlock(&RespMutex);
+
+	return cache ? cache->inverse : NULL;
+}
+
+/**
+ * @brief
+ *
+ */
+void response_cache_free( void )
+{
+	RESP_CACHE *next;
+
+/* */
+	pthread_mutex_lock(&RespMutex);
+	for ( ; RespCache; RespCache = next ) {
+		next = RespCache->next;
+		free(RespCache->inverse);
+		free(RespCache);
+	}
+	pthread_mutex_unlock(&RespMutex);
+
+	return;
+}
+
+/**
+ * @brief Remove the response from the trace in place, the trace should be gap filled &
+ *        demeaned before. The trace is zero padded to at least twice the length, so the
+ *        long-period part of the deconvolution won't wrap the end of the trace onto its start.
+ *
+ * @param seis
+ * @param npts
+ * @param delta
+ * @param pz
+ * @param param
+ * @return int
+ * @returns: 0 on success
+ *          -1 on error designing the response
+ *          -2 on out of memory
+ */
+int response_remove( float *seis, const int npts, const double delta, const RESP_PZ *pz, const RESP_PARAM *param )
+{
+	const int              nfft   = fft_size_good( npts * 2 );
+	const int              ntaper = (int)(npts * RESP_TIME_TAPER);
+	const FFT_PLAN        *plan   = fft_plan_get( nfft );
+	const double _Complex *inverse;
+	double                *buffer;
+	double _Complex       *spec;
+	double                 w;
+
+/* */
+	if ( !plan || !(inverse = response_inverse_get( pz, nfft, delta, param )) )
+		return -1;
+	if ( (buffer = (double *)calloc(nfft + (nfft / 2 + 1) * 2, sizeof(double))) == NULL )
+		return -2;
+	spec = (double _Complex *)(buffer + nfft);
+/* Cosine taper at both ends of the trace */
+	for ( int i = 0; i < npts; i++ ) {
+		w = 1.0;
+		if ( i < ntaper )
+			w = 0.5 - 0.5 * cos(M_PI * i / ntaper);
+		else if ( i >= npts - ntaper )
+			w = 0.5 - 0.5 * cos(M_PI * (npts - 1 - i) / ntaper);
+		buffer[i] = seis[i] * w;
+	}
+/* The spectral division, the rest of the buffer is the zero padding */
+	fft_real_forward( plan, buffer, spec );
+	for ( int k = 0; k <= nfft / 2; k++ )
+		spec[k] *= inverse[k];
+	if ( fft_real_inverse( plan, spec, buffer ) ) {
+		free(buffer);
+		return -2;
+	}
+/* */
+	for ( int i = 0; i < npts; i++ )
+		seis[i] = buffer[i];
+	free(buffer);
+
+	return 0;
+}
+
+/**
+ * @brief Design the inverse response with the water level & pre-filter.
+ *
+ * @param pz
+ * @param nfft
+ * @param delta
+ * @param param
+ * @return double _Complex*
+ */
+static double _Complex *inverse_design( const RESP_PZ *pz, const int nfft, const double delta, const RESP_PARAM *param )
+{
+	const int        nfreq = nfft / 2 + 1;
+	double _Complex *result;
+	double _Complex  s;
+	double           freq;
+	double           amp;
+	double           max_amp = 0.0;
+	double           min_amp;
+
+/* */
+	if ( (result = (double _Complex *)malloc(sizeof(double _Complex) * nfreq)) == NULL )
+		return NULL;
+/* The forward response first */
+	for ( int k = 0; k < nfreq; k++ ) {
+		s         = 2.0 * M_PI * k / (nfft * delta) * _Complex_I;
+		result[k] = pz->constant;
+		for ( int i = 0; i < pz->nzeros; i++ )
+			result[k] *= s - pz->zeros[i];
+		for ( int i = 0; i < pz->npoles; i++ )
+			result[k] /= s - pz->poles[i];
+		if ( (amp = cabs(result[k])) > max_amp )
+			max_amp = amp;
+	}
+/* Then the water level & the inverse */
+	min_amp = max_amp * pow(10.0, -param->water_level / 20.0);
+	for ( int k = 0; k < nfreq; k++ ) {
+		freq = k / (nfft * delta);
+		amp  = cabs(result[k]);
+		if ( amp < min_amp )
+			result[k] = amp > 0.0 ? result[k] / amp * min_amp : min_amp;
+		result[k] = cabs(result[k]) > 0.0 ? prefilter_taper( freq, param->freqs ) / result[k] : 0.0;
+	}
+
+	return result;
+}
+
+/**
+ * @brief The cosine taper between freqs[0] ~ freqs[1] & freqs[2] ~ freqs[3].
+ *
+ * @param freq
+ * @param freqs
+ * @return double
+ */
+static double prefilter_taper( const double freq, const double *freqs )
+{
+/* Pre-filter is turned off */
+	if ( freqs[3] <= 0.0 )
+		return 1.0;
+/* */
+	if ( freq <= freqs[0] || freq >= freqs[3] )
+		return 0.0;
+	else if ( freq < freqs[1] )
+		return 0.5 - 0.5 * cos(M_PI * (freq - freqs[0]) / (freqs[1] - freqs[0]));
+	else if ( freq > freqs[2] )
+		return 0.5 - 0.5 * cos(M_PI * (freqs[3] - freq) / (freqs[3] - freqs[2]));
+
+	return 1.0;
+}
+
+/**
+ * @brief Read the listed complex values, the remained values are kept as zero.
+ *
+ * @param fp
+ * @param values
+ * @param max_values
+ * @return int
+ */
+static int read_complex_lines( FILE *fp, double _Complex *values, const int max_values )
+{
+	char   line[RESP_MAX_LINE_LENGTH];
+	long   pos;
+	double re, im;
+	int    result = 0;
+
+/* */
+	while ( result < max_values ) {
+		pos = ftell(fp);
+		if ( !fgets(line, sizeof(line), fp) )
+			break;
+	/* Not a complex value line, put it back */
+		if ( sscanf(line, "%lf %lf", &re, &im) != 2 ) {
+			fseek(fp, pos, SEEK_SET);
+			break;
+		}
+		values[result++] = re + im * _Complex_I;
+	}
+
+	return result;
+}
@@ -0,0 +1,222 @@
+/**
+ * @file respspec.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Main source code for the elastic response spectrum. The single degree of freedom
+ *        oscillators are integrated by the exact piecewise-linear recurrence of Nigam & Jennings
+ *        (1969), and all the oscillators are kept in the structure-of-arrays form, so one pass
+ *        over the trace updates every oscillator together.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+/* */
+#include <respspec.h>
+
+/* Index of the recurrence coefficients inside the SoA buffer */
+#define RSP_A11    0
+#define RSP_A12    1
+#define RSP_A21    2
+#define RSP_A22    3
+#define RSP_B11    4
+#define RSP_B12    5
+#define RSP_B21    6
+#define RSP_B22    7
+#define RSP_C_DAMP 8  /* 2 * damping * omega */
+#define RSP_C_STIF 9  /* omega * omega */
+#define RSP_X      10
+#define RSP_V      11
+#define RSP_SD     12
+#define RSP_SA     13
+/* Should always be the last */
+#define RSP_ARRAY_COUNT 14
+
+/* */
+static void coef_gen( const double, const double, const double, double *, const int, const int );
+static void oscillators_update(
+	double * restrict, double * restrict, double * restrict, double * restrict,
+	const double * restrict, const int, const double, const double
+);
+
+/**
+ * @brief Generate the log-spaced periods between the minimum & maximum period.
+ *
+ * @param periods
+ * @param nperiods
+ * @param min_period
+ * @param max_period
+ * @return int
+ */
+int respspec_periods_gen( double *periods, const int nperiods, const double min_period, const double max_period )
+{
+	double step;
+
+/* */
+	if ( nperiods < 1 || min_period <= 0.0 || max_period < min_period )
+		return -1;
+	if ( nperiods == 1 ) {
+		periods[0] = min_period;
+		return 1;
+	}
+/* */
+	step = log(max_period / min_period) / (nperiods - 1);
+	for ( int i = 0; i < nperiods; i++ )
+		periods[i] = min_period * exp(step * i);
+
+	return nperiods;
+}
+
+/**
+ * @brief Calculate the response spectrum of the input acceleration for all the combinations
+ *        of periods & damping ratios. The results are ordered by damping first, then period.
+ *
+ * @param input
+ * @param npts
+ * @param delta
+ * @param periods
+ * @param nperiods
+ * @param dampings
+ * @param ndampings
+ * @param results
+ * @return int
+ * @returns: number of oscillators on success
+ *          -1 on invalid arguments
+ *          -2 on out of memory
+ */
+int respspec_calc(
+	const float *input, const int npts, const double delta, const double *periods, const int nperiods,
+	const double *dampings, const int ndampings, RSP_RESULT *results
+) {
+	const int nosc = nperiods * ndampings;
+
+	double *buffer;
+	double *x, *v, *sd, *sa;
+	double  omega;
+
+/* */
+	if ( npts < 1 || delta <= 0.0 || nosc < 1 )
+		return -1;
+	if ( (buffer = (double *)malloc(sizeof(double) * nosc * RSP_ARRAY_COUNT)) == NULL )
+		return -2;
+/* Design all the oscillators at once, the oscillators are at rest at the beginning */
+	for ( int i = 0; i < ndampings; i++ )
+		for ( int j = 0; j < nperiods; j++ )
+			coef_gen( periods[j], dampings[i], delta, buffer, nosc, i * nperiods + j );
+	x  = buffer + RSP_X * nosc;
+	v  = buffer + RSP_V * nosc;
+	sd = buffer + RSP_SD * nosc;
+	sa = buffer + RSP_SA * nosc;
+	memset(x, 0, sizeof(double) * nosc * 4);
+/* The main loop, each sample updates every oscillator */
+	for ( int i = 1; i < npts; i++ )
+		oscillators_update( x, v, sd, sa, buffer, nosc, input[i - 1], input[i] );
+/* */
+	for ( int i = 0; i < ndampings; i++ ) {
+		for ( int j = 0; j < nperiods; j++ ) {
+			const int k = i * nperiods + j;
+
+			omega = 2.0 * M_PI / periods[j];
+			results[k].period  = periods[j];
+			results[k].damping = dampings[i];
+			results[k].sd      = sd[k];
+			results[k].psv     = sd[k] * omega;
+			results[k].psa     = sd[k] * omega * omega;
+			results[k].sa      = sa[k];
+		}
+	}
+/* */
+	free(buffer);
+
+	return nosc;
+}
+
+/**
+ * @brief Generate the Nigam & Jennings recurrence coefficients of one oscillator, the equation
+ *        of motion is x'' + 2 * h * w * x' + w^2 * x = -a(t).
+ *
+ * @param period
+ * @param damping
+ * @param delta
+ * @param buffer
+ * @param nosc
+ * @param index
+ */
+static void coef_gen( const double period, const double damping, const double delta, double *buffer, const int nosc, const int index )
+{
+	const double omega  = 2.0 * M_PI / period;
+	const double omega2 = omega * omega;
+	const double omega3 = omega2 * omega;
+	const double sqrth  = sqrt(1.0 - damping * damping);
+	const double omegad = omega * sqrth;
+	const double ex     = exp(-damping * omega * delta);
+	const double sn     = sin(omegad * delta);
+	const double cs     = cos(omegad * delta);
+	const double t1     = (2.0 * damping * damping - 1.0) / (omega2 * delta);
+	const double t2     = 2.0 * damping / (omega3 * delta);
+	const double ssn    = ex * sn;
+	const double scs    = ex * cs;
+	const double dcs    = scs - damping / sqrth * ssn;
+	const double dsn    = omegad * ssn + damping * omega * scs;
+
+/* */
+	buffer[RSP_A11 * nosc + index] = scs + damping / sqrth * ssn;
+	buffer[RSP_A12 * nosc + index] = ssn / omegad;
+	buffer[RSP_A21 * nosc + index] = -omega / sqrth * ssn;
+	buffer[RSP_A22 * nosc + index] = dcs;
+	buffer[RSP_B11 * nosc + index] = (t1 + damping / omega) * ssn / omegad + (t2 + 1.0 / omega2) * scs - t2;
+	buffer[RSP_B12 * nosc + index] = -t1 * ssn / omegad - t2 * scs - 1.0 / omega2 + t2;
+	buffer[RSP_B21 * nosc + index] = (t1 + damping / omega) * dcs - (t2 + 1.0 / omega2) * dsn + 1.0 / (omega2 * delta);
+	buffer[RSP_B22 * nosc + index] = -t1 * dcs + t2 * dsn - 1.0 / (omega2 * delta);
+	buffer[RSP_C_DAMP * nosc + index] = 2.0 * damping * omega;
+	buffer[RSP_C_STIF * nosc + index] = omega2;
+
+	return;
+}
+
+/**
+ * @brief Advance all the oscillators by one sample & keep their peaks. The loop body is free
+ *        of branches & dependencies between oscillators, so it can be vectorized by the compiler.
+ *
+ * @param x
+ * @param v
+ * @param sd
+ * @param sa
+ * @param coef
+ * @param nosc
+ * @param acc0
+ * @param acc1
+ */
+static void oscillators_update(
+	double * restrict x, double * restrict v, double * restrict sd, double * restrict sa,
+	const double * restrict coef, const int nosc, const double acc0, const double acc1
+) {
+	const double * restrict a11 = coef + RSP_A11 * nosc;
+	const double * restrict a12 = coef + RSP_A12 * nosc;
+	const double * restrict a21 = coef + RSP_A21 * nosc;
+	const double * restrict a22 = coef + RSP_A22 * nosc;
+	const double * restrict b11 = coef + RSP_B11 * nosc;
+	const double * restrict b12 = coef + RSP_B12 * nosc;
+	const double * restrict b21 = coef + RSP_B21 * nosc;
+	const double * restrict b22 = coef + RSP_B22 * nosc;
+	const double * restrict cdp = coef + RSP_C_DAMP * nosc;
+	const double * restrict cst = coef + RSP_C_STIF * nosc;
+
+/* */
+	for ( int k = 0; k < nosc; k++ ) {
+		const double _x = a11[k] * x[k] + a12[k] * v[k] + b11[k] * acc0 + b12[k] * acc1;
+		const double _v = a21[k] * x[k] + a22[k] * v[k] + b21[k] * acc0 + b22[k] * acc1;
+		const double ax = fabs(_x);
+		const double aa = fabs(cdp[k] * _v + cst[k] * _x);
+
+		x[k]  = _x;
+		v[k]  = _v;
+		sd[k] = ax > sd[k] ? ax : sd[k];
+		sa[k] = aa > sa[k] ? aa : sa[k];
+	}
+
+	return;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file rotate.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Main source code for the horizontal components rotation. The recorded components can be
+ *        in any (non-parallel) azimuths, they will be projected back to the ground motion first
+ *        & then to the target azimuths, both steps are folded into one 2x2 matrix.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <math.h>
+/* */
+#include <sachead.h>
+#include <rotate.h>
+
+/* */
+#define DEG2RAD(__DEG)  ((__DEG) * 0.017453292519943295)
+
+/**
+ * @brief Calculate the rotation matrix from the recorded azimuths (az1, az2) to the target
+ *        azimuths (taz1, taz2), all in degrees clockwise from north.
+ *
+ * @param az1
+ * @param az2
+ * @param taz1
+ * @param taz2
+ * @param matrix
+ * @return int
+ * @returns: 0 on success
+ *          -1 on the recorded components are (nearly) parallel
+ */
+int rotate_matrix_calc( const double az1, const double az2, const double taz1, const double taz2, ROTATE_MATRIX *matrix )
+{
+	const double c1  = cos(DEG2RAD(az1));
+	const double s1  = sin(DEG2RAD(az1));
+	const double c2  = cos(DEG2RAD(az2));
+	const double s2  = sin(DEG2RAD(az2));
+	const double tc1 = cos(DEG2RAD(taz1));
+	const double ts1 = sin(DEG2RAD(taz1));
+	const double tc2 = cos(DEG2RAD(taz2));
+	const double ts2 = sin(DEG2RAD(taz2));
+/* Determinant of the recorded projection, sin(az2 - az1) */
+	const double det = c1 * s2 - s1 * c2;
+
+/* */
+	if ( fabs(det) < ROTATE_MIN_ORTHOGONAL )
+		return -1;
+/*
+ * The inverse of the recorded projection gives the ground motion:
+ *   n = ( s2 * in1 - s1 * in2) / det
+ *   e = (-c2 * in1 + c1 * in2) / det
+ * then project it onto the target azimuth: out = n * cos(taz) + e * sin(taz)
+ */
+	matrix->m11 = (tc1 * s2 - ts1 * c2) / det;
+	matrix->m12 = (ts1 * c1 - tc1 * s1) / det;
+	matrix->m21 = (tc2 * s2 - ts2 * c2) / det;
+	matrix->m22 = (ts2 * c1 - tc2 * s1) / det;
+
+	return 0;
+}
+
+/**
+ * @brief Rotate the two horizontal components in place within one pass, the gap samples
+ *        (SACUNDEF) of either component will be kept as gaps in both outputs.
+ *
+ * @param in1
+ * @param in2
+ * @param npts
+ * @param matrix
+ */
+void rotate_horizontal( float *restrict in1, float *restrict in2, const int npts, const ROTATE_MATRIX *matrix )
+{
+	const float m11 = matrix->m11;
+	const float m12 = matrix->m12;
+	const float m21 = matrix->m21;
+	const float m22 = matrix->m22;
+
+/* Branchless select, so the compiler can vectorize this loop */
+	for ( int i = 0; i < npts; i++ ) {
+		const float x   = in1[i];
+		const float y   = in2[i];
+		const int   gap = (x == SACUNDEF) | (y == SACUNDEF);
+
+		in1[i] = gap ? SACUNDEF : m11 * x + m12 * y;
+		in2[i] = gap ? SACUNDEF : m21 * x + m22 * y;
+	}
+
+	return;
+}
+
+/**
+ * @brief Normalize the azimuth into [0, 360) degrees.
+ *
+ * @param az
+ * @return double
+ */
+double rotate_azimuth_normalize( const double az )
+{
+	double result = fmod(az, 360.0);
+
+	return result < 0.0 ? result + 360.0 : result;
+}
@@ -19,21 +19,33 @@
 #include <math.h>
 #include <time.h>
 #include <float.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
 /* */
 #include <sachead.h>
 #include <sac.h>
 
 /*  */
+static int    load_sac_file( const char *, struct SAChead *, float **, SAC_GAP_MAP * );
+static FILE  *open_sac_file( const char * );
+static void   close_sac_file( FILE * );
 static int    read_sac_header( FILE *, struct SAChead * );
+static int    check_sac_header( const int, struct SAChead *, const long );
+static int    valid_sac_header( const struct SAChead * );
+static void   swap_sac_header( struct SAChead * );
 static double fetch_sac_time( const struct SAChead * );
-static float  applygain_sac_data( float *, const int, const float );
-static float  dmean_sac_data( float *, const int, const float );
-static int    fillgap_sac_data( float *, const int, const float );
+static float  applygain_sac_data( float *, const int, const float, const SAC_GAP_MAP * );
+static float  dmean_sac_data( float *, const int, const float, const SAC_GAP_MAP * );
+static int    dmean_head_length( const int, const float );
+static int    fillgap_sac_data( float *, const int, const float, const SAC_GAP_MAP * );
+static int    append_gap_run( SAC_GAP_MAP *, const int, const int );
 static char  *trim_sac_string( char *, const int );
 static void   swap_order_4byte( void * );
 
 /**
- * @brief
+ * @brief Load the SAC file, the samples are drawn from the buffer pool, so they should be released
+ *        by bufpool_free().
  *
  * @param filename
  * @param sh
@@ -42,42 +54,22 @@ static void   swap_order_4byte( void * );
  */
 int sac_file_load( const char *filename, struct SAChead *sh, float **seis )
 {
-	FILE  *fd;
-	float *_seis = NULL;
-	int    i;
-	int    result = -1;
-
-/* Open the sac file */
-	if ( (fd = fopen(filename, "rb")) == (FILE *)NULL ) {
-		fprintf(stderr, "Error opening %s\n", filename);
-		return -1;
-	}
-/* Read the sac header into a buffer */
-	if ( (i = read_sac_header(fd, sh)) < 0 )
-		goto end_process;
-/* Read the sac data into a buffer */
-	if ( (_seis = (float *)malloc((size_t)(sh->npts * sizeof(float)))) == (float *)NULL ) {
-		fprintf(stderr, "ERROR! Out of memory for %d float samples\n", sh->npts);
-		result = -2;
-		goto end_process;
-	}
-	if ( fread(_seis, sizeof(float), sh->npts, fd) != (size_t)sh->npts ) {
-		fprintf(stderr, "Error reading SAC data: %s\n", strerror(errno));
-		free(_seis);
-		goto end_process;
-	}
-
-/* */
-	if ( i == 1 )
-		for ( i = 0; i < sh->npts; i++ )
-			swap_order_4byte( _seis + i );
-/* */
-	*seis  = _seis;
-	result = sizeof(struct SAChead) + sh->npts * sizeof(float);
+	return load_sac_file( filename, sh, seis, NULL );
+}
 
-end_process:
-	fclose(fd);
-	return result;
+/**
+ * @brief Load the SAC file & build the run-length gap map of the undefined (SACUNDEF) samples
+ *        within the same pass of reading.
+ *
+ * @param filename
+ * @param sh
+ * @param seis
+ * @param map
+ * @return int
+ */
+int sac_file_load_gapmap( const char *filename, struct SAChead *sh, float **seis, SAC_GAP_MAP *map )
+{
+	return load_sac_file( filename, sh, seis, map );
 }
 
 /**
@@ -170,15 +162,35 @@ struct SAChead *sac_az_inc_modify( struct SAChead *sh, const float az, const flo
 	return sh;
 }
 
+/**
+ * @brief Modify the event name, it will be truncated to KEVNMLEN & blank padded like the other
+ *        string fields.
+ *
+ * @param sh
+ * @param name
+ * @return struct SAChead*
+ */
+struct SAChead *sac_kevnm_modify( struct SAChead *sh, const char *name )
+{
+	int len = strlen(name);
+
+/* */
+	len = len >= KEVNMLEN ? KEVNMLEN : len;
+	memcpy(sh->kevnm, name, len);
+	memset(sh->kevnm + len, ' ', KEVNMLEN - len);
+
+	return sh;
+}
+
 /**
  * @brief
  *
  * @param sh
  * @return const char*
  */
-const char *sac_scnl_print( struct SAChead *sh )
+const char *sac_scnl_print( const struct SAChead *sh )
 {
-	static char result[SAC_MAX_SCNL_LENGTH] = { 0 };
+	static __thread char result[SAC_MAX_SCNL_LENGTH] = { 0 };
 
 	char sta[K_LEN + 1]  = { 0 };
 	char chan[K_LEN + 1] = { 0 };
@@ -203,17 +215,290 @@ const char *sac_scnl_print( struct SAChead *sh )
 	return result;
 }
 
+/**
+ * @brief Pack the blank padded code of the SAC header into the zero padded slot of K_LEN bytes.
+ *
+ * @param slot
+ * @param code
+ */
+void sac_code_pack( char *slot, const char *code )
+{
+	int len = K_LEN;
+
+/* */
+	while ( len > 0 && (code[len - 1] == ' ' || code[len - 1] == '\0') )
+		len--;
+	memcpy(slot, code, len);
+	memset(slot + len, 0, K_LEN - len);
+
+	return;
+}
+
+/**
+ * @brief Pack the SCNL into the key of SAC_SCNL_KEY_LENGTH bytes, each code is zero padded to K_LEN.
+ *
+ * @param key
+ * @param sta
+ * @param chan
+ * @param net
+ * @param loc
+ */
+void sac_scnl_key_pack( char *key, const char *sta, const char *chan, const char *net, const char *loc )
+{
+	memset(key, 0, SAC_SCNL_KEY_LENGTH);
+	strncpy(key, sta, K_LEN);
+	strncpy(key + K_LEN, chan, K_LEN);
+	strncpy(key + K_LEN * 2, net, K_LEN);
+	strncpy(key + K_LEN * 3, loc, K_LEN);
+
+	return;
+}
+
+/**
+ * @brief Pack the SCNL of the SAC header into the key, the blank padded codes are packed directly.
+ *
+ * @param key
+ * @param sh
+ */
+void sac_scnl_key_fetch( char *key, const struct SAChead *sh )
+{
+	sac_code_pack( key, sh->kstnm );
+	sac_code_pack( key + K_LEN, sh->kcmpnm );
+	sac_code_pack( key + K_LEN * 2, sh->knetwk );
+	sac_code_pack( key + K_LEN * 3, sh->khole );
+
+	return;
+}
+
 /**
  * @brief
  *
  * @param sh
  * @return double
  */
-double sac_reftime_fetch( struct SAChead *sh )
+double sac_reftime_fetch( const struct SAChead *sh )
 {
 	return fetch_sac_time( sh );
 }
 
+/**
+ * @brief Set the reference time of the header, it will be rounded to millisecond.
+ *
+ * @param sh
+ * @param reftime
+ * @return struct SAChead*
+ */
+struct SAChead *sac_reftime_modify( struct SAChead *sh, const double reftime )
+{
+	time_t    sec  = (time_t)floor(reftime);
+	int       msec = (int)((reftime - sec) * 1000.0 + 0.5);
+	struct tm tms;
+
+/* */
+	if ( msec >= 1000 ) {
+		sec++;
+		msec -= 1000;
+	}
+	gmtime_r(&sec, &tms);
+	sh->nzyear = tms.tm_year + 1900;
+	sh->nzjday = tms.tm_yday + 1;
+	sh->nzhour = tms.tm_hour;
+	sh->nzmin  = tms.tm_min;
+	sh->nzsec  = tms.tm_sec;
+	sh->nzmsec = msec;
+
+	return sh;
+}
+
+/**
+ * @brief Parse the time in epoch seconds or YYYY-MM-DDThh:mm:ss.sss (UTC).
+ *
+ * @param timestr
+ * @return double
+ * @returns: the time in epoch seconds
+ *          -1.0 on invalid format
+ */
+double sac_time_parse( const char *timestr )
+{
+	struct tm tms;
+	double    sec;
+
+/* */
+	if ( strchr(timestr, 'T') ) {
+		memset(&tms, 0, sizeof(tms));
+		if (
+			sscanf(timestr, "%d-%d-%dT%d:%d:%lf", &tms.tm_year, &tms.tm_mon, &tms.tm_mday, &tms.tm_hour, &tms.tm_min, &sec) != 6
+		)
+			return -1.0;
+		tms.tm_year -= 1900;
+		tms.tm_mon  -= 1;
+		tms.tm_sec   = (int)sec;
+
+		return (double)timegm(&tms) + (sec - (int)sec);
+	}
+
+	return atof(timestr) > 0.0 ? atof(timestr) : -1.0;
+}
+
+/**
+ * @brief Read the header of the opened SAC file by pread(), the file offset won't be changed.
+ *
+ * @param fd
+ * @param sh
+ * @return int
+ * @returns: 0 on success
+ *          1 on success and if byte swapping is needed
+ *          2 on success and it is the compressed container
+ *         -1 on error reading file
+ */
+int sac_header_pread( const int fd, struct SAChead *sh )
+{
+	struct stat st;
+
+/* */
+	if ( fstat(fd, &st) ) {
+		fprintf(stderr, "Error reading SAC file: %s!\n", strerror(errno));
+		return -1;
+	}
+	if ( pread(fd, sh, sizeof(struct SAChead), 0) != (ssize_t)sizeof(struct SAChead) ) {
+		fprintf(stderr, "Error reading SAC file: %s!\n", strerror(errno));
+		return -1;
+	}
+
+	return check_sac_header( fd, sh, S_ISREG(st.st_mode) ? (long)st.st_size : -1 );
+}
+
+/**
+ * @brief Write back only the header of the opened SAC file by pwrite(), it will be swapped to the
+ *        original byte order of the file if needed, the data won't be touched. The header of the
+ *        compressed container is always in the native order.
+ *
+ * @param fd
+ * @param swap
+ * @param sh
+ * @return int
+ * @returns: 0 on success
+ *          -1 on error writing file
+ */
+int sac_header_pwrite( const int fd, const int swap, const struct SAChead *sh )
+{
+	struct SAChead osh = *sh;
+
+/* */
+	if ( swap == SAC_FILE_SWAPPED )
+		swap_sac_header( &osh );
+	if ( pwrite(fd, &osh, sizeof(struct SAChead), 0) != (ssize_t)sizeof(struct SAChead) ) {
+		fprintf(stderr, "Error writing SAC header: %s!\n", strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Read only the range of samples [start, start + nsamp) of the opened SAC file by pread(),
+ *        the byte swapping will be done in place. Only the frames covering the range will be decoded
+ *        for the compressed container.
+ *
+ * @param fd
+ * @param swap
+ * @param buffer
+ * @param start
+ * @param nsamp
+ * @return int
+ * @returns: number of samples read
+ *          -1 on error reading file
+ */
+int sac_data_pread( const int fd, const int swap, float *buffer, const int start, const int nsamp )
+{
+	const size_t size   = (size_t)nsamp * sizeof(float);
+	off_t        offset = sizeof(struct SAChead) + (off_t)start * sizeof(float);
+	size_t       done   = 0;
+	ssize_t      nread;
+
+/* */
+	if ( swap == SAC_FILE_COMPRESSED )
+		return sacz_data_pread( fd, buffer, start, nsamp );
+/* The ranged read might be partial, so keep reading */
+	while ( done < size ) {
+		if ( (nread = pread(fd, (uint8_t *)buffer + done, size - done, offset + done)) <= 0 ) {
+			fprintf(stderr, "Error reading SAC data: %s\n", nread ? strerror(errno) : "unexpected end of file");
+			return -1;
+		}
+		done += nread;
+	}
+	if ( swap == SAC_FILE_SWAPPED )
+		for ( int i = 0; i < nsamp; i++ )
+			swap_order_4byte( buffer + i );
+
+	return nsamp;
+}
+
+/**
+ * @brief Write the header & the samples to the opened file (or pipe) by writev(), so the result
+ *        can be output straight from the loaded buffer without copying into the staging one. The
+ *        header & the samples should be in the native order.
+ *
+ * @param fd
+ * @param sh
+ * @param seis
+ * @return int
+ * @returns: 0 on success
+ *          -1 on error writing file
+ */
+int sac_file_writev( const int fd, const struct SAChead *sh, const float *seis )
+{
+	struct iovec iov[2] = {
+		{ (void *)sh, sizeof(struct SAChead) },
+		{ (void *)seis, (size_t)sh->npts * sizeof(float) }
+	};
+	struct iovec *piov  = iov;
+	int           niov  = 2;
+	ssize_t       nwrite;
+
+/* The write to the pipe might be partial, so keep writing the remained part */
+	while ( niov ) {
+		if ( (nwrite = writev(fd, piov, niov)) < 0 ) {
+			if ( errno == EINTR )
+				continue;
+			fprintf(stderr, "Error writing SAC file: %s\n", strerror(errno));
+			return -1;
+		}
+		while ( niov && (size_t)nwrite >= piov->iov_len ) {
+			nwrite -= piov->iov_len;
+			piov++;
+			niov--;
+		}
+		if ( niov ) {
+			piov->iov_base  = (uint8_t *)piov->iov_base + nwrite;
+			piov->iov_len  -= nwrite;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Check if the two paths are the same existing file by the device & inode numbers, so the
+ *        tools can refuse to overwrite the input file by the output.
+ *
+ * @param path_a
+ * @param path_b
+ * @return int
+ * @returns: 1 if they are the same file
+ *           0 if they are different or any of them doesn't exist
+ */
+int sac_file_same( const char *path_a, const char *path_b )
+{
+	struct stat st_a, st_b;
+
+/* */
+	if ( stat(path_a, &st_a) || stat(path_b, &st_b) )
+		return 0;
+
+	return st_a.st_dev == st_b.st_dev && st_a.st_ino == st_b.st_ino;
+}
+
 /**
  * @brief
  *
@@ -224,16 +509,423 @@ double sac_reftime_fetch( struct SAChead *sh )
  */
 float *sac_data_preprocess( struct SAChead *sh, float *seis, const float gain_fac )
 {
-	applygain_sac_data( seis, sh->npts, gain_fac );
-	dmean_sac_data( seis, sh->npts, 1.0 / sh->delta );
+	SAC_GAP_MAP map = { 0 };
+
+/* Only one scan for the undefined samples, then all the kernels work on the spans */
+	if ( sac_gapmap_build( seis, sh->npts, &map ) < 0 )
+		return NULL;
+	sac_data_preprocess_gapmap( sh, seis, gain_fac, &map );
+	sac_gapmap_free( &map );
+
+	return seis;
+}
+
+/**
+ * @brief Preprocess the seismic data with the prebuilt gap map, the gap spans will be skipped
+ *        by the gain & demean kernels then filled by block operations.
+ *
+ * @param sh
+ * @param seis
+ * @param gain_fac
+ * @param map
+ * @return float*
+ */
+float *sac_data_preprocess_gapmap( struct SAChead *sh, float *seis, const float gain_fac, const SAC_GAP_MAP *map )
+{
+	applygain_sac_data( seis, sh->npts, gain_fac, map );
+	dmean_sac_data( seis, sh->npts, 1.0 / sh->delta, map );
 	fprintf(
 		stderr, "Found %d gaps within total %d samples in %s, filled with 0.0!\n",
-		fillgap_sac_data( seis, sh->npts, 0.0 ), sh->npts, sac_scnl_print( sh )
+		fillgap_sac_data( seis, sh->npts, 0.0, map ), sh->npts, sac_scnl_print( sh )
 	);
 
 	return seis;
 }
 
+/**
+ * @brief Build the run-length gap map of the undefined (SACUNDEF) samples.
+ *
+ * @param seis
+ * @param npts
+ * @param map
+ * @return int
+ * @returns: number of the gap runs on success
+ *          -2 on out of memory
+ */
+int sac_gapmap_build( const float *seis, const int npts, SAC_GAP_MAP *map )
+{
+	int start = -1;
+
+/* */
+	map->count = map->total = 0;
+	for ( int i = 0; i < npts; i++ ) {
+		if ( seis[i] == SACUNDEF ) {
+			if ( start < 0 )
+				start = i;
+		}
+		else if ( start >= 0 ) {
+			if ( append_gap_run( map, start, i - start ) )
+				return -2;
+			start = -1;
+		}
+	}
+	if ( start >= 0 && append_gap_run( map, start, npts - start ) )
+		return -2;
+
+	return map->count;
+}
+
+/**
+ * @brief
+ *
+ * @param map
+ */
+void sac_gapmap_free( SAC_GAP_MAP *map )
+{
+	free(map->gaps);
+	map->gaps     = NULL;
+	map->count    = 0;
+	map->capacity = 0;
+	map->total    = 0;
+
+	return;
+}
+
+/**
+ * @brief Report the gap map as the data availability, each gap is one line with the absolute
+ *        start & end time of the gap and the last line is the summary.
+ *
+ * @param fp
+ * @param sh
+ * @param map
+ * @return double
+ * @returns: the data availability in percentage
+ */
+double sac_gapmap_report( FILE *fp, struct SAChead *sh, const SAC_GAP_MAP *map )
+{
+	const double starttime = sac_reftime_fetch( sh ) + sh->b;
+	const char  *scnl      = sac_scnl_print( sh );
+	double       result    = sh->npts > 0 ? 100.0 * (sh->npts - map->total) / sh->npts : 0.0;
+
+/* */
+	fprintf(fp, "#SCNL GapStart GapEnd Samples\n");
+	for ( int i = 0; i < map->count; i++ ) {
+		fprintf(
+			fp, "%s %.3f %.3f %d\n", scnl,
+			starttime + map->gaps[i].start * sh->delta,
+			starttime + (map->gaps[i].start + map->gaps[i].length) * sh->delta,
+			map->gaps[i].length
+		);
+	}
+	fprintf(
+		fp, "#%s start at %.3f, total %d gaps with %d samples within %d samples, availability is %.3f%%\n",
+		scnl, starttime, map->count, map->total, sh->npts, result
+	);
+
+	return result;
+}
+
+/**
+ * @brief Open the SAC file & read the header, the samples will be read by sac_stream_read().
+ *
+ * @param filename
+ * @param sh
+ * @param stream
+ * @return int
+ * @returns: 0 on success
+ *          -1 on error opening or reading file
+ */
+int sac_stream_open( const char *filename, struct SAChead *sh, SAC_STREAM *stream )
+{
+	int swap;
+
+/* Open the sac file */
+	if ( (stream->fp = open_sac_file( filename )) == (FILE *)NULL )
+		return -1;
+/* Read the sac header into a buffer */
+	if ( (swap = read_sac_header(stream->fp, sh)) < 0 ) {
+		close_sac_file( stream->fp );
+		stream->fp = NULL;
+		return -1;
+	}
+/* */
+	stream->swap    = swap;
+	stream->remain  = sh->npts;
+	stream->zreader = NULL;
+	if ( swap == SAC_FILE_COMPRESSED ) {
+		if ( (stream->zreader = (SACZ_READER *)malloc(sizeof(SACZ_READER))) == NULL ) {
+			fprintf(stderr, "ERROR! Out of memory for the compressed reader!\n");
+			sac_stream_close( stream );
+			return -1;
+		}
+		if ( sacz_reader_open( stream->zreader, fileno(stream->fp) ) ) {
+			free(stream->zreader);
+			stream->zreader = NULL;
+			sac_stream_close( stream );
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Read the next block of samples from the stream.
+ *
+ * @param stream
+ * @param buffer
+ * @param nsamp
+ * @return int
+ * @returns: number of samples read, 0 at the end of the data
+ *          -1 on error reading file
+ */
+int sac_stream_read( SAC_STREAM *stream, float *buffer, const int nsamp )
+{
+	int result = nsamp < stream->remain ? nsamp : stream->remain;
+
+/* */
+	if ( result <= 0 )
+		return 0;
+	if ( stream->zreader ) {
+		if ( sacz_reader_read( stream->zreader, buffer, stream->zreader->npts - stream->remain, result ) != result )
+			return -1;
+	}
+	else if ( fread(buffer, sizeof(float), result, stream->fp) != (size_t)result ) {
+		fprintf(stderr, "Error reading SAC data: %s\n", ferror(stream->fp) ? strerror(errno) : "unexpected end of file");
+		return -1;
+	}
+	if ( stream->swap == SAC_FILE_SWAPPED )
+		for ( int i = 0; i < result; i++ )
+			swap_order_4byte( buffer + i );
+	stream->remain -= result;
+
+	return result;
+}
+
+/**
+ * @brief Rewind the stream back to the first sample.
+ *
+ * @param stream
+ * @param sh
+ * @return int
+ * @returns: 0 on success
+ *          -1 on error seeking file
+ */
+int sac_stream_rewind( SAC_STREAM *stream, const struct SAChead *sh )
+{
+/* The compressed reader locates the frames by the remained samples, no seeking is needed */
+	if ( !stream->zreader && fseek(stream->fp, sizeof(struct SAChead), SEEK_SET) ) {
+		fprintf(stderr, "Error rewinding SAC data: %s\n", strerror(errno));
+		return -1;
+	}
+	stream->remain = sh->npts;
+
+	return 0;
+}
+
+/**
+ * @brief Scan the head of the stream for the mean which will be removed by the preprocessing, it
+ *        is exactly the same one as sac_data_preprocess() takes. The stream will be rewound after
+ *        the scanning, so the samples can be processed block by block with sac_block_preprocess().
+ *
+ * @param stream
+ * @param sh
+ * @param gain_fac
+ * @param mean
+ * @return int
+ * @returns: 0 on success
+ *          -1 on error reading file
+ */
+int sac_stream_mean_scan( SAC_STREAM *stream, const struct SAChead *sh, const float gain_fac, float *mean )
+{
+	const int i_head = dmean_head_length( sh->npts, 1.0 / sh->delta );
+
+	float buffer[SAC_STREAM_SCAN_BLOCK];
+	float _mean      = 0.0;
+	int   mean_count = 0;
+	int   nread;
+
+/* Same order of the summation as dmean_sac_data(), so the result is bit-identical */
+	for ( int i = 0; i < i_head; i += nread ) {
+		nread = i_head - i < SAC_STREAM_SCAN_BLOCK ? i_head - i : SAC_STREAM_SCAN_BLOCK;
+		if ( (nread = sac_stream_read( stream, buffer, nread )) <= 0 )
+			return -1;
+		for ( int j = 0; j < nread; j++ ) {
+			if ( buffer[j] != SACUNDEF ) {
+				buffer[j] *= gain_fac;
+				_mean     += buffer[j];
+				mean_count++;
+			}
+		}
+	}
+	if ( mean_count )
+		_mean /= mean_count;
+	*mean = _mean;
+
+	return sac_stream_rewind( stream, sh );
+}
+
+/**
+ * @brief Preprocess one block of the stream with the mean from sac_stream_mean_scan(), the gain
+ *        is applied & the mean is removed, the undefined samples are filled with 0.0.
+ *
+ * @param block
+ * @param nsamp
+ * @param gain_fac
+ * @param mean
+ * @return int
+ * @returns: number of the filled undefined samples
+ */
+int sac_block_preprocess( float *block, const int nsamp, const float gain_fac, const float mean )
+{
+	int result = 0;
+
+/* */
+	for ( int i = 0; i < nsamp; i++ ) {
+		if ( block[i] == SACUNDEF ) {
+			block[i] = 0.0;
+			result++;
+		}
+		else {
+			block[i] *= gain_fac;
+			block[i] -= mean;
+		}
+	}
+
+	return result;
+}
+
+/**
+ * @brief
+ *
+ * @param stream
+ */
+void sac_stream_close( SAC_STREAM *stream )
+{
+	if ( stream->zreader ) {
+		sacz_reader_close( stream->zreader );
+		free(stream->zreader);
+	}
+	if ( stream->fp )
+		close_sac_file( stream->fp );
+	stream->fp      = NULL;
+	stream->zreader = NULL;
+	stream->remain  = 0;
+
+	return;
+}
+
+/**
+ * @brief Load the SAC file, the gap map will be built within the byte swapping pass if it is
+ *        required.
+ *
+ * @param filename
+ * @param sh
+ * @param seis
+ * @param map
+ * @return int
+ */
+static int load_sac_file( const char *filename, struct SAChead *sh, float **seis, SAC_GAP_MAP *map )
+{
+	FILE  *fd;
+	float *_seis = NULL;
+	int    i;
+	int    start;
+	int    result = -1;
+
+/* Open the sac file */
+	if ( (fd = open_sac_file( filename )) == (FILE *)NULL )
+		return -1;
+/* Read the sac header into a buffer */
+	if ( (i = read_sac_header(fd, sh)) < 0 )
+		goto end_process;
+/* Read the sac data into a buffer */
+	if ( (_seis = (float *)bufpool_alloc((size_t)sh->npts * sizeof(float))) == (float *)NULL ) {
+		fprintf(stderr, "ERROR! Out of memory for %d float samples\n", sh->npts);
+		result = -2;
+		goto end_process;
+	}
+	if ( i == SAC_FILE_COMPRESSED ) {
+		if ( sacz_data_pread( fileno(fd), _seis, 0, sh->npts ) != sh->npts ) {
+			bufpool_free( _seis );
+			goto end_process;
+		}
+	}
+	else if ( fread(_seis, sizeof(float), sh->npts, fd) != (size_t)sh->npts ) {
+		fprintf(stderr, "Error reading SAC data: %s\n", ferror(fd) ? strerror(errno) : "unexpected end of file");
+		bufpool_free( _seis );
+		goto end_process;
+	}
+
+/* */
+	if ( map ) {
+		map->count = map->total = 0;
+		start      = -1;
+		for ( int j = 0; j < sh->npts; j++ ) {
+			if ( i == SAC_FILE_SWAPPED )
+				swap_order_4byte( _seis + j );
+			if ( _seis[j] == SACUNDEF ) {
+				if ( start < 0 )
+					start = j;
+			}
+			else if ( start >= 0 ) {
+				if ( append_gap_run( map, start, j - start ) )
+					goto out_of_memory;
+				start = -1;
+			}
+		}
+		if ( start >= 0 && append_gap_run( map, start, sh->npts - start ) )
+			goto out_of_memory;
+	}
+	else if ( i == SAC_FILE_SWAPPED ) {
+		for ( i = 0; i < sh->npts; i++ )
+			swap_order_4byte( _seis + i );
+	}
+/* */
+	*seis  = _seis;
+	result = sizeof(struct SAChead) + sh->npts * sizeof(float);
+	goto end_process;
+
+out_of_memory:
+	bufpool_free( _seis );
+	result = -2;
+end_process:
+	close_sac_file( fd );
+	return result;
+}
+
+/**
+ * @brief Open the SAC file for reading, the "-" is the standard input.
+ *
+ * @param filename
+ * @return FILE*
+ */
+static FILE *open_sac_file( const char *filename )
+{
+	FILE *result;
+
+/* */
+	if ( !strcmp(filename, "-") )
+		return stdin;
+	if ( (result = fopen(filename, "rb")) == (FILE *)NULL )
+		fprintf(stderr, "Error opening %s\n", filename);
+
+	return result;
+}
+
+/**
+ * @brief
+ *
+ * @param fp
+ */
+static void close_sac_file( FILE *fp )
+{
+	if ( fp != stdin )
+		fclose(fp);
+
+	return;
+}
+
 /**
  * @brief Read the header portion of a SAC file into memory.
  *
@@ -242,42 +934,107 @@ float *sac_data_preprocess( struct SAChead *sh, float *seis, const float gain_fa
  * @return int
  * @returns: 0 on success
  *          1 on success and if byte swapping is needed
+ *          2 on success and it is the compressed container
  *         -1 on error reading file
  */
 static int read_sac_header( FILE *fp, struct SAChead *psh )
 {
-	int filesize;
-	int result = 0;
-	struct SAChead2 *psh2;
-
-/* Obtain file size */
-	fseek(fp, 0, SEEK_END);
-	filesize = ftell(fp);
-	rewind(fp);
+	struct stat st;
+	long        filesize = -1;
 
+/* Only the regular file opened by name has the size to check, the standard input might be a pipe */
+	if ( fp != stdin && !fstat(fileno(fp), &st) && S_ISREG(st.st_mode) )
+		filesize = (long)st.st_size;
 /* */
-	psh2 = (struct SAChead2 *)psh;
 	if ( fread(psh, sizeof(struct SAChead2), 1, fp) != 1 ) {
-		fprintf(stderr, "Error reading SAC file: %s!\n", strerror(errno));
+		fprintf(stderr, "Error reading SAC file: %s!\n", ferror(fp) ? strerror(errno) : "unexpected end of file");
 		return -1;
 	}
+
+	return check_sac_header( fileno(fp), psh, filesize );
+}
+
+/**
+ * @brief Check the header & do the byte swapping of the header if needed. The byte order is
+ *        determined by the content of the header, so it also works without the file size (e.g. a
+ *        pipe), the file size is only used for the validation & the legacy header. The compressed
+ *        container is recognized by its own header after the SAC header.
+ *
+ * @param fd
+ * @param psh
+ * @param filesize The size of the file, -1 if it is unknown
+ * @return int
+ * @returns: 0 on success
+ *          1 on success and if byte swapping is needed
+ *          2 on success and it is the compressed container
+ *         -1 on the byte order can't be determined or the file size is not matched
+ */
+static int check_sac_header( const int fd, struct SAChead *psh, const long filesize )
+{
+	int result = SAC_FILE_NATIVE;
+
 /* */
-	if ( filesize != (sizeof(struct SAChead) + (psh->npts * sizeof(float))) ) {
-		result = 1;
-		fprintf(stderr, "WARNING: Swapping is needed! (filesize %d, psh.npts %d)\n", filesize, psh->npts);
-		for ( int i = 0; i < NUM_FLOAT; i++ )
-			swap_order_4byte( psh2->SACfloat + i );
-		for ( int i = 0; i < MAXINT; i++ )
-			swap_order_4byte( psh2->SACint + i );
-		if ( filesize != (sizeof(struct SAChead) + (psh->npts * sizeof(float))) ) {
-			fprintf(stderr, "ERROR: Swapping is needed again! (filesize %d, psh.npts %d)\n", filesize, psh->npts);
-			result = -1;
+	if ( !valid_sac_header( psh ) ) {
+		swap_sac_header( psh );
+		if ( valid_sac_header( psh ) ) {
+			result = SAC_FILE_SWAPPED;
+		}
+		else {
+		/* Neither of the orders looks like the header, fall back to the file size */
+			swap_sac_header( psh );
+			if ( filesize < 0 ) {
+				fprintf(stderr, "ERROR: Can't determine the byte order of the SAC header!\n");
+				return -1;
+			}
+			if ( filesize != (long)(sizeof(struct SAChead) + (psh->npts * sizeof(float))) ) {
+				swap_sac_header( psh );
+				result = SAC_FILE_SWAPPED;
+			}
 		}
 	}
+/* The compressed container always keeps the native header */
+	if ( filesize >= 0 && filesize != (long)(sizeof(struct SAChead) + (psh->npts * sizeof(float))) ) {
+		if ( result == SAC_FILE_NATIVE && sacz_file_check( fd, psh ) )
+			return SAC_FILE_COMPRESSED;
+		fprintf(stderr, "ERROR: The file size is not matched! (filesize %ld, psh.npts %d)\n", filesize, psh->npts);
+		return -1;
+	}
+	if ( result == SAC_FILE_SWAPPED )
+		fprintf(stderr, "WARNING: Swapping is needed! (psh.npts %d)\n", psh->npts);
 
 	return result;
 }
 
+/**
+ * @brief The header of the version 6 with the sane number of samples & sampling interval, the
+ *        version (nvhdr) is the internal4 of the header.
+ *
+ * @param sh
+ * @return int
+ */
+static int valid_sac_header( const struct SAChead *sh )
+{
+	return sh->internal4 == SACVERSION && sh->npts >= 0 && isfinite(sh->delta) && sh->delta > 0.0;
+}
+
+/**
+ * @brief
+ *
+ * @param sh
+ */
+static void swap_sac_header( struct SAChead *sh )
+{
+	struct SAChead2 *sh2 = (struct SAChead2 *)sh;
+
+/* */
+	for ( int i = 0; i < NUM_FLOAT; i++ )
+		swap_order_4byte( sh2->SACfloat + i );
+	for ( int i = 0; i < MAXINT; i++ )
+		swap_order_4byte( sh2->SACint + i );
+
+	return;
+}
+
 /**
  * @brief
  *
@@ -308,14 +1065,21 @@ static double fetch_sac_time( const struct SAChead *sh )
  * @param input
  * @param npts
  * @param gain
+ * @param map
  * @return float
  */
-static float applygain_sac_data( float *input, const int npts, const float gain )
+static float applygain_sac_data( float *input, const int npts, const float gain, const SAC_GAP_MAP *map )
 {
-/* */
-	for ( int i = 0; i < npts; i++ ) {
-		if ( input[i] != SACUNDEF )
+	int from = 0;
+
+/* Only the spans between gaps */
+	for ( int g = 0; g <= map->count; g++ ) {
+		const int to = g < map->count ? map->gaps[g].start : npts;
+
+		for ( int i = from; i < to; i++ )
 			input[i] *= gain;
+		if ( g < map->count )
+			from = to + map->gaps[g].length;
 	}
 
 	return gain;
@@ -327,54 +1091,116 @@ static float applygain_sac_data( float *input, const int npts, const float gain
  * @param input
  * @param npts
  * @param samprate
+ * @param map
  * @return float
  */
-static float dmean_sac_data( float *input, const int npts, const float samprate )
+static float dmean_sac_data( float *input, const int npts, const float samprate, const SAC_GAP_MAP *map )
 {
 	int   i_head;
+	int   from;
 	int   mean_count = 0;
 	float mean = 0.0;
 
 /* */
-	i_head = (int)(npts * 0.1);
-	i_head = i_head >= (int)samprate ? i_head : npts;
-	for ( int i = 0; i < i_head; i++ ) {
-		if ( input[i] != SACUNDEF ) {
+	i_head = dmean_head_length( npts, samprate );
+	from   = 0;
+	for ( int g = 0; g <= map->count && from < i_head; g++ ) {
+		int to = g < map->count ? map->gaps[g].start : npts;
+
+		to = to < i_head ? to : i_head;
+		for ( int i = from; i < to; i++ )
 			mean += input[i];
-			mean_count++;
-		}
+		mean_count += to - from;
+		if ( g < map->count )
+			from = map->gaps[g].start + map->gaps[g].length;
 	}
-	mean /= mean_count;
+	if ( mean_count )
+		mean /= mean_count;
 /* */
-	for ( int i = 0; i < npts; i++ ) {
-		if ( input[i] != SACUNDEF )
+	from = 0;
+	for ( int g = 0; g <= map->count; g++ ) {
+		const int to = g < map->count ? map->gaps[g].start : npts;
+
+		for ( int i = from; i < to; i++ )
 			input[i] -= mean;
+		if ( g < map->count )
+			from = to + map->gaps[g].length;
 	}
 
 	return mean;
 }
 
+/**
+ * @brief The mean is taken from the first 10 percent of the samples, or all of them if it is
+ *        shorter than one second.
+ *
+ * @param npts
+ * @param samprate
+ * @return int
+ */
+static int dmean_head_length( const int npts, const float samprate )
+{
+	const int result = (int)(npts * 0.1);
+
+	return result >= (int)samprate ? result : npts;
+}
+
 /**
  * @brief
  *
  * @param input
  * @param npts
  * @param fill
+ * @param map
  * @return int
  */
-static int fillgap_sac_data( float *input, const int npts, const float fill )
+static int fillgap_sac_data( float *input, const int npts, const float fill, const SAC_GAP_MAP *map )
 {
-	int gap_count = 0;
+/* Fill the whole span by block, zero can be done by memset directly */
+	for ( int g = 0; g < map->count; g++ ) {
+		float *gap = input + map->gaps[g].start;
+
+		if ( fill == 0.0 ) {
+			memset(gap, 0, map->gaps[g].length * sizeof(float));
+		}
+		else {
+			for ( int i = 0; i < map->gaps[g].length; i++ )
+				gap[i] = fill;
+		}
+	}
+
+	return map->total;
+}
+
+/**
+ * @brief Append one gap run to the gap map, the runs are always appended in order.
+ *
+ * @param map
+ * @param start
+ * @param length
+ * @return int
+ */
+static int append_gap_run( SAC_GAP_MAP *map, const int start, const int length )
+{
+	SAC_GAP *gaps;
 
 /* */
-	for ( int i = 0; i < npts; i++ ) {
-		if ( input[i] == SACUNDEF ) {
-			input[i] = fill;
-			gap_count++;
+	if ( map->count >= map->capacity ) {
+		const int capacity = map->capacity ? map->capacity << 1 : 16;
+
+		if ( (gaps = (SAC_GAP *)realloc(map->gaps, capacity * sizeof(SAC_GAP))) == NULL ) {
+			fprintf(stderr, "ERROR! Out of memory for %d gap runs\n", capacity);
+			return -1;
 		}
+		map->gaps     = gaps;
+		map->capacity = capacity;
 	}
+	map->gaps[map->count].start  = start;
+	map->gaps[map->count].length = length;
+	map->count++;
+	map->total += length;
 
-	return gap_count;
+	return 0;
 }
 
 /**
@@ -0,0 +1,299 @@
+/**
+ * @file sac_bundle.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+/* */
+#include <sachead.h>
+#include <sac.h>
+#include <sacbundle.h>
+#include <batch.h>
+
+/* */
+#define PROG_NAME       "sac_bundle"
+#define VERSION         "1.0.0 - 2026-10-18"
+#define AUTHOR          "Benjamin Ming Yang"
+/* */
+#define BUNDLE_MODE_PACK    0
+#define BUNDLE_MODE_UNPACK  1
+#define BUNDLE_MODE_LIST    2
+
+/* */
+static int  proc_argv( int , char * [] );
+static void usage( void );
+static int  pack_bundle( void );
+static int  unpack_bundle( void );
+static int  list_bundle( void );
+static void load_job_func( void *, const int );
+/* */
+static char **InputFiles = NULL;
+static int    NumInputs  = 0;
+static int    NumThreads = 0;
+static char  *OutputPath = NULL;
+static int    Mode       = BUNDLE_MODE_PACK;
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main( int argc, char **argv )
+{
+/* Check command line arguments */
+	if ( proc_argv( argc, argv ) ) {
+		usage();
+		return -1;
+	}
+/* */
+	switch ( Mode ) {
+	case BUNDLE_MODE_UNPACK:
+		return unpack_bundle();
+	case BUNDLE_MODE_LIST:
+		return list_bundle();
+	default:
+		return pack_bundle();
+	}
+}
+
+/**
+ * @brief Load all the input files in parallel, then write them into one bundle.
+ *
+ * @return int
+ */
+static int pack_bundle( void )
+{
+	SACB_TRACE     *traces  = NULL;
+	struct SAChead *headers = NULL;
+	long            size;
+	int             result  = -1;
+
+/* */
+	if (
+		(traces = (SACB_TRACE *)calloc(NumInputs, sizeof(SACB_TRACE))) == NULL ||
+		(headers = (struct SAChead *)calloc(NumInputs, sizeof(struct SAChead))) == NULL
+	) {
+		fprintf(stderr, "ERROR! Out of memory for %d input files\n", NumInputs);
+		result = -2;
+		goto end_process;
+	}
+	for ( int i = 0; i < NumInputs; i++ )
+		traces[i].sh = headers + i;
+	batch_jobs_run( NumInputs, NumThreads, load_job_func, traces );
+	for ( int i = 0; i < NumInputs; i++ )
+		if ( !traces[i].seis )
+			goto end_process;
+/* */
+	if ( (size = sacbundle_write( OutputPath, traces, NumInputs )) < 0 ) {
+		result = size;
+		goto end_process;
+	}
+	fprintf(stderr, "Packed %d SAC files into %s, %ld bytes!\n", NumInputs, OutputPath, size);
+	result = 0;
+
+end_process:
+	if ( traces )
+		for ( int i = 0; i < NumInputs; i++ )
+			bufpool_free( traces[i].seis );
+	free(traces);
+	free(headers);
+
+	return result;
+}
+
+/**
+ * @brief The job function of each input file, it will be called by the batch threads.
+ *
+ * @param arg
+ * @param index
+ */
+static void load_job_func( void *arg, const int index )
+{
+	SACB_TRACE *trace = (SACB_TRACE *)arg + index;
+
+/* */
+	if ( sac_file_load( InputFiles[index], trace->sh, &trace->seis ) < 0 ) {
+		fprintf(stderr, "Error loading SAC file: %s!\n", InputFiles[index]);
+		trace->seis = NULL;
+	}
+
+	return;
+}
+
+/**
+ * @brief Write each trace of the bundle back to the plain SAC file named by its SCNL.
+ *
+ * @return int
+ */
+static int unpack_bundle( void )
+{
+	FILE      *fp;
+	SAC_BUNDLE bundle;
+	char       path[SAC_MAX_PATH_LENGTH];
+	int        result = -1;
+
+/* */
+	if ( (result = sacbundle_open( InputFiles[0], &bundle )) < 0 )
+		return result;
+	for ( int i = 0; i < bundle.count; i++ ) {
+		const SACB_TRACE *trace = bundle.traces + i;
+
+		snprintf(path, sizeof(path), "%s/%s", OutputPath ? OutputPath : ".", sac_scnl_print( trace->sh ));
+		if ( (fp = fopen(path, "wb")) == (FILE *)NULL ) {
+			fprintf(stderr, "ERROR!! Can't open %s for output!\n", path);
+			result = -1;
+			goto end_process;
+		}
+		if (
+			fwrite(trace->sh, 1, sizeof(struct SAChead), fp) != sizeof(struct SAChead) ||
+			fwrite(trace->seis, sizeof(float), trace->sh->npts, fp) != (size_t)trace->sh->npts
+		) {
+			fprintf(stderr, "Error writing SAC file: %s\n", strerror(errno));
+			fclose(fp);
+			remove(path);
+			result = -1;
+			goto end_process;
+		}
+		fclose(fp);
+	}
+	fprintf(stderr, "Unpacked %d SAC files from %s!\n", bundle.count, InputFiles[0]);
+	result = 0;
+
+end_process:
+	sacbundle_close( &bundle );
+	return result;
+}
+
+/**
+ * @brief
+ *
+ * @return int
+ */
+static int list_bundle( void )
+{
+	SAC_BUNDLE bundle;
+	int        result;
+
+/* */
+	if ( (result = sacbundle_open( InputFiles[0], &bundle )) < 0 )
+		return result;
+	for ( int i = 0; i < bundle.count; i++ ) {
+		const struct SAChead *sh = bundle.traces[i].sh;
+
+		fprintf(
+			stdout, "%s\t%d\t%g\t%.3f\t%lu\n",
+			sac_scnl_print( sh ), sh->npts, sh->delta, sac_reftime_fetch( sh ) + sh->b,
+			(unsigned long)bundle.entries[i].offset
+		);
+	}
+	sacbundle_close( &bundle );
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+static int proc_argv( int argc, char *argv[] )
+{
+	for ( int i = 1; i < argc; i++ ) {
+		if ( !strcmp(argv[i], "-v") ) {
+			fprintf(stdout, "%s\n", PROG_NAME);
+			fprintf(stdout, "Version: %s\n", VERSION);
+			fprintf(stdout, "Author:  %s\n", AUTHOR);
+			fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-h") ) {
+			usage();
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-x") ) {
+			Mode = BUNDLE_MODE_UNPACK;
+		}
+		else if ( !strcmp(argv[i], "-l") ) {
+			Mode = BUNDLE_MODE_LIST;
+		}
+		else if ( !strcmp(argv[i], "-o") && i < argc - 1 ) {
+			OutputPath = argv[++i];
+		}
+		else if ( !strcmp(argv[i], "-t") && i < argc - 1 ) {
+			NumThreads = atoi(argv[++i]);
+		}
+		else if ( argv[i][0] == '-' ) {
+			fprintf(stderr, "Unknown option: %s\n\n", argv[i]);
+			return -1;
+		}
+		else {
+		/* All the remained arguments are input files */
+			InputFiles = argv + i;
+			NumInputs  = argc - i;
+			break;
+		}
+	}
+/* */
+	if ( !NumInputs ) {
+		fprintf(stderr, "No input file was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+	if ( Mode == BUNDLE_MODE_PACK && !OutputPath ) {
+		fprintf(stderr, "No output bundle was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+	if ( Mode != BUNDLE_MODE_PACK && NumInputs > 1 ) {
+		fprintf(stderr, "Only one bundle can be unpacked or listed at once; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ */
+static void usage( void )
+{
+	fprintf(stdout, "\n%s\n", PROG_NAME);
+	fprintf(stdout, "Version: %s\n", VERSION);
+	fprintf(stdout, "Author:  %s\n", AUTHOR);
+	fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+	fprintf(stdout, "***************************\n");
+	fprintf(stdout, "Usage: %s -o <output bundle> [options] <input SAC files...>\n", PROG_NAME);
+	fprintf(stdout, "       %s -x [-o output_dir] <input bundle>\n", PROG_NAME);
+	fprintf(stdout, "       %s -l <input bundle>\n\n", PROG_NAME);
+	fprintf(stdout,
+		"*** Options ***\n"
+		" -v             Report program version\n"
+		" -h             Show this usage message\n"
+		" -o output      Specify the output bundle, or the output directory of unpacking, default is\n"
+		"                current directory\n"
+		" -x             Unpack the bundle into the SAC files named as sta.chan.net.loc\n"
+		" -l             List the traces of the bundle: SCNL, npts, delta, start time & offset\n"
+		" -t threads     Specify the number of threads, default is the number of processors\n"
+		"\n"
+		"This program will pack the SAC files of one event into a single bundle, the headers are stored\n"
+		"as a directory up front & the samples are page aligned, so the whole event can be mapped at once\n"
+		"& each trace is indexed by its SCNL.\n"
+		"\n"
+	);
+
+	return;
+}
@@ -24,9 +24,11 @@
 /* */
 #define MAX_TOLERANCE_GAP_SEC     86400
 #define MAX_TOLERANCE_DELTA_DIFF  1.0E-6
+#define GAP_BLOCK_SAMPLES         4096
 /* */
 static int  proc_argv( int , char * [] );
 static void usage( void );
+static int  write_gap_samples( FILE *, long );
 /* */
 static char *InputFile1 = NULL;
 static char *InputFile2 = NULL;
@@ -45,7 +47,6 @@ int main( int argc, char **argv )
 	FILE          *ofp   = stdout;
 	float         *seis0 = NULL;
 	float         *seis1 = NULL;
-	float         *gapseis = NULL;
 	double         starttime0, starttime1;
 	double         gaptime;
 	long           gapsamp = 0;
@@ -85,10 +86,6 @@ int main( int argc, char **argv )
 	if ( gapsamp >= 0 && gapsamp < (long)(MAX_TOLERANCE_GAP_SEC / sh1.delta) ) {
 		fprintf(stderr, "Gap is %.3f seconds(total %ld samples).\n", gaptime, gapsamp);
 		fprintf(stderr, "Filling the gap with SACUNDEF(%.6f)...\n", (double)SACUNDEF);
-	/* Allocate the memory space for gaps */
-		gapseis = (float *)calloc(gapsamp, sizeof(float));
-		for ( int i = 0; i < gapsamp; i++ )
-			gapseis[i] = SACUNDEF;
 	/* Calculate the final number of samples */
 		_sh0samp = sh0.npts;
 		sh0.npts += gapsamp + sh1.npts;
@@ -113,7 +110,7 @@ int main( int argc, char **argv )
 				remove(OutputFile);
 			goto end_process;
 		}
-		if ( fwrite(gapseis, sizeof(float), gapsamp, ofp) != gapsamp ) {
+		if ( write_gap_samples( ofp, gapsamp ) ) {
 			fprintf(stderr, "Error writing SAC file: %s\n", strerror(errno));
 			if ( OutputFile )
 				remove(OutputFile);
@@ -139,16 +136,42 @@ int main( int argc, char **argv )
 end_process:
 	if ( ofp != stdout )
 		fclose(ofp);
-	if ( gapseis )
-		free(gapseis);
 	if ( seis0 )
-		free(seis0);
+		bufpool_free( seis0 );
 	if ( seis1 )
-		free(seis1);
+		bufpool_free( seis1 );
 
 	return result;
 }
 
+/**
+ * @brief Write the gap as SACUNDEF samples by the fixed-size block, so the long gap won't need
+ *        any extra memory space.
+ *
+ * @param ofp
+ * @param gapsamp
+ * @return int
+ */
+static int write_gap_samples( FILE *ofp, long gapsamp )
+{
+	static float block[GAP_BLOCK_SAMPLES] = { 0.0 };
+
+	long nsamp;
+
+/* */
+	if ( block[0] != SACUNDEF )
+		for ( int i = 0; i < GAP_BLOCK_SAMPLES; i++ )
+			block[i] = SACUNDEF;
+/* */
+	for ( ; gapsamp > 0; gapsamp -= nsamp ) {
+		nsamp = gapsamp < GAP_BLOCK_SAMPLES ? gapsamp : GAP_BLOCK_SAMPLES;
+		if ( fwrite(block, sizeof(float), nsamp, ofp) != (size_t)nsamp )
+			return -1;
+	}
+
+	return 0;
+}
+
 /**
  * @brief
  *
@@ -225,6 +248,7 @@ static void usage( void )
 		" -h    Show this usage message\n"
 		"\n"
 		"This program will concatenate the two input SAC files together.\n"
+		"The input SAC files can be '-' to read from the standard input one after another.\n"
 		"\n"
 	);
 
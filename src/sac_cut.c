@@ -0,0 +1,484 @@
+/**
+ * @file sac_cut.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+/* */
+#include <sachead.h>
+#include <sac.h>
+#include <batch.h>
+
+/* */
+#define PROG_NAME       "sac_cut"
+#define VERSION         "1.0.0 - 2026-10-18"
+#define AUTHOR          "Benjamin Ming Yang"
+/* */
+#define MAX_EVENT_ID_LENGTH  64
+#define MAX_LINE_LENGTH      256
+#define CUT_DELTA_EPSILON    1.0e-6
+/* */
+typedef struct {
+	char   id[MAX_EVENT_ID_LENGTH];
+	double origin;
+} CUT_EVENT;
+
+/* One input file, the inputs of the same SCNL are one group sorted by the start time */
+typedef struct {
+	const char    *path;
+	char           scnl[SAC_MAX_SCNL_LENGTH];
+	double         starttime;
+	int            swap;
+	int            result;
+	struct SAChead sh;
+} CUT_INPUT;
+
+typedef struct {
+	CUT_INPUT *inputs;
+	int        count;
+	int        result;
+} CUT_GROUP;
+
+/* */
+static int  proc_argv( int , char * [] );
+static void usage( void );
+static void header_job_func( void *, const int );
+static void cut_job_func( void *, const int );
+static int  cut_event_window( const CUT_GROUP *, const CUT_EVENT *, float *, const int );
+static int  load_event_list( const char * );
+static int  compare_input( const void *, const void * );
+/* */
+static char      *EventFile  = NULL;
+static char      *OutputDir  = ".";
+static char     **InputFiles = NULL;
+static int        NumInputs  = 0;
+static int        NumThreads = 0;
+static double     PreOrigin  = 0.0;
+static double     PostOrigin = 0.0;
+static CUT_EVENT *Events     = NULL;
+static int        NumEvents  = 0;
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main( int argc, char **argv )
+{
+	CUT_INPUT *inputs    = NULL;
+	CUT_GROUP *groups    = NULL;
+	int        numgroups = 0;
+	int        result    = 0;
+
+/* Check command line arguments */
+	if ( proc_argv( argc, argv ) ) {
+		usage();
+		return -1;
+	}
+/* Load the event list & create the output directory of each event */
+	if ( load_event_list( EventFile ) <= 0 ) {
+		fprintf(stderr, "Can't load any event from %s! Exiting!\n", EventFile);
+		return -1;
+	}
+	for ( int i = 0; i < NumEvents; i++ ) {
+		char path[SAC_MAX_PATH_LENGTH];
+
+		snprintf(path, sizeof(path), "%s/%s", OutputDir, Events[i].id);
+		if ( mkdir(path, 0755) && errno != EEXIST ) {
+			fprintf(stderr, "ERROR!! Can't create the output directory %s! Exiting!\n", path);
+			result = -1;
+			goto end_process;
+		}
+	}
+	if (
+		(inputs = (CUT_INPUT *)calloc(NumInputs, sizeof(CUT_INPUT))) == NULL ||
+		(groups = (CUT_GROUP *)calloc(NumInputs, sizeof(CUT_GROUP))) == NULL
+	) {
+		fprintf(stderr, "ERROR! Out of memory for %d input files\n", NumInputs);
+		result = -2;
+		goto end_process;
+	}
+/* Only the headers at first, then the inputs of the same SCNL are grouped by the start time */
+	for ( int i = 0; i < NumInputs; i++ )
+		inputs[i].path = InputFiles[i];
+	batch_jobs_run( NumInputs, NumThreads, header_job_func, inputs );
+	for ( int i = 0; i < NumInputs; i++ ) {
+		if ( inputs[i].result ) {
+			result = -1;
+			goto end_process;
+		}
+	}
+	qsort(inputs, NumInputs, sizeof(CUT_INPUT), compare_input);
+	for ( int i = 0; i < NumInputs; i++ ) {
+		if ( !i || strcmp(inputs[i - 1].scnl, inputs[i].scnl) )
+			groups[numgroups++].inputs = inputs + i;
+		else if ( fabs(inputs[i].sh.delta - groups[numgroups - 1].inputs->sh.delta) > CUT_DELTA_EPSILON * inputs[i].sh.delta ) {
+			fprintf(stderr, "The sampling interval of %s is different from the other files of %s!\n", inputs[i].path, inputs[i].scnl);
+			result = -1;
+			goto end_process;
+		}
+		groups[numgroups - 1].count++;
+	}
+/* The main process, the queue of the SCNL groups is shared by the threads */
+	batch_jobs_run( numgroups, NumThreads, cut_job_func, groups );
+	for ( int i = 0; i < numgroups; i++ )
+		if ( groups[i].result )
+			result = -1;
+
+end_process:
+	free(inputs);
+	free(groups);
+	free(Events);
+
+	return result;
+}
+
+/**
+ * @brief The header job function of each input file, it will be called by the batch threads.
+ *
+ * @param arg
+ * @param index
+ */
+static void header_job_func( void *arg, const int index )
+{
+	CUT_INPUT *input = (CUT_INPUT *)arg + index;
+	int        fd;
+
+/* */
+	input->result = -1;
+	if ( (fd = open(input->path, O_RDONLY)) < 0 ) {
+		fprintf(stderr, "Error opening %s\n", input->path);
+		return;
+	}
+	if ( (input->swap = sac_header_pread( fd, &input->sh )) >= 0 ) {
+		strcpy(input->scnl, sac_scnl_print( &input->sh ));
+		input->starttime = sac_reftime_fetch( &input->sh ) + input->sh.b;
+		input->result    = 0;
+	}
+	close(fd);
+
+	return;
+}
+
+/**
+ * @brief The job function of each SCNL group, it will be called by the batch threads. Only the
+ *        samples within the event windows will be read.
+ *
+ * @param arg
+ * @param index
+ */
+static void cut_job_func( void *arg, const int index )
+{
+	CUT_GROUP *group  = (CUT_GROUP *)arg + index;
+	float     *buffer = NULL;
+	int        maxsamp;
+	int        ncut = 0;
+
+/* The buffer of one window, it is reused by all the events */
+	group->result = -1;
+	maxsamp = (int)((PreOrigin + PostOrigin) / group->inputs->sh.delta) + 2;
+	if ( (buffer = (float *)malloc(maxsamp * sizeof(float))) == NULL ) {
+		fprintf(stderr, "ERROR! Out of memory for %d float samples\n", maxsamp);
+		return;
+	}
+/* */
+	for ( int i = 0; i < NumEvents; i++ ) {
+		switch ( cut_event_window( group, Events + i, buffer, maxsamp ) ) {
+		case 0:
+			ncut++;
+			break;
+		case 1:
+			break;
+		default:
+			goto end_process;
+		}
+	}
+	fprintf(
+		stderr, "SCNL: %s cutting finished, %d of %d events within %d file(s)!\n",
+		group->inputs->scnl, ncut, NumEvents, group->count
+	);
+	group->result = 0;
+
+end_process:
+	free(buffer);
+	return;
+}
+
+/**
+ * @brief Cut the window of the event from the files of one SCNL & write it out as one file, the
+ *        pieces from the different files are assembled by the time & the samples not covered by
+ *        any file are undefined (SACUNDEF). The reference time of the output is the origin time,
+ *        so b is relative to the origin & o is zero.
+ *
+ * @param group
+ * @param event
+ * @param buffer
+ * @param maxsamp
+ * @return int
+ * @returns: 0 on success
+ *          1 on the window is not within any file
+ *         -1 on error
+ */
+static int cut_event_window( const CUT_GROUP *group, const CUT_EVENT *event, float *buffer, const int maxsamp )
+{
+	const CUT_INPUT *input;
+	const double     delta = group->inputs->sh.delta;
+
+	FILE          *ofp;
+	int            fd;
+	int            first, last, offset, nsamp = 0;
+	double         start = 0.0, reftime;
+	char           path[SAC_MAX_PATH_LENGTH];
+	char           sta[K_LEN + 1]  = { 0 };
+	char           chan[K_LEN + 1] = { 0 };
+	char           net[K_LEN + 1]  = { 0 };
+	char           loc[K_LEN + 1]  = { 0 };
+	struct SAChead osh;
+
+/* The range of the output, it is aligned to the samples of the first file within the window */
+	for ( int i = 0; i < group->count; i++ ) {
+		input = group->inputs + i;
+		first = (int)floor((event->origin - PreOrigin - input->starttime) / delta + 0.5);
+		last  = (int)floor((event->origin + PostOrigin - input->starttime) / delta + 0.5);
+		first = first > 0 ? first : 0;
+		last  = last < input->sh.npts - 1 ? last : input->sh.npts - 1;
+		if ( last < first )
+			continue;
+		if ( !nsamp ) {
+			osh   = input->sh;
+			start = input->starttime + first * delta;
+		}
+		offset = (int)floor((input->starttime + last * delta - start) / delta + 0.5) + 1;
+		nsamp  = offset > nsamp ? offset : nsamp;
+	}
+	if ( !nsamp )
+		return 1;
+	nsamp = nsamp < maxsamp ? nsamp : maxsamp;
+/* Only the samples within the window, the later file overwrites the overlapped samples */
+	for ( int i = 0; i < nsamp; i++ )
+		buffer[i] = SACUNDEF;
+	for ( int i = 0; i < group->count; i++ ) {
+		input  = group->inputs + i;
+		offset = (int)floor((input->starttime - start) / delta + 0.5);
+		first  = offset < 0 ? -offset : 0;
+		last   = nsamp - offset < input->sh.npts ? nsamp - offset : input->sh.npts;
+		if ( last <= first )
+			continue;
+		if ( (fd = open(input->path, O_RDONLY)) < 0 ) {
+			fprintf(stderr, "Error opening %s\n", input->path);
+			return -1;
+		}
+		if ( sac_data_pread( fd, input->swap, buffer + offset + first, first, last - first ) != last - first ) {
+			close(fd);
+			return -1;
+		}
+		close(fd);
+	}
+/* Fix the header, the absolute time of the first sample is kept */
+	sac_reftime_modify( &osh, event->origin );
+	reftime    = sac_reftime_fetch( &osh );
+	osh.npts   = nsamp;
+	osh.b      = start - reftime;
+	osh.e      = osh.b + (nsamp - 1) * delta;
+	osh.o      = 0.0;
+	osh.iztype = SAC_IO;
+	sac_kevnm_modify( &osh, event->id );
+/* */
+	sscanf(group->inputs->scnl, "%8[^.].%8[^.].%8[^.].%8s", sta, chan, net, loc);
+	snprintf(path, sizeof(path), "%s/%s/%s.%s.%s.%s", OutputDir, event->id, sta, chan, net, loc);
+	if ( (ofp = fopen(path, "wb")) == (FILE *)NULL ) {
+		fprintf(stderr, "ERROR!! Can't open %s for output!\n", path);
+		return -1;
+	}
+	if (
+		fwrite(&osh, 1, sizeof(struct SAChead), ofp) != sizeof(struct SAChead) ||
+		fwrite(buffer, sizeof(float), nsamp, ofp) != (size_t)nsamp
+	) {
+		fprintf(stderr, "Error writing SAC file: %s\n", strerror(errno));
+		fclose(ofp);
+		remove(path);
+		return -1;
+	}
+	fclose(ofp);
+
+	return 0;
+}
+
+/**
+ * @brief Load the event list, each line is the event ID & the origin time in epoch seconds or
+ *        YYYY-MM-DDThh:mm:ss.sss (UTC), the line starts with '#' is the comment.
+ *
+ * @param filename
+ * @return int
+ * @returns: number of the events on success
+ *          -1 on error opening file
+ *          -2 on out of memory
+ */
+static int load_event_list( const char *filename )
+{
+	FILE      *fp;
+	CUT_EVENT *events;
+	int        capacity = 0;
+	char       line[MAX_LINE_LENGTH];
+	char       id[MAX_EVENT_ID_LENGTH];
+	char       origin[MAX_LINE_LENGTH];
+
+/* */
+	if ( (fp = fopen(filename, "r")) == NULL ) {
+		fprintf(stderr, "Error opening %s\n", filename);
+		return -1;
+	}
+	while ( fgets(line, sizeof(line), fp) ) {
+		if ( line[0] == '#' || sscanf(line, "%63s %255s", id, origin) != 2 )
+			continue;
+		if ( NumEvents >= capacity ) {
+			capacity = capacity ? capacity << 1 : 64;
+			if ( (events = (CUT_EVENT *)realloc(Events, capacity * sizeof(CUT_EVENT))) == NULL ) {
+				fprintf(stderr, "ERROR! Out of memory for %d events\n", capacity);
+				fclose(fp);
+				return -2;
+			}
+			Events = events;
+		}
+		strcpy(Events[NumEvents].id, id);
+		if ( (Events[NumEvents].origin = sac_time_parse( origin )) < 0.0 ) {
+			fprintf(stderr, "Invalid origin time %s of event %s, skip it!\n", origin, id);
+			continue;
+		}
+		NumEvents++;
+	}
+	fclose(fp);
+
+	return NumEvents;
+}
+
+/**
+ * @brief Compare the SCNL & then the start time of the input files.
+ *
+ * @param a
+ * @param b
+ * @return int
+ */
+static int compare_input( const void *a, const void *b )
+{
+	const CUT_INPUT *_a = (const CUT_INPUT *)a;
+	const CUT_INPUT *_b = (const CUT_INPUT *)b;
+	int              result;
+
+/* */
+	if ( (result = strcmp(_a->scnl, _b->scnl)) )
+		return result;
+
+	return (_a->starttime > _b->starttime) - (_a->starttime < _b->starttime);
+}
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+static int proc_argv( int argc, char *argv[] )
+{
+	for ( int i = 1; i < argc; i++ ) {
+		if ( !strcmp(argv[i], "-v") ) {
+			fprintf(stdout, "%s\n", PROG_NAME);
+			fprintf(stdout, "Version: %s\n", VERSION);
+			fprintf(stdout, "Author:  %s\n", AUTHOR);
+			fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-h") ) {
+			usage();
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-e") && i < argc - 1 ) {
+			EventFile = argv[++i];
+		}
+		else if ( !strcmp(argv[i], "-w") && i < argc - 2 ) {
+			PreOrigin  = atof(argv[++i]);
+			PostOrigin = atof(argv[++i]);
+		}
+		else if ( !strcmp(argv[i], "-o") && i < argc - 1 ) {
+			OutputDir = argv[++i];
+		}
+		else if ( !strcmp(argv[i], "-t") && i < argc - 1 ) {
+			NumThreads = atoi(argv[++i]);
+		}
+		else if ( argv[i][0] == '-' ) {
+			fprintf(stderr, "Unknown option: %s\n\n", argv[i]);
+			return -1;
+		}
+		else {
+		/* All the remained arguments are input files */
+			InputFiles = argv + i;
+			NumInputs  = argc - i;
+			break;
+		}
+	}
+/* */
+	if ( !EventFile ) {
+		fprintf(stderr, "No event list was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+	if ( PreOrigin + PostOrigin <= 0.0 ) {
+		fprintf(stderr, "No valid window was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+	if ( !NumInputs ) {
+		fprintf(stderr, "No input file was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ */
+static void usage( void )
+{
+	fprintf(stdout, "\n%s\n", PROG_NAME);
+	fprintf(stdout, "Version: %s\n", VERSION);
+	fprintf(stdout, "Author:  %s\n", AUTHOR);
+	fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+	fprintf(stdout, "***************************\n");
+	fprintf(stdout, "Usage: %s -e <event list> -w <pre> <post> [options] <input SAC files...>\n\n", PROG_NAME);
+	fprintf(stdout,
+		"*** Options ***\n"
+		" -v             Report program version\n"
+		" -h             Show this usage message\n"
+		" -e event_list  Specify the event list, each line is the event ID & the origin time in epoch\n"
+		"                seconds or YYYY-MM-DDThh:mm:ss.sss (UTC)\n"
+		" -w pre post    Specify the window in sec before & after the origin time\n"
+		" -o output_dir  Specify the output directory, default is current directory\n"
+		" -t threads     Specify the number of threads, default is the number of processors\n"
+		"\n"
+		"This program will cut the event windows from the continuous input SAC files & output them\n"
+		"as <output_dir>/<event ID>/sta.chan.net.loc, only the samples within windows will be read. The\n"
+		"input files of the same SCNL (e.g. day files) are assembled, so the window across files will\n"
+		"be one output & the samples not covered by any file are undefined (-12345).\n"
+		"\n"
+	);
+
+	return;
+}
@@ -0,0 +1,214 @@
+/**
+ * @file sac_eew.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+/* */
+#include <sachead.h>
+#include <sac.h>
+#include <picker_wu.h>
+#include <eew.h>
+#include <batch.h>
+
+/* */
+#define PROG_NAME       "sac_eew"
+#define VERSION         "1.0.0 - 2026-10-18"
+#define AUTHOR          "Benjamin Ming Yang"
+/* */
+typedef struct {
+	char       scnl[SAC_MAX_SCNL_LENGTH];
+	double     p_time;
+	int        nparams;
+	EEW_PARAM *params;
+} EEW_JOB;
+
+/* */
+static int  proc_argv( int , char * [] );
+static void usage( void );
+static void eew_job_func( void *, const int );
+/* */
+static float  GainFactor = 1.0;
+static char **InputFiles = NULL;
+static int    NumInputs  = 0;
+static int    NumThreads = 0;
+static int    OutputAll  = 0;
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main( int argc, char **argv )
+{
+	int        result = 0;
+	EEW_JOB   *jobs   = NULL;
+	EEW_PARAM *param;
+
+/* Check command line arguments */
+	if ( proc_argv( argc, argv ) ) {
+		usage();
+		return -1;
+	}
+	if ( (jobs = (EEW_JOB *)calloc(NumInputs, sizeof(EEW_JOB))) == NULL ) {
+		fprintf(stderr, "ERROR! Out of memory for %d input files\n", NumInputs);
+		return -2;
+	}
+
+/* The main process, farm out the input files to threads */
+	batch_jobs_run( NumInputs, NumThreads, eew_job_func, jobs );
+	bufpool_stats_report( stderr );
+/* Output the result table in the order of the inputs */
+	fprintf(stdout, "#SCNL P-arrival(s) Window(s) Tau-c(s) Pd Pv Pa\n");
+	for ( int i = 0; i < NumInputs; i++ ) {
+		if ( !jobs[i].nparams ) {
+			result = -1;
+			continue;
+		}
+	/* Only the longest window by default */
+		for ( int j = OutputAll ? 0 : jobs[i].nparams - 1; j < jobs[i].nparams; j++ ) {
+			param = jobs[i].params + j;
+			fprintf(
+				stdout, "%s %.3f %.3f %.4f %.6e %.6e %.6e\n",
+				jobs[i].scnl, jobs[i].p_time, param->window, param->tauc, param->pd, param->pv, param->pa
+			);
+		}
+	}
+/* */
+	for ( int i = 0; i < NumInputs; i++ )
+		if ( jobs[i].params )
+			free(jobs[i].params);
+	free(jobs);
+
+	return result;
+}
+
+/**
+ * @brief The job function of each input file, it will be called by the batch threads.
+ *
+ * @param arg
+ * @param index
+ */
+static void eew_job_func( void *arg, const int index )
+{
+	EEW_JOB       *job  = (EEW_JOB *)arg + index;
+	float         *seis = NULL;
+	int            p_arrival;
+	int            count;
+	struct SAChead sh;
+
+/* Load the SAC file to local memory */
+	if ( sac_file_load( InputFiles[index], &sh, &seis ) < 0 )
+		return;
+	strcpy(job->scnl, sac_scnl_print( &sh ));
+	sac_data_preprocess( &sh, seis, GainFactor );
+/* Pick the P arrival on the vertical component */
+	if ( (p_arrival = pickwu_p_arrival_pick( seis, sh.npts, sh.delta, 2, 0 )) <= 0 ) {
+		fprintf(stderr, "Can't pick the P arrival of %s!\n", InputFiles[index]);
+		goto end_process;
+	}
+	job->p_time = sh.b + p_arrival * sh.delta;
+/* Then the time-growing parameters from one pass */
+	count = eew_window_count( sh.delta );
+	if ( (job->params = (EEW_PARAM *)calloc(count, sizeof(EEW_PARAM))) == NULL )
+		goto end_process;
+	if ( (job->nparams = eew_tauc_pd_calc( seis, sh.npts, sh.delta, p_arrival, job->params, count )) <= 0 ) {
+		fprintf(stderr, "Not enough data after the P arrival of %s!\n", InputFiles[index]);
+		job->nparams = 0;
+		goto end_process;
+	}
+	fprintf(stderr, "SAC file: %s EEW parameters finished!\n", InputFiles[index]);
+
+end_process:
+	bufpool_free( seis );
+	return;
+}
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+static int proc_argv( int argc, char *argv[] )
+{
+	for ( int i = 1; i < argc; i++ ) {
+		if ( !strcmp(argv[i], "-v") ) {
+			fprintf(stdout, "%s\n", PROG_NAME);
+			fprintf(stdout, "Version: %s\n", VERSION);
+			fprintf(stdout, "Author:  %s\n", AUTHOR);
+			fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-h") ) {
+			usage();
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-g") && i < argc - 1 ) {
+			GainFactor = atof(argv[++i]);
+		}
+		else if ( !strcmp(argv[i], "-a") ) {
+			OutputAll = 1;
+		}
+		else if ( !strcmp(argv[i], "-t") && i < argc - 1 ) {
+			NumThreads = atoi(argv[++i]);
+		}
+		else if ( argv[i][0] == '-' ) {
+			fprintf(stderr, "Unknown option: %s\n\n", argv[i]);
+			return -1;
+		}
+		else {
+		/* All the remained arguments are input files */
+			InputFiles = argv + i;
+			NumInputs  = argc - i;
+			break;
+		}
+	}
+/* */
+	if ( !NumInputs ) {
+		fprintf(stderr, "No input file was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ */
+static void usage( void )
+{
+	fprintf(stdout, "\n%s\n", PROG_NAME);
+	fprintf(stdout, "Version: %s\n", VERSION);
+	fprintf(stdout, "Author:  %s\n", AUTHOR);
+	fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+	fprintf(stdout, "***************************\n");
+	fprintf(stdout, "Usage: %s [options] <input vertical SAC files...> > <output table>\n\n", PROG_NAME);
+	fprintf(stdout,
+		"*** Options ***\n"
+		" -v             Report program version\n"
+		" -h             Show this usage message\n"
+		" -g gain_factor Specify the gain factor, it should be floating value\n"
+		" -a             Output the parameters at every sample from 0.5 to 3 sec after P\n"
+		" -t threads     Specify the number of threads, default is the number of processors\n"
+		"\n"
+		"This program will pick the P arrival of the input acceleration SAC files & calculate\n"
+		"the Tau-c, Pd, Pv & Pa within the window after P.\n"
+		"\n"
+	);
+
+	return;
+}
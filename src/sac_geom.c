@@ -0,0 +1,338 @@
+/**
+ * @file sac_geom.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+/* */
+#include <sachead.h>
+#include <sac.h>
+#include <stadb.h>
+#include <geodesic.h>
+#include <batch.h>
+
+/* */
+#define PROG_NAME       "sac_geom"
+#define VERSION         "1.0.0 - 2026-10-18"
+#define AUTHOR          "Benjamin Ming Yang"
+/* */
+#define MAX_LINE_LENGTH  256
+/* */
+#define GEOM_TRACE_ERROR    -1
+#define GEOM_TRACE_NO_COOR   0
+#define GEOM_TRACE_OK        1
+/* */
+typedef struct {
+	double latitude;
+	double longitude;
+	double depth;
+	char   id[KEVNMLEN + 1];
+} GEOM_EVENT;
+/* */
+typedef struct {
+	struct SAChead sh;
+	int            swap;
+	int            status;
+} GEOM_TRACE;
+
+/* */
+static int  proc_argv( int , char * [] );
+static void usage( void );
+static void header_job_func( void *, const int );
+static void patch_job_func( void *, const int );
+static int  load_event_info( const char * );
+/* */
+static char      **InputFiles = NULL;
+static char       *EventFile  = NULL;
+static char       *StationDB  = NULL;
+static int         NumInputs  = 0;
+static int         NumThreads = 0;
+static GEOM_EVENT  Event      = { 0 };
+static STADB       Stadb      = { 0 };
+static GEOM_TRACE *Traces     = NULL;
+static double     *StaLat     = NULL;
+static double     *StaLon     = NULL;
+static GEODESIC_RESULT Geometry = { 0 };
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main( int argc, char **argv )
+{
+	int    result  = -1;
+	int    npatch  = 0;
+	int    nnocoor = 0;
+	float *buffer  = NULL;
+
+/* Check command line arguments */
+	if ( proc_argv( argc, argv ) ) {
+		usage();
+		return -1;
+	}
+/* */
+	if ( load_event_info( EventFile ) )
+		return -1;
+	if ( StationDB && stadb_open( StationDB, &Stadb ) < 0 )
+		return -1;
+/* The per-trace buffers, the station coordinates & the results are in arrays for the batch geometry */
+	Traces = (GEOM_TRACE *)calloc(NumInputs, sizeof(GEOM_TRACE));
+	StaLat = (double *)calloc(NumInputs * 2, sizeof(double));
+	buffer = (float *)calloc(NumInputs * 4, sizeof(float));
+	if ( !Traces || !StaLat || !buffer ) {
+		fprintf(stderr, "ERROR! Out of memory for %d input files\n", NumInputs);
+		result = -2;
+		goto end_process;
+	}
+	StaLon         = StaLat + NumInputs;
+	Geometry.dist  = buffer;
+	Geometry.az    = buffer + NumInputs;
+	Geometry.baz   = buffer + NumInputs * 2;
+	Geometry.gcarc = buffer + NumInputs * 3;
+/* First, the headers & the station coordinates of all the traces */
+	batch_jobs_run( NumInputs, NumThreads, header_job_func, NULL );
+/* Then, the geometry of all the stations at once */
+	geodesic_distaz( Event.latitude, Event.longitude, StaLat, StaLon, NumInputs, &Geometry );
+/* Finally, patch the headers in place */
+	batch_jobs_run( NumInputs, NumThreads, patch_job_func, NULL );
+/* */
+	result = 0;
+	for ( int i = 0; i < NumInputs; i++ ) {
+		if ( Traces[i].status == GEOM_TRACE_OK )
+			npatch++;
+		else if ( Traces[i].status == GEOM_TRACE_NO_COOR )
+			nnocoor++;
+		else
+			result = -1;
+	}
+	fprintf(
+		stderr, "Event (%.4f, %.4f, %.1f km) geometry has been filled in %d of %d SAC files, %d without the station coordinates!\n",
+		Event.latitude, Event.longitude, Event.depth, npatch, NumInputs, nnocoor
+	);
+
+end_process:
+	free(Traces);
+	free(StaLat);
+	free(buffer);
+	stadb_close( &Stadb );
+
+	return result;
+}
+
+/**
+ * @brief Read the header & fetch the station coordinates of each input file, the coordinates in the
+ *        station database have the priority over those in the header.
+ *
+ * @param arg
+ * @param index
+ */
+static void header_job_func( void *arg, const int index )
+{
+	GEOM_TRACE        *trace = Traces + index;
+	const STADB_ENTRY *entry;
+	int                fd;
+
+/* */
+	trace->status = GEOM_TRACE_ERROR;
+	if ( (fd = open(InputFiles[index], O_RDONLY)) < 0 ) {
+		fprintf(stderr, "Error opening %s\n", InputFiles[index]);
+		return;
+	}
+	trace->swap = sac_header_pread( fd, &trace->sh );
+	close(fd);
+	if ( trace->swap < 0 )
+		return;
+/* */
+	if ( StationDB && (entry = stadb_find_sac( &Stadb, &trace->sh )) ) {
+		stadb_header_fill( &trace->sh, entry );
+		StaLat[index] = entry->latitude;
+		StaLon[index] = entry->longitude;
+	}
+	else if ( trace->sh.stla != SACUNDEF && trace->sh.stlo != SACUNDEF ) {
+		StaLat[index] = trace->sh.stla;
+		StaLon[index] = trace->sh.stlo;
+	}
+	else {
+		fprintf(stderr, "Can't find the coordinates of %s (%s), skip it!\n", sac_scnl_print( &trace->sh ), InputFiles[index]);
+		trace->status = GEOM_TRACE_NO_COOR;
+		return;
+	}
+	trace->status = GEOM_TRACE_OK;
+
+	return;
+}
+
+/**
+ * @brief Write the event location & the geometry into the header of each input file, only the header
+ *        will be written.
+ *
+ * @param arg
+ * @param index
+ */
+static void patch_job_func( void *arg, const int index )
+{
+	GEOM_TRACE     *trace = Traces + index;
+	struct SAChead *sh    = &trace->sh;
+	int             fd;
+
+/* */
+	if ( trace->status != GEOM_TRACE_OK )
+		return;
+	sh->evla   = Event.latitude;
+	sh->evlo   = Event.longitude;
+	sh->evdp   = Event.depth;
+	sh->dist   = Geometry.dist[index];
+	sh->az     = Geometry.az[index];
+	sh->baz    = Geometry.baz[index];
+	sh->gcarc  = Geometry.gcarc[index];
+	sh->lcalda = 0;
+	if ( Event.id[0] )
+		sac_kevnm_modify( sh, Event.id );
+/* */
+	trace->status = GEOM_TRACE_ERROR;
+	if ( (fd = open(InputFiles[index], O_WRONLY)) < 0 ) {
+		fprintf(stderr, "Error opening %s for writing: %s\n", InputFiles[index], strerror(errno));
+		return;
+	}
+	if ( !sac_header_pwrite( fd, trace->swap, sh ) )
+		trace->status = GEOM_TRACE_OK;
+	close(fd);
+
+	return;
+}
+
+/**
+ * @brief Load the event information, the first line which is not the comment (starts with '#') should
+ *        be the latitude, longitude & depth (km), and the optional event ID.
+ *
+ * @param filename
+ * @return int
+ * @returns: 0 on success
+ *          -1 on error opening file or no valid event
+ */
+static int load_event_info( const char *filename )
+{
+	FILE *fp;
+	char  line[MAX_LINE_LENGTH];
+	int   nfields = 0;
+
+/* */
+	if ( (fp = fopen(filename, "r")) == NULL ) {
+		fprintf(stderr, "Error opening %s\n", filename);
+		return -1;
+	}
+	while ( fgets(line, sizeof(line), fp) ) {
+		if ( line[0] == '#' )
+			continue;
+		nfields = sscanf(line, "%lf %lf %lf %16s", &Event.latitude, &Event.longitude, &Event.depth, Event.id);
+		if ( nfields >= 3 )
+			break;
+	}
+	fclose(fp);
+/* */
+	if ( nfields < 3 || Event.latitude < -90.0 || Event.latitude > 90.0 ) {
+		fprintf(stderr, "Can't find the valid event information in %s\n", filename);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+static int proc_argv( int argc, char *argv[] )
+{
+	for ( int i = 1; i < argc; i++ ) {
+		if ( !strcmp(argv[i], "-v") ) {
+			fprintf(stdout, "%s\n", PROG_NAME);
+			fprintf(stdout, "Version: %s\n", VERSION);
+			fprintf(stdout, "Author:  %s\n", AUTHOR);
+			fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-h") ) {
+			usage();
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-e") && i < argc - 1 ) {
+			EventFile = argv[++i];
+		}
+		else if ( !strcmp(argv[i], "-db") && i < argc - 1 ) {
+			StationDB = argv[++i];
+		}
+		else if ( !strcmp(argv[i], "-t") && i < argc - 1 ) {
+			NumThreads = atoi(argv[++i]);
+		}
+		else if ( argv[i][0] == '-' ) {
+			fprintf(stderr, "Unknown option: %s\n\n", argv[i]);
+			return -1;
+		}
+		else {
+		/* All the remained arguments are input files */
+			InputFiles = argv + i;
+			NumInputs  = argc - i;
+			break;
+		}
+	}
+/* */
+	if ( !EventFile ) {
+		fprintf(stderr, "No event information was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+	if ( !NumInputs ) {
+		fprintf(stderr, "No input file was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ */
+static void usage( void )
+{
+	fprintf(stdout, "\n%s\n", PROG_NAME);
+	fprintf(stdout, "Version: %s\n", VERSION);
+	fprintf(stdout, "Author:  %s\n", AUTHOR);
+	fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+	fprintf(stdout, "***************************\n");
+	fprintf(stdout, "Usage: %s -e <event info> [options] <input SAC files...>\n\n", PROG_NAME);
+	fprintf(stdout,
+		"*** Options ***\n"
+		" -v             Report program version\n"
+		" -h             Show this usage message\n"
+		" -e event_info  Specify the event information, the line is latitude, longitude, depth (km)\n"
+		"                & the optional event ID\n"
+		" -db station_db Take the station coordinates from the station list or snapshot, otherwise\n"
+		"                those in the headers will be used\n"
+		" -t threads     Specify the number of threads, default is the number of processors\n"
+		"\n"
+		"This program will fill the event location, distance, azimuth, back-azimuth & arc distance\n"
+		"into the headers of the input SAC files in place, the data won't be touched.\n"
+		"\n"
+	);
+
+	return;
+}
@@ -0,0 +1,416 @@
+/**
+ * @file sac_gm.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+/* */
+#include <sachead.h>
+#include <sac.h>
+#include <gmotion.h>
+#include <peaktrack.h>
+#include <gather.h>
+#include <batch.h>
+
+/* */
+#define PROG_NAME       "sac_gm"
+#define VERSION         "1.0.0 - 2026-10-18"
+#define AUTHOR          "Benjamin Ming Yang"
+/* */
+#define VM_CHANNEL_NAME "VM"
+/* */
+typedef struct {
+	int        result;
+	char       sta[K_LEN + 1];
+	char       chan[K_LEN + 1];
+	char       net[K_LEN + 1];
+	char       loc[K_LEN + 1];
+	GM_METRICS metrics;
+	double     spk;      /* Sustained peak over the window (gal), only with -pk */
+} GM_ROW;
+
+/* */
+static int    proc_argv( int , char * [] );
+static void   usage( void );
+static void   gm_job_func( void *, const int );
+static void   gm_vm_job_func( void *, const int );
+static void   gm_gather_job_func( void *, const int );
+static float *gm_component_calc( const char *, GM_ROW *, struct SAChead * );
+static int    gm_sustained_peak( const float *, const int, const double, GM_ROW * );
+/* */
+static float  GainFactor = 1.0;
+static char **InputFiles = NULL;
+static int    NumInputs  = 0;
+static int    NumThreads = 0;
+static int    VectorMag  = 0;
+static int    EventMode  = 0;
+static double PeakWindow = 0.0;
+static SAC_GATHER Gather;
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main( int argc, char **argv )
+{
+	int     result = 0;
+	int     nrows;
+	GM_ROW *rows = NULL;
+
+/* Check command line arguments */
+	if ( proc_argv( argc, argv ) ) {
+		usage();
+		return -1;
+	}
+/* The whole event is gathered at once, the stations are grouped by the headers */
+	if ( EventMode && gather_load( InputFiles, NumInputs, NumThreads, &Gather ) < 0 ) {
+		fprintf(stderr, "Can't gather the input files of the event! Exiting!\n");
+		return -1;
+	}
+/* Each triplet has one more row of the vector magnitude */
+	nrows = EventMode ? Gather.nstations * 4 : VectorMag ? NumInputs / 3 * 4 : NumInputs;
+	if ( (rows = (GM_ROW *)calloc(nrows, sizeof(GM_ROW))) == NULL ) {
+		fprintf(stderr, "ERROR! Out of memory for %d input files\n", NumInputs);
+		gather_free( &Gather );
+		return -2;
+	}
+
+/* The main process, farm out the input files (or the station triplets) to threads */
+	if ( EventMode )
+		batch_jobs_run( Gather.nstations, NumThreads, gm_gather_job_func, rows );
+	else if ( VectorMag )
+		batch_jobs_run( NumInputs / 3, NumThreads, gm_vm_job_func, rows );
+	else
+		batch_jobs_run( NumInputs, NumThreads, gm_job_func, rows );
+	bufpool_stats_report( stderr );
+/* Output the result table in the order of the inputs, the leading columns are the same as the station list */
+	fprintf(
+		stdout, "#Station Network Location Channel PGA(gal) Ia(m/s) CAV(cm/s) T5(s) T95(s) D5-95(s)%s\n",
+		PeakWindow > 0.0 ? " SPk(gal)" : ""
+	);
+	for ( int i = 0; i < nrows; i++ ) {
+	/* The positive result is the missing component of the gather, just skip it */
+		if ( rows[i].result ) {
+			result = rows[i].result < 0 ? -1 : result;
+			continue;
+		}
+		fprintf(
+			stdout, "%s %s %s %s %.6f %.6f %.6f %.3f %.3f %.3f",
+			rows[i].sta, rows[i].net, rows[i].loc, rows[i].chan,
+			rows[i].metrics.pga, rows[i].metrics.arias, rows[i].metrics.cav,
+			rows[i].metrics.t_start, rows[i].metrics.t_end, rows[i].metrics.dur
+		);
+		if ( PeakWindow > 0.0 )
+			fprintf(stdout, " %.6f", rows[i].spk);
+		fprintf(stdout, "\n");
+	}
+/* */
+	free(rows);
+	gather_free( &Gather );
+
+	return result;
+}
+
+/**
+ * @brief The job function of each input file, it will be called by the batch threads.
+ *
+ * @param arg
+ * @param index
+ */
+static void gm_job_func( void *arg, const int index )
+{
+	struct SAChead sh;
+
+/* */
+	bufpool_free( gm_component_calc( InputFiles[index], (GM_ROW *)arg + index, &sh ) );
+
+	return;
+}
+
+/**
+ * @brief The job function of each Z/N/E triplet, the fourth row is the metrics of the vector
+ *        magnitude. It will be called by the batch threads.
+ *
+ * @param arg
+ * @param index
+ */
+static void gm_vm_job_func( void *arg, const int index )
+{
+	GM_ROW        *rows    = (GM_ROW *)arg + index * 4;
+	float         *seis[3] = { NULL };
+	struct SAChead sh[3];
+
+/* */
+	rows[3].result = -1;
+	for ( int i = 0; i < 3; i++ )
+		if ( (seis[i] = gm_component_calc( InputFiles[index * 3 + i], rows + i, sh + i )) == NULL )
+			goto end_process;
+/* The triplet should be the same station with the same sampling & timing */
+	for ( int i = 1; i < 3; i++ ) {
+		if (
+			strcmp(rows[i].sta, rows[0].sta) || strcmp(rows[i].net, rows[0].net) || strcmp(rows[i].loc, rows[0].loc) ||
+			sh[i].npts != sh[0].npts || sh[i].delta != sh[0].delta ||
+			fabs((sac_reftime_fetch( sh + i ) + sh[i].b) - (sac_reftime_fetch( sh ) + sh[0].b)) > sh[0].delta * 0.5
+		) {
+			fprintf(stderr, "SAC files: %s & %s are not the same station triplet!\n", InputFiles[index * 3], InputFiles[index * 3 + i]);
+			goto end_process;
+		}
+	}
+/* The vector magnitude overwrites the first component */
+	rows[3] = rows[0];
+	strcpy(rows[3].chan, VM_CHANNEL_NAME);
+	peaktrack_vector_magnitude( seis[0], seis[1], seis[2], sh[0].npts, seis[0] );
+	if ( (rows[3].result = gmotion_metrics_calc( seis[0], sh[0].npts, sh[0].delta, &rows[3].metrics )) == 0 ) {
+		rows[3].metrics.t_start += sh[0].b;
+		rows[3].metrics.t_end   += sh[0].b;
+		rows[3].result           = gm_sustained_peak( seis[0], sh[0].npts, sh[0].delta, rows + 3 );
+	}
+
+end_process:
+	for ( int i = 0; i < 3; i++ )
+		bufpool_free( seis[i] );
+	return;
+}
+
+/**
+ * @brief The job function of each station of the gather, the samples are preprocessed in place
+ *        within the arena. The vector magnitude row is only for the station with all the three
+ *        components. It will be called by the batch threads.
+ *
+ * @param arg
+ * @param index
+ */
+static void gm_gather_job_func( void *arg, const int index )
+{
+	GM_ROW               *rows    = (GM_ROW *)arg + index * 4;
+	const GATHER_STATION *station = Gather.stations + index;
+	float                *vm      = NULL;
+	struct SAChead        sh;
+
+/* */
+	for ( int c = 0; c < GATHER_NUM_COMPONENTS; c++ ) {
+		rows[c].result = 1;
+		if ( !(station->mask & (1 << c)) )
+			continue;
+	/* The header of the common window */
+		sh      = station->sh[c];
+		sh.npts = Gather.npts;
+		sh.b    = Gather.starttime - sac_reftime_fetch( &sh );
+		sscanf(sac_scnl_print( &sh ), "%8[^.].%8[^.].%8[^.].%8s", rows[c].sta, rows[c].chan, rows[c].net, rows[c].loc);
+		sac_data_preprocess( &sh, Gather.comp[c][index], GainFactor );
+		if ( (rows[c].result = gmotion_metrics_calc( Gather.comp[c][index], sh.npts, sh.delta, &rows[c].metrics )) ) {
+			fprintf(stderr, "Error calculating the ground motion metrics of %s\n", sac_scnl_print( &sh ));
+			continue;
+		}
+		rows[c].metrics.t_start += sh.b;
+		rows[c].metrics.t_end   += sh.b;
+		rows[c].result           = gm_sustained_peak( Gather.comp[c][index], sh.npts, sh.delta, rows + c );
+	}
+/* */
+	rows[3].result = 1;
+	if ( station->mask != (1 << GATHER_NUM_COMPONENTS) - 1 || rows[0].result || rows[1].result || rows[2].result )
+		return;
+	if ( (vm = (float *)bufpool_alloc(Gather.npts * sizeof(float))) == NULL ) {
+		fprintf(stderr, "ERROR! Out of memory for the vector magnitude of %s\n", station->sta);
+		rows[3].result = -2;
+		return;
+	}
+	rows[3] = rows[0];
+	strcpy(rows[3].chan, VM_CHANNEL_NAME);
+	peaktrack_vector_magnitude(
+		Gather.comp[GATHER_COMP_Z][index], Gather.comp[GATHER_COMP_N][index], Gather.comp[GATHER_COMP_E][index],
+		Gather.npts, vm
+	);
+	if ( (rows[3].result = gmotion_metrics_calc( vm, Gather.npts, Gather.delta, &rows[3].metrics )) == 0 ) {
+		rows[3].metrics.t_start += Gather.starttime - sac_reftime_fetch( station->sh );
+		rows[3].metrics.t_end   += Gather.starttime - sac_reftime_fetch( station->sh );
+		rows[3].result           = gm_sustained_peak( vm, Gather.npts, Gather.delta, rows + 3 );
+	}
+	bufpool_free( vm );
+
+	return;
+}
+
+/**
+ * @brief Load & preprocess one component, then calculate its metrics.
+ *
+ * @param filename
+ * @param row
+ * @param sh
+ * @return float*
+ * @returns: the preprocessed samples on success
+ *           NULL on error
+ */
+static float *gm_component_calc( const char *filename, GM_ROW *row, struct SAChead *sh )
+{
+	float *seis = NULL;
+
+/* Load the SAC file to local memory */
+	row->result = -1;
+	if ( sac_file_load( filename, sh, &seis ) < 0 )
+		return NULL;
+	sscanf(sac_scnl_print( sh ), "%8[^.].%8[^.].%8[^.].%8s", row->sta, row->chan, row->net, row->loc);
+/* First, preprocess the raw seismic data, then the fused metrics pass */
+	sac_data_preprocess( sh, seis, GainFactor );
+	if ( (row->result = gmotion_metrics_calc( seis, sh->npts, sh->delta, &row->metrics )) ) {
+		fprintf(stderr, "Error calculating the ground motion metrics of %s\n", filename);
+		bufpool_free( seis );
+		return NULL;
+	}
+	if ( (row->result = gm_sustained_peak( seis, sh->npts, sh->delta, row )) ) {
+		bufpool_free( seis );
+		return NULL;
+	}
+	fprintf(stderr, "SAC file: %s ground motion metrics finished!\n", filename);
+/* The times should be relative to the reference time */
+	row->metrics.t_start += sh->b;
+	row->metrics.t_end   += sh->b;
+
+	return seis;
+}
+
+/**
+ * @brief The sustained peak is the highest level which the absolute value (or the vector magnitude)
+ *        keeps exceeding through the whole window, i.e. the max of the running minimum by the
+ *        peak tracker. The whole trace is one window if it is shorter than the window.
+ *
+ * @param seis
+ * @param npts
+ * @param delta
+ * @param row
+ * @return int
+ * @returns: 0 on success
+ *          -2 on out of memory
+ */
+static int gm_sustained_peak( const float *seis, const int npts, const double delta, GM_ROW *row )
+{
+	const int    window = (int)(PeakWindow / delta + 0.5);
+	PEAK_TRACKER tracker;
+	float        level;
+
+/* */
+	row->spk = 0.0;
+	if ( PeakWindow <= 0.0 )
+		return 0;
+	if ( peaktrack_init( &tracker, window > 0 ? window : 1 ) ) {
+		fprintf(stderr, "ERROR! Out of memory for the peak tracker of %s\n", row->sta);
+		return -2;
+	}
+	for ( int i = 0; i < npts; i++ ) {
+		peaktrack_push( &tracker, fabsf(seis[i]) );
+		if ( i >= window - 1 || i == npts - 1 ) {
+			level    = peaktrack_min( &tracker );
+			row->spk = level > row->spk ? level : row->spk;
+		}
+	}
+	peaktrack_free( &tracker );
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+static int proc_argv( int argc, char *argv[] )
+{
+	for ( int i = 1; i < argc; i++ ) {
+		if ( !strcmp(argv[i], "-v") ) {
+			fprintf(stdout, "%s\n", PROG_NAME);
+			fprintf(stdout, "Version: %s\n", VERSION);
+			fprintf(stdout, "Author:  %s\n", AUTHOR);
+			fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-h") ) {
+			usage();
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-g") && i < argc - 1 ) {
+			GainFactor = atof(argv[++i]);
+		}
+		else if ( !strcmp(argv[i], "-vm") ) {
+			VectorMag = 1;
+		}
+		else if ( !strcmp(argv[i], "-ev") ) {
+			EventMode = 1;
+		}
+		else if ( !strcmp(argv[i], "-pk") && i < argc - 1 ) {
+			PeakWindow = atof(argv[++i]);
+		}
+		else if ( !strcmp(argv[i], "-t") && i < argc - 1 ) {
+			NumThreads = atoi(argv[++i]);
+		}
+		else if ( argv[i][0] == '-' ) {
+			fprintf(stderr, "Unknown option: %s\n\n", argv[i]);
+			return -1;
+		}
+		else {
+		/* All the remained arguments are input files */
+			InputFiles = argv + i;
+			NumInputs  = argc - i;
+			break;
+		}
+	}
+/* */
+	if ( !NumInputs ) {
+		fprintf(stderr, "No input file was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+	if ( VectorMag && !EventMode && (NumInputs % 3) ) {
+		fprintf(stderr, "The input files should be Z/N/E triplets with -vm; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ */
+static void usage( void )
+{
+	fprintf(stdout, "\n%s\n", PROG_NAME);
+	fprintf(stdout, "Version: %s\n", VERSION);
+	fprintf(stdout, "Author:  %s\n", AUTHOR);
+	fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+	fprintf(stdout, "***************************\n");
+	fprintf(stdout, "Usage: %s [options] <input SAC files...> > <output table>\n\n", PROG_NAME);
+	fprintf(stdout,
+		"*** Options ***\n"
+		" -v             Report program version\n"
+		" -h             Show this usage message\n"
+		" -g gain_factor Specify the gain factor, it should be floating value\n"
+		" -vm            Treat every three input files as one station & add its vector magnitude row\n"
+		" -ev            Gather all the input files as one event, the components are grouped by the\n"
+		"                station in the headers & cut to the common time window, the vector magnitude\n"
+		"                row is added for the station with all the three components\n"
+		" -pk window     Add the sustained peak column, the highest level which the absolute value\n"
+		"                (or the vector magnitude) keeps exceeding through the window in sec\n"
+		" -t threads     Specify the number of threads, default is the number of processors\n"
+		"\n"
+		"This program will calculate the PGA, Arias intensity, CAV & 5-95%% significant duration\n"
+		"of the input acceleration (in gal after the gain factor) SAC files.\n"
+		"\n"
+	);
+
+	return;
+}
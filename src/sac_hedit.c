@@ -0,0 +1,504 @@
+/**
+ * @file sac_hedit.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#define _GNU_SOURCE  /* For renameat2() */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+/* */
+#include <sachead.h>
+#include <sac.h>
+#include <sacfield.h>
+#include <sacfilter.h>
+#include <batch.h>
+
+/* */
+#define PROG_NAME       "sac_hedit"
+#define VERSION         "1.0.0 - 2026-10-18"
+#define AUTHOR          "Benjamin Ming Yang"
+/* */
+#define HEDIT_MAX_ASSIGNS      32
+#define HEDIT_MAX_LINE_LENGTH  1024
+#define HEDIT_RULE_SEPARATOR   "=>"
+/* */
+#define HEDIT_FILE_ERROR      -1
+#define HEDIT_FILE_UNCHANGED   0
+#define HEDIT_FILE_MODIFIED    1
+#define HEDIT_FILE_RENAMED     2
+
+/*----------------------------------------------------------------------*
+ * Definition of one rule, the assignments will be applied to the       *
+ * headers matched the filter                                           *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	const SAC_FIELD *field;
+	char             value[SAC_FIELD_VALUE_LENGTH];
+} HEDIT_ASSIGN;
+
+typedef struct {
+	SAC_FILTER   filter;
+	HEDIT_ASSIGN assigns[HEDIT_MAX_ASSIGNS];
+	int          nassigns;
+} HEDIT_RULE;
+
+/* */
+static int  proc_argv( int , char * [] );
+static void usage( void );
+static void hedit_job_func( void *, const int );
+static int  apply_rules( const struct SAChead *, struct SAChead *, char *, const int );
+static int  apply_assign( struct SAChead *, const HEDIT_ASSIGN * );
+static int  rename_path_gen( const char *, const struct SAChead *, char * );
+static int  load_rules( const char * );
+static int  parse_assigns( char *, HEDIT_RULE * );
+/* */
+static char      **InputFiles = NULL;
+static int         NumInputs  = 0;
+static int         NumThreads = 0;
+static char       *RuleFile   = NULL;
+static int         RenameFlag = 0;
+static int         DryRunFlag = 0;
+static HEDIT_RULE *Rules      = NULL;
+static int         NumRules   = 0;
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main( int argc, char **argv )
+{
+	int *results  = NULL;
+	int  result   = 0;
+	int  nmodify  = 0;
+	int  nrename  = 0;
+
+/* Check command line arguments */
+	if ( proc_argv( argc, argv ) ) {
+		usage();
+		return -1;
+	}
+/* The rules are compiled & checked before touching any file */
+	if ( load_rules( RuleFile ) <= 0 ) {
+		fprintf(stderr, "Can't load any rule from %s! Exiting!\n", RuleFile);
+		result = -1;
+		goto end_process;
+	}
+	if ( (results = (int *)calloc(NumInputs, sizeof(int))) == NULL ) {
+		fprintf(stderr, "ERROR! Out of memory for %d input files\n", NumInputs);
+		result = -2;
+		goto end_process;
+	}
+/* The main process, the queue of the input files is shared by the threads */
+	batch_jobs_run( NumInputs, NumThreads, hedit_job_func, results );
+	for ( int i = 0; i < NumInputs; i++ ) {
+		switch ( results[i] ) {
+		case HEDIT_FILE_RENAMED:
+			nrename++;
+		/* Go through */
+		case HEDIT_FILE_MODIFIED:
+			nmodify++;
+			break;
+		case HEDIT_FILE_ERROR:
+			result = -1;
+			break;
+		default:
+			break;
+		}
+	}
+	fprintf(
+		stderr, "%s %d of %d SAC files, %d of them renamed!\n",
+		DryRunFlag ? "Would modify" : "Modified", nmodify, NumInputs, nrename
+	);
+
+end_process:
+	free(results);
+	free(Rules);
+
+	return result;
+}
+
+/**
+ * @brief The job function of each input file, it will be called by the batch threads. The new header
+ *        is fully built in memory first, then written by one pwrite() of the header & renamed. If the
+ *        renaming fails, the original header will be written back, so each file is either fully
+ *        modified or untouched.
+ *
+ * @param arg
+ * @param index
+ */
+static void hedit_job_func( void *arg, const int index )
+{
+	int           *result = (int *)arg + index;
+	const char    *path   = InputFiles[index];
+	int            fd;
+	int            swap;
+	char           changes[HEDIT_MAX_LINE_LENGTH] = { 0 };
+	char           new_path[SAC_MAX_PATH_LENGTH]  = { 0 };
+	struct SAChead sh, nsh;
+
+/* */
+	*result = HEDIT_FILE_ERROR;
+	if ( (fd = open(path, DryRunFlag ? O_RDONLY : O_RDWR)) < 0 ) {
+		fprintf(stderr, "Error opening %s: %s\n", path, strerror(errno));
+		return;
+	}
+	if ( (swap = sac_header_pread( fd, &sh )) < 0 )
+		goto end_process;
+/* Apply all the matched rules on the copy */
+	nsh = sh;
+	if ( apply_rules( &sh, &nsh, changes, sizeof(changes) ) < 0 ) {
+		fprintf(stderr, "Invalid value for the header of %s, skip it!\n", path);
+		goto end_process;
+	}
+	if ( !memcmp(&sh, &nsh, sizeof(struct SAChead)) ) {
+		*result = HEDIT_FILE_UNCHANGED;
+		goto end_process;
+	}
+	if ( RenameFlag && rename_path_gen( path, &nsh, new_path ) )
+		goto end_process;
+/* */
+	if ( DryRunFlag ) {
+		fprintf(stdout, "%s%s%s:%s\n", path, new_path[0] ? " -> " : "", new_path, changes);
+	}
+	else {
+		if ( sac_header_pwrite( fd, swap, &nsh ) )
+			goto end_process;
+		if ( new_path[0] && renameat2(AT_FDCWD, path, AT_FDCWD, new_path, RENAME_NOREPLACE) ) {
+			fprintf(stderr, "Error renaming %s to %s: %s, roll back the header!\n", path, new_path, strerror(errno));
+			sac_header_pwrite( fd, swap, &sh );
+			goto end_process;
+		}
+	}
+	*result = new_path[0] ? HEDIT_FILE_RENAMED : HEDIT_FILE_MODIFIED;
+
+end_process:
+	close(fd);
+	return;
+}
+
+/**
+ * @brief Apply the rules in order, all the rules are matched with the original header, so the rules
+ *        won't trigger each other (e.g. the permutation of the components).
+ *
+ * @param sh
+ * @param nsh
+ * @param changes
+ * @param size
+ * @return int
+ * @returns: number of the matched rules on success
+ *          -1 on invalid value
+ */
+static int apply_rules( const struct SAChead *sh, struct SAChead *nsh, char *changes, const int size )
+{
+	int  nmatch = 0;
+	int  len    = 0;
+	char value[SAC_FIELD_VALUE_LENGTH];
+
+/* */
+	for ( int i = 0; i < NumRules; i++ ) {
+		if ( !sacfilter_match( &Rules[i].filter, sh ) )
+			continue;
+		for ( int j = 0; j < Rules[i].nassigns; j++ ) {
+			if ( apply_assign( nsh, Rules[i].assigns + j ) )
+				return -1;
+			if ( len < size ) {
+				sacfield_value_print( nsh, Rules[i].assigns[j].field, value, sizeof(value) );
+				len += snprintf(changes + len, size - len, " %s=%s", Rules[i].assigns[j].field->name, value);
+			}
+		}
+		nmatch++;
+	}
+
+	return nmatch;
+}
+
+/**
+ * @brief Apply one assignment, each '?' of the string value will be replaced by the character at the
+ *        same position of the current value, e.g. kcmpnm=HL? turns HHZ into HLZ.
+ *
+ * @param sh
+ * @param assign
+ * @return int
+ */
+static int apply_assign( struct SAChead *sh, const HEDIT_ASSIGN *assign )
+{
+	char value[SAC_FIELD_VALUE_LENGTH];
+	char current[KEVNMLEN + 1];
+	int  len;
+
+/* */
+	if ( sacfield_is_numeric( assign->field ) || !strchr(assign->value, '?') )
+		return sacfield_value_set( sh, assign->field, assign->value );
+/* */
+	sacfield_string_get( sh, assign->field, current );
+	len = strlen(current);
+	strcpy(value, assign->value);
+	for ( int i = 0; value[i]; i++ )
+		if ( value[i] == '?' )
+			value[i] = i < len ? current[i] : ' ';
+
+	return sacfield_value_set( sh, assign->field, value );
+}
+
+/**
+ * @brief Generate the new path in the same directory by the SCNL of the new header, nothing will be
+ *        generated if the name is the same.
+ *
+ * @param path
+ * @param sh
+ * @param new_path
+ * @return int
+ */
+static int rename_path_gen( const char *path, const struct SAChead *sh, char *new_path )
+{
+	const char *base = strrchr(path, '/');
+	char        dir[SAC_MAX_PATH_LENGTH] = ".";
+	char        sta[K_LEN + 1]  = { 0 };
+	char        chan[K_LEN + 1] = { 0 };
+	char        net[K_LEN + 1]  = { 0 };
+	char        loc[K_LEN + 1]  = { 0 };
+
+/* */
+	if ( base ) {
+		snprintf(dir, sizeof(dir), "%.*s", (int)(base - path), path);
+		if ( !dir[0] )
+			strcpy(dir, "/");
+	}
+	sscanf(sac_scnl_print( sh ), "%8[^.].%8[^.].%8[^.].%8s", sta, chan, net, loc);
+	if ( snprintf(new_path, SAC_MAX_PATH_LENGTH, SAC_FILE_NAME_FORMAT, dir, sta, chan, net, loc) >= SAC_MAX_PATH_LENGTH ) {
+		fprintf(stderr, "The new path of %s is too long!\n", path);
+		return -1;
+	}
+/* The same name, e.g. the SCNL is not modified */
+	if ( !strcmp(base ? base + 1 : path, new_path + strlen(dir) + 1) )
+		new_path[0] = '\0';
+
+	return 0;
+}
+
+/**
+ * @brief Load the rules, each line is the filter expression & the assignments separated by "=>", e.g.
+ *          kstnm == W21A && kcmpnm ~ HH? => kcmpnm=HL? cmpaz=0 user0=1.5
+ *        the line starts with '#' is the comment. The assignments are checked on a scratch header.
+ *
+ * @param filename
+ * @return int
+ * @returns: number of the rules on success
+ *          -1 on error opening file or invalid rule
+ *          -2 on out of memory
+ */
+static int load_rules( const char *filename )
+{
+	FILE       *fp;
+	HEDIT_RULE *rules;
+	int         capacity = 0;
+	int         lineno   = 0;
+	char        line[HEDIT_MAX_LINE_LENGTH];
+	char       *sep;
+
+/* */
+	if ( (fp = fopen(filename, "r")) == NULL ) {
+		fprintf(stderr, "Error opening %s\n", filename);
+		return -1;
+	}
+	while ( fgets(line, sizeof(line), fp) ) {
+		lineno++;
+		line[strcspn(line, "\r\n")] = '\0';
+		if ( line[0] == '#' || line[strspn(line, " \t")] == '\0' )
+			continue;
+		if ( (sep = strstr(line, HEDIT_RULE_SEPARATOR)) == NULL ) {
+			fprintf(stderr, "Missing '%s' of the rule at line %d of %s\n", HEDIT_RULE_SEPARATOR, lineno, filename);
+			goto error_rule;
+		}
+		*sep = '\0';
+	/* */
+		if ( NumRules >= capacity ) {
+			capacity = capacity ? capacity << 1 : 16;
+			if ( (rules = (HEDIT_RULE *)realloc(Rules, capacity * sizeof(HEDIT_RULE))) == NULL ) {
+				fprintf(stderr, "ERROR! Out of memory for %d rules\n", capacity);
+				fclose(fp);
+				return -2;
+			}
+			Rules = rules;
+		}
+		if (
+			sacfilter_compile( line, &Rules[NumRules].filter ) < 0 ||
+			parse_assigns( sep + strlen(HEDIT_RULE_SEPARATOR), Rules + NumRules ) <= 0
+		) {
+			fprintf(stderr, "Invalid rule at line %d of %s\n", lineno, filename);
+			goto error_rule;
+		}
+		NumRules++;
+	}
+	fclose(fp);
+
+	return NumRules;
+
+error_rule:
+	fclose(fp);
+	return -1;
+}
+
+/**
+ * @brief Parse the blank separated assignments field=value, the value can be quoted.
+ *
+ * @param list
+ * @param rule
+ * @return int
+ * @returns: number of the assignments on success
+ *          -1 on invalid assignment
+ */
+static int parse_assigns( char *list, HEDIT_RULE *rule )
+{
+	struct SAChead scratch = { 0 };
+	HEDIT_ASSIGN  *assign;
+	char          *name, *value;
+	char           quote;
+
+/* */
+	rule->nassigns = 0;
+	while ( *(list += strspn(list, " \t")) ) {
+		if ( rule->nassigns >= HEDIT_MAX_ASSIGNS ) {
+			fprintf(stderr, "Too many assignments, max is %d\n", HEDIT_MAX_ASSIGNS);
+			return -1;
+		}
+		assign = rule->assigns + rule->nassigns;
+	/* */
+		name = list;
+		if ( (value = strchr(name, '=')) == NULL ) {
+			fprintf(stderr, "Invalid assignment: %s\n", name);
+			return -1;
+		}
+		*value++ = '\0';
+		if ( (assign->field = sacfield_find( name )) == NULL ) {
+			fprintf(stderr, "Unknown header field: %s\n", name);
+			return -1;
+		}
+		if ( *value == '"' || *value == '\'' ) {
+			quote = *value++;
+			list  = value + strcspn(value, quote == '"' ? "\"" : "'");
+		}
+		else {
+			list  = value + strcspn(value, " \t");
+		}
+		if ( *list )
+			*list++ = '\0';
+		if ( strlen(value) >= SAC_FIELD_VALUE_LENGTH ) {
+			fprintf(stderr, "The value of %s is too long: %s\n", name, value);
+			return -1;
+		}
+		strcpy(assign->value, value);
+	/* The value check on the scratch header */
+		if ( apply_assign( &scratch, assign ) ) {
+			fprintf(stderr, "Invalid value of %s: %s\n", name, value);
+			return -1;
+		}
+		rule->nassigns++;
+	}
+
+	return rule->nassigns;
+}
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+static int proc_argv( int argc, char *argv[] )
+{
+	for ( int i = 1; i < argc; i++ ) {
+		if ( !strcmp(argv[i], "-v") ) {
+			fprintf(stdout, "%s\n", PROG_NAME);
+			fprintf(stdout, "Version: %s\n", VERSION);
+			fprintf(stdout, "Author:  %s\n", AUTHOR);
+			fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-h") ) {
+			usage();
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-r") && i < argc - 1 ) {
+			RuleFile = argv[++i];
+		}
+		else if ( !strcmp(argv[i], "-rn") ) {
+			RenameFlag = 1;
+		}
+		else if ( !strcmp(argv[i], "-n") ) {
+			DryRunFlag = 1;
+		}
+		else if ( !strcmp(argv[i], "-t") && i < argc - 1 ) {
+			NumThreads = atoi(argv[++i]);
+		}
+		else if ( argv[i][0] == '-' ) {
+			fprintf(stderr, "Unknown option: %s\n\n", argv[i]);
+			return -1;
+		}
+		else {
+		/* All the remained arguments are input files */
+			InputFiles = argv + i;
+			NumInputs  = argc - i;
+			break;
+		}
+	}
+/* */
+	if ( !RuleFile ) {
+		fprintf(stderr, "No rules file was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+	if ( !NumInputs ) {
+		fprintf(stderr, "No input file was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ */
+static void usage( void )
+{
+	fprintf(stdout, "\n%s\n", PROG_NAME);
+	fprintf(stdout, "Version: %s\n", VERSION);
+	fprintf(stdout, "Author:  %s\n", AUTHOR);
+	fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+	fprintf(stdout, "***************************\n");
+	fprintf(stdout, "Usage: %s -r <rules file> [options] <input SAC files...>\n\n", PROG_NAME);
+	fprintf(stdout,
+		"*** Options ***\n"
+		" -v             Report program version\n"
+		" -h             Show this usage message\n"
+		" -r rules_file  Specify the rules file, each line is the filter expression (the same as sac_hq)\n"
+		"                & the assignments separated by =>, e.g.\n"
+		"                  kcmpnm ~ HH? && knetwk == TW => kcmpnm=HL? cmpinc=90 user0=1.5\n"
+		"                each '?' of the string value keeps the original character at the position\n"
+		" -rn            Rename the modified files to sta.chan.net.loc in the same directory\n"
+		" -n             Dry run, only output the modifications\n"
+		" -t threads     Specify the number of threads, default is the number of processors\n"
+		"\n"
+		"This program will apply the rules to the headers of the input SAC files in place, only the headers\n"
+		"will be written & each file is either fully modified (& renamed) or untouched.\n"
+		"\n"
+	);
+
+	return;
+}
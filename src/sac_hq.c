@@ -0,0 +1,355 @@
+/**
+ * @file sac_hq.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#define _GNU_SOURCE  /* For nftw() */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <ftw.h>
+#include <sys/stat.h>
+/* */
+#include <sachead.h>
+#include <sac.h>
+#include <sacfield.h>
+#include <sacfilter.h>
+#include <batch.h>
+
+/* */
+#define PROG_NAME       "sac_hq"
+#define VERSION         "1.0.0 - 2026-10-18"
+#define AUTHOR          "Benjamin Ming Yang"
+/* */
+#define HQ_MAX_FIELDS     64
+#define HQ_CHUNK_FILES    4096
+#define HQ_DEF_FIELDS     "kstnm,kcmpnm,knetwk,khole,delta,npts,starttime,endtime"
+#define HQ_WALK_MAX_FDS   64
+/* */
+typedef struct {
+	struct SAChead sh;
+	int            matched;
+} HQ_RESULT;
+
+/* */
+static int  proc_argv( int , char * [] );
+static void usage( void );
+static int  walk_file_func( const char *, const struct stat *, int, struct FTW * );
+static int  append_file( const char * );
+static int  compare_path( const void *, const void * );
+static void query_job_func( void *, const int );
+static int  parse_field_list( const char * );
+static void print_result( const char *, const struct SAChead * );
+/* */
+static char      **InputPaths   = NULL;
+static int         NumPaths     = 0;
+static int         NumThreads   = 0;
+static char       *FilterExpr   = NULL;
+static char       *FieldList    = HQ_DEF_FIELDS;
+static int         NoHeaderRow  = 0;
+static SAC_FILTER  Filter;
+static const SAC_FIELD *Fields[HQ_MAX_FIELDS];
+static int         NumFields    = 0;
+static char      **Files        = NULL;
+static int         NumFiles     = 0;
+static int         FileCapacity = 0;
+static HQ_RESULT  *Results      = NULL;
+static int         ChunkBase    = 0;
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main( int argc, char **argv )
+{
+	struct stat st;
+	int         result   = -1;
+	int         nmatched = 0;
+	int         nchunk;
+
+/* Check command line arguments */
+	if ( proc_argv( argc, argv ) ) {
+		usage();
+		return -1;
+	}
+/* Compile the filter & resolve the output fields once */
+	if ( sacfilter_compile( FilterExpr, &Filter ) < 0 || parse_field_list( FieldList ) )
+		return -1;
+/* Walk the directories, the files will be sorted, so the output order is stable */
+	for ( int i = 0; i < NumPaths; i++ ) {
+		if ( stat(InputPaths[i], &st) ) {
+			fprintf(stderr, "Error accessing %s: %s\n", InputPaths[i], strerror(errno));
+			continue;
+		}
+		if ( S_ISDIR(st.st_mode) ) {
+			if ( nftw(InputPaths[i], walk_file_func, HQ_WALK_MAX_FDS, FTW_PHYS) )
+				goto end_process;
+		}
+		else if ( append_file( InputPaths[i] ) ) {
+			goto end_process;
+		}
+	}
+	qsort(Files, NumFiles, sizeof(char *), compare_path);
+	if ( (Results = (HQ_RESULT *)calloc(HQ_CHUNK_FILES, sizeof(HQ_RESULT))) == NULL ) {
+		fprintf(stderr, "ERROR! Out of memory for %d headers\n", HQ_CHUNK_FILES);
+		result = -2;
+		goto end_process;
+	}
+/* The header row */
+	if ( !NoHeaderRow ) {
+		fprintf(stdout, "file");
+		for ( int i = 0; i < NumFields; i++ )
+			fprintf(stdout, "\t%s", Fields[i]->name);
+		fprintf(stdout, "\n");
+	}
+/* The headers are read by chunks, so the memory is bounded for any number of files */
+	for ( ChunkBase = 0; ChunkBase < NumFiles; ChunkBase += nchunk ) {
+		nchunk = NumFiles - ChunkBase < HQ_CHUNK_FILES ? NumFiles - ChunkBase : HQ_CHUNK_FILES;
+		batch_jobs_run( nchunk, NumThreads, query_job_func, NULL );
+		for ( int i = 0; i < nchunk; i++ ) {
+			if ( Results[i].matched ) {
+				print_result( Files[ChunkBase + i], &Results[i].sh );
+				nmatched++;
+			}
+		}
+	}
+	fprintf(stderr, "%d of %d files matched!\n", nmatched, NumFiles);
+	result = 0;
+
+end_process:
+	for ( int i = 0; i < NumFiles; i++ )
+		free(Files[i]);
+	free(Files);
+	free(Results);
+
+	return result;
+}
+
+/**
+ * @brief Read only the header of each file & evaluate the filter, it will be called by the batch threads.
+ *
+ * @param arg
+ * @param index
+ */
+static void query_job_func( void *arg, const int index )
+{
+	HQ_RESULT *result = Results + index;
+	int        fd;
+
+/* */
+	result->matched = 0;
+	if ( (fd = open(Files[ChunkBase + index], O_RDONLY)) < 0 ) {
+		fprintf(stderr, "Error opening %s\n", Files[ChunkBase + index]);
+		return;
+	}
+	if ( sac_header_pread( fd, &result->sh ) >= 0 )
+		result->matched = sacfilter_match( &Filter, &result->sh );
+	close(fd);
+
+	return;
+}
+
+/**
+ * @brief
+ *
+ * @param path
+ * @param sh
+ */
+static void print_result( const char *path, const struct SAChead *sh )
+{
+	char value[SAC_FIELD_VALUE_LENGTH];
+
+/* */
+	fprintf(stdout, "%s", path);
+	for ( int i = 0; i < NumFields; i++ ) {
+		sacfield_value_print( sh, Fields[i], value, sizeof(value) );
+		fprintf(stdout, "\t%s", value);
+	}
+	fprintf(stdout, "\n");
+
+	return;
+}
+
+/**
+ * @brief The callback of the directory walk, only the regular files which can hold the header
+ *        will be appended.
+ *
+ * @param path
+ * @param st
+ * @param type
+ * @param ftw
+ * @return int
+ */
+static int walk_file_func( const char *path, const struct stat *st, int type, struct FTW *ftw )
+{
+	if ( type == FTW_F && S_ISREG(st->st_mode) && st->st_size >= (off_t)sizeof(struct SAChead) )
+		return append_file( path );
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ * @param path
+ * @return int
+ */
+static int append_file( const char *path )
+{
+	char **files;
+
+/* */
+	if ( NumFiles >= FileCapacity ) {
+		FileCapacity = FileCapacity ? FileCapacity << 1 : 1024;
+		if ( (files = (char **)realloc(Files, FileCapacity * sizeof(char *))) == NULL ) {
+			fprintf(stderr, "ERROR! Out of memory for %d files\n", FileCapacity);
+			return -2;
+		}
+		Files = files;
+	}
+	if ( (Files[NumFiles] = strdup(path)) == NULL ) {
+		fprintf(stderr, "ERROR! Out of memory for the path %s\n", path);
+		return -2;
+	}
+	NumFiles++;
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ * @param a
+ * @param b
+ * @return int
+ */
+static int compare_path( const void *a, const void *b )
+{
+	return strcmp(*(char **)a, *(char **)b);
+}
+
+/**
+ * @brief Resolve the comma separated field names.
+ *
+ * @param list
+ * @return int
+ */
+static int parse_field_list( const char *list )
+{
+	char  buffer[HQ_MAX_FIELDS * SAC_FIELD_NAME_LENGTH];
+	char *save = NULL;
+
+/* */
+	strncpy(buffer, list, sizeof(buffer) - 1);
+	buffer[sizeof(buffer) - 1] = '\0';
+	for ( char *name = strtok_r(buffer, ",", &save); name; name = strtok_r(NULL, ",", &save) ) {
+		if ( NumFields >= HQ_MAX_FIELDS ) {
+			fprintf(stderr, "Too many output fields, max is %d\n", HQ_MAX_FIELDS);
+			return -1;
+		}
+		if ( (Fields[NumFields++] = sacfield_find( name )) == NULL ) {
+			fprintf(stderr, "Unknown header field: %s\n", name);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+static int proc_argv( int argc, char *argv[] )
+{
+	for ( int i = 1; i < argc; i++ ) {
+		if ( !strcmp(argv[i], "-v") ) {
+			fprintf(stdout, "%s\n", PROG_NAME);
+			fprintf(stdout, "Version: %s\n", VERSION);
+			fprintf(stdout, "Author:  %s\n", AUTHOR);
+			fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-h") ) {
+			usage();
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-w") && i < argc - 1 ) {
+			FilterExpr = argv[++i];
+		}
+		else if ( !strcmp(argv[i], "-f") && i < argc - 1 ) {
+			FieldList = argv[++i];
+		}
+		else if ( !strcmp(argv[i], "-nh") ) {
+			NoHeaderRow = 1;
+		}
+		else if ( !strcmp(argv[i], "-t") && i < argc - 1 ) {
+			NumThreads = atoi(argv[++i]);
+		}
+		else if ( argv[i][0] == '-' ) {
+			fprintf(stderr, "Unknown option: %s\n\n", argv[i]);
+			return -1;
+		}
+		else {
+		/* All the remained arguments are input files or directories */
+			InputPaths = argv + i;
+			NumPaths   = argc - i;
+			break;
+		}
+	}
+/* */
+	if ( !NumPaths ) {
+		fprintf(stderr, "No input file or directory was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ */
+static void usage( void )
+{
+	fprintf(stdout, "\n%s\n", PROG_NAME);
+	fprintf(stdout, "Version: %s\n", VERSION);
+	fprintf(stdout, "Author:  %s\n", AUTHOR);
+	fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+	fprintf(stdout, "***************************\n");
+	fprintf(stdout, "Usage: %s [options] <input SAC files or directories...>\n\n", PROG_NAME);
+	fprintf(stdout,
+		"*** Options ***\n"
+		" -v             Report program version\n"
+		" -h             Show this usage message\n"
+		" -w expression  Specify the filter expression of the header fields, e.g.\n"
+		"                  'kcmpnm ~ HL? && delta == 0.01 && npts < 1000 && starttime >= 2024-04-01T00:00:00'\n"
+		"                the operators are || && ! ( ) == != < <= > >= and ~ !~ (glob pattern)\n"
+		" -f fields      Specify the comma separated output fields, default is\n"
+		"                " HQ_DEF_FIELDS "\n"
+		"                starttime, endtime & origin are the absolute time in epoch seconds\n"
+		" -nh            Don't output the header row\n"
+		" -t threads     Specify the number of threads, default is the number of processors\n"
+		"\n"
+		"This program will walk the input directories, read only the headers of the SAC files & output\n"
+		"the fields of those matched the filter as TSV.\n"
+		"\n"
+	);
+
+	return;
+}
@@ -13,10 +13,14 @@
 #include <string.h>
 #include <stdint.h>
 #include <errno.h>
+#include <unistd.h>
 /* */
 #include <sachead.h>
 #include <sac.h>
 #include <iirfilter.h>
+#include <peaktrack.h>
+#include <baseline.h>
+#include <stadb.h>
 
 /* */
 #define PROG_NAME       "sac_int"
@@ -26,14 +30,33 @@
 #define HP_FILTER_OFF  0
 #define HP_FILTER_ON   1
 #define HP_FILTER_ZP   2
+/* */
+typedef struct {
+	float half_delta;
+	float last_raw;
+	float last_proc;
+} INTEGRATOR;
+
 /* */
 static int  proc_argv( int , char * [] );
 static void usage( void );
+static int  integrate_chunked( void );
+static void integrate_block( float *, const int, INTEGRATOR *, const IIR_FILTER *, IIR_STAGE * );
+static void filter_block( float *, const int, const IIR_FILTER *, IIR_STAGE * );
+static void peak_block( float *, const int, PEAK_TRACKER * );
+static void reverse_block( float *, const int );
 /* */
 static float   GainFactor = 1.0;
 static char   *InputFile  = NULL;
 static char   *OutputFile = NULL;
 static uint8_t FilterFlag = HP_FILTER_OFF;
+static double  PeakWindow = 0.0;
+static int     BaseOrder  = 0;
+static double  PreEventEnd    = 0.0;
+static double  PostEventStart = 0.0;
+static char   *StationDB  = NULL;
+static int     GainGiven  = 0;
+static int     ChunkSize  = 0;
 
 /**
  * @brief
@@ -44,33 +67,48 @@ static uint8_t FilterFlag = HP_FILTER_OFF;
  */
 int main( int argc, char **argv )
 {
-	int      npts, datalen;
+	int      npts;
 	int      result    = -1;
 	FILE    *ofp       = stdout;
-	uint8_t *outbuf    = NULL;
-	float   *seis_raw  = NULL;
-	float   *seis_proc = NULL;
-	float    half_delta;
-	float    last_raw, last_proc;
+	float   *seis      = NULL;
 
 	struct SAChead sh;
 	IIR_FILTER     filter;
 	IIR_STAGE     *stage = NULL;
+	STADB          stadb = { 0 };
+	INTEGRATOR     integ;
+
+	const STADB_ENTRY *entry;
 
 /* Check command line arguments */
 	if ( proc_argv( argc, argv ) ) {
 		usage();
 		return -1;
 	}
+/* The whole file won't be loaded in the chunked mode */
+	if ( ChunkSize > 0 )
+		return integrate_chunked();
 
 /* Load the SAC file to local memory */
-	if ( sac_file_load( InputFile, &sh, &seis_raw ) < 0 )
+	if ( sac_file_load( InputFile, &sh, &seis ) < 0 )
 		goto end_process;
 /* Then check the sampling rate, it should not larger than 1000 Hz */
 	if ( sh.delta < 0.001 ) {
 		fprintf(stderr, "SAC file: %s sample delta too small: %f\n", InputFile, sh.delta);
 		goto end_process;
 	}
+/* Pull the gain & the station metadata from the database, the gain from -g will be kept */
+	if ( StationDB ) {
+		if ( stadb_open( StationDB, &stadb ) < 0 )
+			goto end_process;
+		if ( (entry = stadb_find_sac( &stadb, &sh )) == NULL ) {
+			fprintf(stderr, "Can't find %s in the station database %s!\n", sac_scnl_print( &sh ), StationDB);
+			goto end_process;
+		}
+		stadb_header_fill( &sh, entry );
+		if ( !GainGiven )
+			GainFactor = entry->gain;
+	}
 /* For Recursive Filter high pass 2 poles at 0.075 Hz */
 	filter = iirfilter_design( 2, IIR_HIGHPASS_FILTER, IIR_BUTTERWORTH, 0.075, 0.0, sh.delta );
 	stage  = (IIR_STAGE *)calloc(filter.nsects, sizeof(IIR_STAGE));
@@ -82,31 +120,40 @@ int main( int argc, char **argv )
 		InputFile, sh.nzyear, sh.nzjday, sh.nzhour, sh.nzmin, sh.nzsec, sh.nzmsec, (double)sh.b + sac_reftime_fetch( &sh )
 	);
 /* Setup some parameters which will be used later */
-	npts       = (int)sh.npts;
-	half_delta = sh.delta * 0.5;
-	datalen    = npts * sizeof(float);
-	outbuf     = malloc(sizeof(struct SAChead) + datalen);
-	seis_proc  = (float *)(outbuf + sizeof(struct SAChead));
-/* Copy the original header to the new buffer */
-	memcpy(outbuf, (char *)&sh, sizeof(struct SAChead));
+	npts = (int)sh.npts;
+	integ.half_delta = sh.delta * 0.5;
+	integ.last_raw   = 0.0;
+	integ.last_proc  = 0.0;
 /* First, preprocess the raw seismic data */
-	sac_data_preprocess( &sh, seis_raw, GainFactor );
-/* Then, do the integration */
-	last_raw  = 0.0;
-	last_proc = 0.0;
-	for ( int i = 0; i < npts; i++ ) {
-		seis_proc[i] = (seis_raw[i] + last_raw) * half_delta + last_proc;
-		last_raw  = seis_raw[i];
-		last_proc = seis_proc[i];
-	/* First time, forward filtering */
+	sac_data_preprocess( &sh, seis, GainFactor );
+/* Then, do the integration & the first time forward filtering, it will be done after the baseline correction if needed */
+	integrate_block( seis, npts, &integ, FilterFlag && !BaseOrder && PostEventStart <= 0.0 ? &filter : NULL, stage );
+/* The baseline correction of the integrated result, segmented one first then the polynomial */
+	if ( BaseOrder || PostEventStart > 0.0 ) {
+		if (
+			PostEventStart > 0.0 &&
+			baseline_segment_remove( seis, npts, (int)((PreEventEnd - sh.b) / sh.delta + 0.5), (int)((PostEventStart - sh.b) / sh.delta + 0.5) )
+		) {
+			fprintf(stderr, "Invalid pre-event (%.3f) & post-event (%.3f) time for %s\n", PreEventEnd, PostEventStart, InputFile);
+			goto end_process;
+		}
+		if ( BaseOrder && baseline_poly_remove( seis, npts, BaseOrder ) ) {
+			fprintf(stderr, "Error removing the polynomial baseline of %s\n", InputFile);
+			goto end_process;
+		}
 		if ( FilterFlag )
-			seis_proc[i] = iirfilter_apply( seis_proc[i], &filter, stage );
+			filter_block( seis, npts, &filter, stage );
 	}
 /* Second time, backward filtering if needed! */
 	if ( FilterFlag == HP_FILTER_ZP ) {
 		memset(stage, 0, sizeof(IIR_STAGE) * filter.nsects);
 		for ( int i = npts - 1; i >= 0; i-- )
-			seis_proc[i] = iirfilter_apply( seis_proc[i], &filter, stage );
+			seis[i] = iirfilter_apply( seis[i], &filter, stage );
+	}
+/* Replace the result with its running peak over the last window if needed */
+	if ( PeakWindow > 0.0 && peaktrack_running_absmax( seis, npts, (int)(PeakWindow / sh.delta + 0.5), seis ) ) {
+		fprintf(stderr, "Error tracking the running peak of %s\n", InputFile);
+		goto end_process;
 	}
 
 /* If user chose to output the result to local file, then open the file descript to write */
@@ -114,10 +161,8 @@ int main( int argc, char **argv )
 		fprintf(stderr, "ERROR!! Can't open %s for output! Exiting!\n", OutputFile);
 		exit(-1);
 	}
-/* Real output block, write the output buffer to SAC file */
-	datalen += sizeof(struct SAChead);
-	if ( fwrite(outbuf, 1, datalen, ofp) != datalen ) {
-		fprintf(stderr, "Error writing SAC file: %s\n", strerror(errno));
+/* Real output block, write the header & the result straight from the loaded buffer */
+	if ( sac_file_writev( fileno(ofp), &sh, seis ) ) {
 		if ( OutputFile )
 			remove(OutputFile);
 	}
@@ -129,16 +174,261 @@ int main( int argc, char **argv )
 end_process:
 	if ( ofp != stdout )
 		fclose(ofp);
-	if ( seis_raw )
-		free(seis_raw);
-	if ( outbuf )
-		free(outbuf);
+	if ( seis )
+		bufpool_free( seis );
+	if ( stage )
+		free(stage);
+	stadb_close( &stadb );
+
+	return result;
+}
+
+/**
+ * @brief Integrate the input file block by block, only one block is kept in memory. The states of
+ *        the integration, the filter & the peak tracker are carried across the blocks, so the result
+ *        is bit-identical to the one of the in-memory path. For the zero phase filter, the forward
+ *        result is put into the temporary file in the reversed order, so the backward filtering can
+ *        also be done by reading it sequentially.
+ *
+ * @return int
+ */
+static int integrate_chunked( void )
+{
+	int      nread;
+	int      npts;
+	int      done;
+	int      ngaps  = 0;
+	int      result = -1;
+	FILE    *ofp    = stdout;
+	FILE    *tfp    = NULL;
+	float   *block  = NULL;
+	float    mean;
+	size_t   size;
+	off_t    offset;
+
+	struct SAChead sh;
+	SAC_STREAM     stream  = { 0 };
+	IIR_FILTER     filter;
+	IIR_STAGE     *stage   = NULL;
+	STADB          stadb   = { 0 };
+	PEAK_TRACKER   tracker = { 0 };
+	INTEGRATOR     integ;
+
+	const STADB_ENTRY *entry;
+
+/* Only the header, the samples will be read by blocks */
+	if ( sac_stream_open( InputFile, &sh, &stream ) < 0 )
+		return -1;
+	if ( sh.delta < 0.001 ) {
+		fprintf(stderr, "SAC file: %s sample delta too small: %f\n", InputFile, sh.delta);
+		goto end_process;
+	}
+	if ( StationDB ) {
+		if ( stadb_open( StationDB, &stadb ) < 0 )
+			goto end_process;
+		if ( (entry = stadb_find_sac( &stadb, &sh )) == NULL ) {
+			fprintf(stderr, "Can't find %s in the station database %s!\n", sac_scnl_print( &sh ), StationDB);
+			goto end_process;
+		}
+		stadb_header_fill( &sh, entry );
+		if ( !GainGiven )
+			GainFactor = entry->gain;
+	}
+/* The mean should be known before any block is processed */
+	if ( sac_stream_mean_scan( &stream, &sh, GainFactor, &mean ) )
+		goto end_process;
+	filter = iirfilter_design( 2, IIR_HIGHPASS_FILTER, IIR_BUTTERWORTH, 0.075, 0.0, sh.delta );
+	if (
+		(stage = (IIR_STAGE *)calloc(filter.nsects, sizeof(IIR_STAGE))) == NULL ||
+		(block = (float *)bufpool_alloc((size_t)ChunkSize * sizeof(float))) == NULL
+	) {
+		fprintf(stderr, "ERROR! Out of memory for the block of %d samples\n", ChunkSize);
+		result = -2;
+		goto end_process;
+	}
+	if ( PeakWindow > 0.0 && peaktrack_init( &tracker, (int)(PeakWindow / sh.delta + 0.5) ) ) {
+		fprintf(stderr, "Error tracking the running peak of %s\n", InputFile);
+		goto end_process;
+	}
+	if ( FilterFlag == HP_FILTER_ZP && (tfp = tmpfile()) == (FILE *)NULL ) {
+		fprintf(stderr, "ERROR!! Can't open the temporary file: %s\n", strerror(errno));
+		goto end_process;
+	}
+	if ( OutputFile && (ofp = fopen(OutputFile, "wb")) == (FILE *)NULL ) {
+		fprintf(stderr, "ERROR!! Can't open %s for output! Exiting!\n", OutputFile);
+		goto end_process;
+	}
+	fprintf(
+		stderr, "SAC file: %s start at %4.4d,%3.3d,%2.2d:%2.2d:%2.2d.%4.4d %f\n",
+		InputFile, sh.nzyear, sh.nzjday, sh.nzhour, sh.nzmin, sh.nzsec, sh.nzmsec, (double)sh.b + sac_reftime_fetch( &sh )
+	);
+	if ( fwrite(&sh, 1, sizeof(struct SAChead), ofp) != sizeof(struct SAChead) )
+		goto write_error;
+/* First pass, the output of the causal path can be written directly */
+	npts = (int)sh.npts;
+	integ.half_delta = sh.delta * 0.5;
+	integ.last_raw   = 0.0;
+	integ.last_proc  = 0.0;
+	for ( done = 0; (nread = sac_stream_read( &stream, block, ChunkSize )) > 0; done += nread ) {
+		size   = (size_t)nread * sizeof(float);
+		ngaps += sac_block_preprocess( block, nread, GainFactor, mean );
+		integrate_block( block, nread, &integ, FilterFlag ? &filter : NULL, stage );
+		if ( tfp ) {
+			reverse_block( block, nread );
+			offset = (off_t)(npts - done - nread) * sizeof(float);
+			if ( pwrite(fileno(tfp), block, size, offset) != (ssize_t)size )
+				goto write_error;
+		}
+		else {
+			if ( tracker.window )
+				peak_block( block, nread, &tracker );
+			if ( fwrite(block, 1, size, ofp) != size )
+				goto write_error;
+		}
+	}
+	if ( nread < 0 )
+		goto end_process;
+	fprintf(stderr, "Found %d gaps within total %d samples in %s, filled with 0.0!\n", ngaps, npts, sac_scnl_print( &sh ));
+/*
+ * Second pass, the reversed samples are filtered sequentially which is the backward filtering, the
+ * result is put back in the forward order after the reversed ones, then it will be output by the
+ * third pass with the running peak if needed
+ */
+	if ( tfp ) {
+		memset(stage, 0, sizeof(IIR_STAGE) * filter.nsects);
+		for ( done = 0; done < npts; done += nread ) {
+			nread = npts - done < ChunkSize ? npts - done : ChunkSize;
+			size  = (size_t)nread * sizeof(float);
+			if ( pread(fileno(tfp), block, size, (off_t)done * sizeof(float)) != (ssize_t)size )
+				goto read_error;
+			filter_block( block, nread, &filter, stage );
+			reverse_block( block, nread );
+			offset = ((off_t)npts * 2 - done - nread) * sizeof(float);
+			if ( pwrite(fileno(tfp), block, size, offset) != (ssize_t)size )
+				goto write_error;
+		}
+		for ( done = 0; done < npts; done += nread ) {
+			nread = npts - done < ChunkSize ? npts - done : ChunkSize;
+			size  = (size_t)nread * sizeof(float);
+			if ( pread(fileno(tfp), block, size, ((off_t)npts + done) * sizeof(float)) != (ssize_t)size )
+				goto read_error;
+			if ( tracker.window )
+				peak_block( block, nread, &tracker );
+			if ( fwrite(block, 1, size, ofp) != size )
+				goto write_error;
+		}
+	}
+	if ( fflush(ofp) )
+		goto write_error;
+	fprintf(stderr, "SAC file: %s integration finished!\n", InputFile);
+	result = 0;
+	goto end_process;
+
+read_error:
+	fprintf(stderr, "Error reading the temporary file: %s\n", strerror(errno));
+	goto end_process;
+write_error:
+	fprintf(stderr, "Error writing SAC file: %s\n", strerror(errno));
+end_process:
+	if ( result && OutputFile && ofp != stdout )
+		remove(OutputFile);
+	if ( ofp != stdout )
+		fclose(ofp);
+	if ( tfp )
+		fclose(tfp);
+	if ( block )
+		bufpool_free( block );
 	if ( stage )
 		free(stage);
+	peaktrack_free( &tracker );
+	sac_stream_close( &stream );
+	stadb_close( &stadb );
 
 	return result;
 }
 
+/**
+ * @brief Integrate the block in place, the recurrence only needs the previous raw sample & the
+ *        previous unfiltered result, so both of them are kept in the integrator. The result will
+ *        be forward filtered if the filter is given.
+ *
+ * @param seis
+ * @param nsamp
+ * @param integ
+ * @param filter
+ * @param stage
+ */
+static void integrate_block( float *seis, const int nsamp, INTEGRATOR *integ, const IIR_FILTER *filter, IIR_STAGE *stage )
+{
+	float raw;
+
+/* */
+	for ( int i = 0; i < nsamp; i++ ) {
+		raw              = seis[i];
+		seis[i]          = (raw + integ->last_raw) * integ->half_delta + integ->last_proc;
+		integ->last_raw  = raw;
+		integ->last_proc = seis[i];
+		if ( filter )
+			seis[i] = iirfilter_apply( seis[i], filter, stage );
+	}
+
+	return;
+}
+
+/**
+ * @brief
+ *
+ * @param seis
+ * @param nsamp
+ * @param filter
+ * @param stage
+ */
+static void filter_block( float *seis, const int nsamp, const IIR_FILTER *filter, IIR_STAGE *stage )
+{
+	for ( int i = 0; i < nsamp; i++ )
+		seis[i] = iirfilter_apply( seis[i], filter, stage );
+
+	return;
+}
+
+/**
+ * @brief Replace the block with its running peak, it is the same as peaktrack_running_absmax()
+ *        but the tracker is carried across the blocks.
+ *
+ * @param seis
+ * @param nsamp
+ * @param tracker
+ */
+static void peak_block( float *seis, const int nsamp, PEAK_TRACKER *tracker )
+{
+	for ( int i = 0; i < nsamp; i++ ) {
+		peaktrack_push( tracker, seis[i] );
+		seis[i] = peaktrack_absmax( tracker );
+	}
+
+	return;
+}
+
+/**
+ * @brief
+ *
+ * @param seis
+ * @param nsamp
+ */
+static void reverse_block( float *seis, const int nsamp )
+{
+	float temp;
+
+/* */
+	for ( int i = 0, j = nsamp - 1; i < j; i++, j-- ) {
+		temp    = seis[i];
+		seis[i] = seis[j];
+		seis[j] = temp;
+	}
+
+	return;
+}
+
 /**
  * @brief
  *
@@ -162,6 +452,10 @@ static int proc_argv( int argc, char *argv[] )
 		}
 		else if ( !strcmp(argv[i], "-g") ) {
 			GainFactor = atof(argv[++i]);
+			GainGiven  = 1;
+		}
+		else if ( !strcmp(argv[i], "-db") ) {
+			StationDB = argv[++i];
 		}
 		else if ( !strcmp(argv[i], "-f") ) {
 			FilterFlag = HP_FILTER_ON;
@@ -169,6 +463,26 @@ static int proc_argv( int argc, char *argv[] )
 		else if ( !strcmp(argv[i], "-fz") ) {
 			FilterFlag = HP_FILTER_ZP;
 		}
+		else if ( !strcmp(argv[i], "-pk") ) {
+			PeakWindow = atof(argv[++i]);
+		}
+		else if ( !strcmp(argv[i], "-bl") ) {
+			BaseOrder = atoi(argv[++i]);
+			if ( BaseOrder < BASELINE_MIN_ORDER || BaseOrder > BASELINE_MAX_ORDER ) {
+				fprintf(stderr, "The order of baseline should be %d ~ %d!\n\n", BASELINE_MIN_ORDER, BASELINE_MAX_ORDER);
+				return -1;
+			}
+		}
+		else if ( !strcmp(argv[i], "-bs") ) {
+			PreEventEnd    = atof(argv[++i]);
+			PostEventStart = atof(argv[++i]);
+		}
+		else if ( !strcmp(argv[i], "-ck") ) {
+			if ( (ChunkSize = atoi(argv[++i])) <= 0 ) {
+				fprintf(stderr, "The block size should be positive!\n\n");
+				return -1;
+			}
+		}
 		else if ( i == argc - 1 ) {
 #ifdef _WINNT
 			usage();
@@ -194,6 +508,16 @@ static int proc_argv( int argc, char *argv[] )
 		fprintf(stderr, "exiting with error!\n\n");
 		return -1;
 	}
+	if ( ChunkSize > 0 && (BaseOrder || PostEventStart > 0.0) ) {
+		fprintf(stderr, "The baseline correction needs the whole trace, it can't be done in the chunked mode; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+	if ( ChunkSize > 0 && !strcmp(InputFile, "-") ) {
+		fprintf(stderr, "The chunked mode reads the input twice, it can't be done with the standard input; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
 
 	return 0;
 }
@@ -216,10 +540,19 @@ static void usage( void )
 		" -v             Report program version\n"
 		" -h             Show this usage message\n"
 		" -g gain_factor Specify the gain factor, it should be floating value\n"
+		" -db station_db Take the gain, coordinates & orientation from the station list or snapshot\n"
 		" -f             Turn on the high pass filter at 0.075 Hz\n"
 		" -fz            Turn on the zero phase high pass filter at 0.075 Hz\n"
+		" -pk window     Output the running peak absolute value over the last window in sec\n"
+		" -bl order      Remove the least-squares polynomial baseline (order 1 ~ 6) of the result\n"
+		" -bs t1 t2      Remove the segmented baseline of the result, pre-event mean before t1 &\n"
+		"                post-event line after t2 (sec relative to the reference time)\n"
+		" -ck block      Integrate block by block with the block size in samples (e.g. 1048576), only\n"
+		"                one block is kept in memory, the baseline correction can't be applied & the\n"
+		"                input can't be the standard input\n"
 		"\n"
 		"This program will integral the input SAC file once.\n"
+		"The input SAC file can be '-' to read from the standard input, except in the chunked mode.\n"
 		"\n"
 	);
 
@@ -16,6 +16,7 @@
 /* */
 #include <sachead.h>
 #include <sac.h>
+#include <stadb.h>
 
 /* */
 #define PROG_NAME       "sac_mscnl"
@@ -33,6 +34,7 @@ static char *NewNet     = NULL;
 static char *NewLoc     = NULL;
 static char *NewCompAz  = NULL;
 static char *NewCompInc = NULL;
+static char *StationDB  = NULL;
 
 /**
  * @brief
@@ -49,6 +51,9 @@ int main( int argc, char **argv )
 	int            size = 0;
 	int            result = -1;
 	char           orig_scnl[SAC_MAX_SCNL_LENGTH] = { 0 };
+	STADB          stadb = { 0 };
+
+	const STADB_ENTRY *entry;
 
 /* Check command line arguments */
 	if ( proc_argv( argc, argv ) ) {
@@ -63,7 +68,24 @@ int main( int argc, char **argv )
 /* The main process, include SCNL, azimuth & inclination modify */
 	strcpy(orig_scnl, sac_scnl_print( &sh ));
 	sac_scnl_modify( &sh, NewSta, NewChan, NewNet, NewLoc );
-	sac_az_inc_modify( &sh, NewCompAz ? atof(NewCompAz) : SACUNDEF, NewCompInc ? atof(NewCompInc) : SACUNDEF );
+/*
+ * Then the coordinates & orientation of the new SCNL from the station database, only the explicit
+ * -ca & -ci will override the orientation of the database
+ */
+	if ( StationDB ) {
+		if ( stadb_open( StationDB, &stadb ) < 0 )
+			goto end_process;
+		if ( (entry = stadb_find_sac( &stadb, &sh )) == NULL ) {
+			fprintf(stderr, "Can't find %s in the station database %s!\n", sac_scnl_print( &sh ), StationDB);
+			goto end_process;
+		}
+		stadb_header_fill( &sh, entry );
+		if ( NewCompAz || NewCompInc )
+			sac_az_inc_modify( &sh, NewCompAz ? atof(NewCompAz) : entry->cmpaz, NewCompInc ? atof(NewCompInc) : entry->cmpinc );
+	}
+	else {
+		sac_az_inc_modify( &sh, NewCompAz ? atof(NewCompAz) : SACUNDEF, NewCompInc ? atof(NewCompInc) : SACUNDEF );
+	}
 
 /* If user chose to output the result to local file, then open the file descript to write */
 	if ( OutputFile && (ofp = fopen(OutputFile, "wb")) == (FILE *)NULL ) {
@@ -93,7 +115,8 @@ end_process:
 	if ( ofp != stdout )
 		fclose(ofp);
 	if ( seis )
-		free(seis);
+		bufpool_free( seis );
+	stadb_close( &stadb );
 
 	return result;
 }
@@ -137,6 +160,9 @@ static int proc_argv( int argc, char *argv[] )
 		else if ( !strcmp(argv[i], "-ci") ) {
 			NewCompInc = argv[++i];
 		}
+		else if ( !strcmp(argv[i], "-db") ) {
+			StationDB = argv[++i];
+		}
 		else if ( i == argc - 1 ) {
 #ifdef _WINNT
 			usage();
@@ -157,8 +183,8 @@ static int proc_argv( int argc, char *argv[] )
 		}
 	}
 /* Not any change defined */
-	if ( !NewSta && !NewChan && !NewNet && !NewLoc ) {
-		fprintf(stderr, "No new SCNL was specified; ");
+	if ( !NewSta && !NewChan && !NewNet && !NewLoc && !StationDB ) {
+		fprintf(stderr, "No new SCNL or station database was specified; ");
 		fprintf(stderr, "exiting with error!\n\n");
 		return -1;
 	}
@@ -195,8 +221,10 @@ static void usage( void )
 		" -l location_code Specify the new location code, max length is 8\n"
 		" -ca azimuth      Specify the new component azimuth in deg (0-360)\n"
 		" -ci inclination  Specify the new component inclination in deg(0-180)\n"
+		" -db station_db   Fill the coordinates & orientation of the new SCNL from the station list or snapshot\n"
 		"\n"
 		"This program will change the SCNL of the input SAC file.\n"
+		"The input SAC file can be '-' to read from the standard input.\n"
 		"\n"
 	);
 
@@ -17,6 +17,8 @@
 /* */
 #include <sachead.h>
 #include <sac.h>
+#include <despike.h>
+#include <stadb.h>
 /* */
 #define PROG_NAME       "sac_preproc"
 #define VERSION         "1.0.1 - 2024-04-04"
@@ -24,10 +26,16 @@
 /* */
 static int  proc_argv( int, char * [] );
 static void usage( void );
+static int  despike_gapmap( struct SAChead *, float *, const SAC_GAP_MAP *, int * );
 /* */
 static float GainFactor = 1.0;
 static char *InputFile  = NULL;
 static char *OutputFile = NULL;
+static char *ReportFile = NULL;
+static float DespikeWin = 0.0;
+static float DespikeFac = DESPIKE_DEF_FACTOR;
+static char *StationDB  = NULL;
+static int   GainGiven  = 0;
 
 /**
  * @brief
@@ -39,11 +47,15 @@ static char *OutputFile = NULL;
 int main( int argc, char **argv )
 {
 	struct SAChead sh;
+	SAC_GAP_MAP gapmap = { 0 };
+	STADB       stadb  = { 0 };
+	const STADB_ENTRY *entry;
 	FILE    *ofp    = stdout;
-	uint8_t *outbuf = NULL;
+	FILE    *rfp    = NULL;
 	float   *seis   = NULL;
 	int      result = -1;
-	int      datalen;
+	int      nspikes;
+	int      nskipped;
 
 /* Check command line arguments */
 	if ( proc_argv( argc, argv ) ) {
@@ -51,31 +63,60 @@ int main( int argc, char **argv )
 		return -1;
 	}
 
-/* Load the SAC file to local memory */
-	if ( sac_file_load( InputFile, &sh, &seis ) < 0 )
+/* Load the SAC file to local memory, the gap map is built within the loading */
+	if ( sac_file_load_gapmap( InputFile, &sh, &seis, &gapmap ) < 0 )
 		goto end_process;
 	fprintf(
 		stderr, "SAC file: %s start at %4.4d,%3.3d,%2.2d:%2.2d:%2.2d.%4.4d %f\n",
 		InputFile, sh.nzyear, sh.nzjday, sh.nzhour, sh.nzmin, sh.nzsec, sh.nzmsec, (double)sh.b + sac_reftime_fetch( &sh )
 	);
-/* Allocate the output buffer */
-	datalen = (int)sh.npts * sizeof(float);
-	outbuf  = malloc(sizeof(struct SAChead) + datalen);
-	memcpy(outbuf, (char *)&sh, sizeof(struct SAChead));
-
-/* The main process & copy the result to output buffer */
-	sac_data_preprocess( &sh, seis, GainFactor );
-	memcpy(outbuf + sizeof(struct SAChead), seis, datalen);
+/* Pull the gain & the station metadata from the database, the gain from -g will be kept */
+	if ( StationDB ) {
+		if ( stadb_open( StationDB, &stadb ) < 0 )
+			goto end_process;
+		if ( (entry = stadb_find_sac( &stadb, &sh )) == NULL ) {
+			fprintf(stderr, "Can't find %s in the station database %s!\n", sac_scnl_print( &sh ), StationDB);
+			goto end_process;
+		}
+		stadb_header_fill( &sh, entry );
+		if ( !GainGiven )
+			GainFactor = entry->gain;
+	}
+/*
+ * First, the despike stage on the raw data, the number of replaced spikes will be recorded in the
+ * header (user9) & the number of the unchecked samples within the too short spans (user8)
+ */
+	if ( DespikeWin > 0.0 ) {
+		if ( (nspikes = despike_gapmap( &sh, seis, &gapmap, &nskipped )) < 0 ) {
+			fprintf(stderr, "Error despiking the SAC file: %s (window %.3f sec)!\n", InputFile, DespikeWin);
+			goto end_process;
+		}
+		fprintf(
+			stderr, "Found %d spikes in %s, replaced with the running median! %d samples of the short spans are unchecked.\n",
+			nspikes, sac_scnl_print( &sh ), nskipped
+		);
+		sh.user8 = nskipped;
+		sh.user9 = nspikes;
+	}
+/* The main process, it is done in place within the loaded buffer */
+	sac_data_preprocess_gapmap( &sh, seis, GainFactor, &gapmap );
 
+/* Output the gap map as the data availability report */
+	if ( ReportFile ) {
+		if ( (rfp = fopen(ReportFile, "w")) == (FILE *)NULL ) {
+			fprintf(stderr, "ERROR!! Can't open %s for report! Exiting!\n", ReportFile);
+			goto end_process;
+		}
+		sac_gapmap_report( rfp, &sh, &gapmap );
+		fclose(rfp);
+	}
 /* If user chose to output the result to local file, then open the file descript to write */
 	if ( OutputFile && (ofp = fopen(OutputFile, "wb")) == (FILE *)NULL ) {
 		fprintf(stderr, "ERROR!! Can't open %s for output! Exiting!\n", OutputFile);
 		goto end_process;
 	}
-/* Real output block, write the output buffer to SAC file */
-	datalen += sizeof(struct SAChead);
-	if ( fwrite(outbuf, 1, datalen, ofp) != datalen ) {
-		fprintf(stderr, "Error writing SAC file: %s\n", strerror(errno));
+/* Real output block, write the header & the result straight from the loaded buffer */
+	if ( sac_file_writev( fileno(ofp), &sh, seis ) ) {
 		if ( OutputFile )
 			remove(OutputFile);
 	}
@@ -88,9 +129,47 @@ end_process:
 	if ( ofp != stdout )
 		fclose(ofp);
 	if ( seis )
-		free(seis);
-	if ( outbuf )
-		free(outbuf);
+		bufpool_free( seis );
+	sac_gapmap_free( &gapmap );
+	stadb_close( &stadb );
+
+	return result;
+}
+
+/**
+ * @brief Despike each span between the gaps separately, so the gaps won't be taken as the spikes.
+ *        The span shorter than two windows will be skipped & counted as the unchecked samples.
+ *
+ * @param sh
+ * @param seis
+ * @param map
+ * @param skipped
+ * @return int
+ */
+static int despike_gapmap( struct SAChead *sh, float *seis, const SAC_GAP_MAP *map, int *skipped )
+{
+	const int window = (int)(DespikeWin / sh->delta + 0.5);
+
+	int from   = 0;
+	int to     = 0;
+	int count  = 0;
+	int result = 0;
+
+/* */
+	*skipped = 0;
+	for ( int g = 0; g <= map->count; g++ ) {
+		to = g < map->count ? map->gaps[g].start : sh->npts;
+		if ( to - from >= (window | 1) * 2 ) {
+			if ( (count = despike_process( seis + from, to - from, window, DespikeFac )) < 0 )
+				return count;
+			result += count;
+		}
+		else {
+			*skipped += to - from;
+		}
+		if ( g < map->count )
+			from = to + map->gaps[g].length;
+	}
 
 	return result;
 }
@@ -118,6 +197,19 @@ static int proc_argv( int argc, char *argv[] )
 		}
 		else if ( !strcmp(argv[i], "-g") ) {
 			GainFactor = atof(argv[++i]);
+			GainGiven  = 1;
+		}
+		else if ( !strcmp(argv[i], "-db") ) {
+			StationDB = argv[++i];
+		}
+		else if ( !strcmp(argv[i], "-a") ) {
+			ReportFile = argv[++i];
+		}
+		else if ( !strcmp(argv[i], "-sp") ) {
+			DespikeWin = atof(argv[++i]);
+		}
+		else if ( !strcmp(argv[i], "-sk") ) {
+			DespikeFac = atof(argv[++i]);
 		}
 		else if ( i == argc - 1 ) {
 #ifdef _WINNT
@@ -166,8 +258,13 @@ static void usage( void )
 		" -v             Report program version\n"
 		" -h             Show this usage message\n"
 		" -g gain_factor Specify the gain factor, it should be floating value\n"
+		" -db station_db Take the gain, coordinates & orientation from the station list or snapshot\n"
+		" -a report_file Output the gaps & data availability of the input SAC file to the report file\n"
+		" -sp window     Despike with the running median & MAD within the window in sec (e.g. 1.0)\n"
+		" -sk factor     Specify the despike threshold in scaled MAD, default is 6.0\n"
 		"\n"
 		"This program will fill the gap and apply the gain factor to the input SAC file.\n"
+		"The input SAC file can be '-' to read from the standard input.\n"
 		"\n"
 	);
 
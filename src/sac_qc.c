@@ -0,0 +1,222 @@
+/**
+ * @file sac_qc.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+/* */
+#include <sachead.h>
+#include <sac.h>
+#include <qc.h>
+#include <batch.h>
+
+/* */
+#define PROG_NAME       "sac_qc"
+#define VERSION         "1.0.0 - 2026-10-18"
+#define AUTHOR          "Benjamin Ming Yang"
+/* */
+typedef struct {
+	int        result;
+	char       scnl[SAC_MAX_SCNL_LENGTH];
+	double     starttime;
+	QC_METRICS metrics;
+} QC_JOB;
+
+/* */
+static int  proc_argv( int , char * [] );
+static void usage( void );
+static void qc_job_func( void *, const int );
+/* */
+static char   **InputFiles = NULL;
+static int      NumInputs  = 0;
+static int      NumThreads = 0;
+static QC_PARAM Param = { QC_DEF_CLIP_LEVEL, QC_DEF_SPIKE_FACTOR, QC_DEF_DEAD_STD, QC_DEF_DC_RATIO };
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main( int argc, char **argv )
+{
+	int         result = 0;
+	QC_JOB     *jobs   = NULL;
+	QC_METRICS *m;
+
+/* Check command line arguments */
+	if ( proc_argv( argc, argv ) ) {
+		usage();
+		return -1;
+	}
+	if ( (jobs = (QC_JOB *)calloc(NumInputs, sizeof(QC_JOB))) == NULL ) {
+		fprintf(stderr, "ERROR! Out of memory for %d input files\n", NumInputs);
+		return -2;
+	}
+
+/* The main process, farm out the input files to threads */
+	batch_jobs_run( NumInputs, NumThreads, qc_job_func, jobs );
+/* Output the result table (tab separated) in the order of the inputs */
+	fprintf(
+		stdout, "#SCNL\tStart\tNpts\tGaps\tGapSamples\tAvail(%%)\tMean\tRMS\tMin\tMax\t"
+		"ClipRuns\tClipSamples\tSpikes\tDead\tDC\tFile\n"
+	);
+	for ( int i = 0; i < NumInputs; i++ ) {
+		if ( jobs[i].result ) {
+			result = -1;
+			continue;
+		}
+		m = &jobs[i].metrics;
+		fprintf(
+			stdout, "%s\t%.3f\t%d\t%d\t%d\t%.3f\t%.6g\t%.6g\t%.6g\t%.6g\t%d\t%d\t%d\t%d\t%d\t%s\n",
+			jobs[i].scnl, jobs[i].starttime, m->npts, m->ngaps, m->gap_samples, m->avail,
+			m->mean, m->rms, m->min, m->max, m->clip_runs, m->clip_samples, m->spikes, m->dead, m->dc,
+			InputFiles[i]
+		);
+	}
+/* */
+	free(jobs);
+
+	return result;
+}
+
+/**
+ * @brief The job function of each input file, it will be called by the batch threads. The file
+ *        is streamed block by block, so the whole trace is never loaded.
+ *
+ * @param arg
+ * @param index
+ */
+static void qc_job_func( void *arg, const int index )
+{
+	QC_JOB        *job = (QC_JOB *)arg + index;
+	QC_STATE      *state;
+	SAC_STREAM     stream;
+	struct SAChead sh;
+	float          buffer[QC_BLOCK_SAMPLES];
+	int            nread;
+
+/* */
+	job->result = -1;
+	if ( (state = (QC_STATE *)malloc(sizeof(QC_STATE))) == NULL ) {
+		fprintf(stderr, "ERROR! Out of memory for the QC state of %s\n", InputFiles[index]);
+		return;
+	}
+	if ( sac_stream_open( InputFiles[index], &sh, &stream ) ) {
+		free(state);
+		return;
+	}
+	strcpy(job->scnl, sac_scnl_print( &sh ));
+	job->starttime = sac_reftime_fetch( &sh ) + sh.b;
+/* The one fused pass */
+	qc_state_init( state, &Param );
+	while ( (nread = sac_stream_read( &stream, buffer, QC_BLOCK_SAMPLES )) > 0 )
+		qc_state_update( state, buffer, nread );
+	if ( nread == 0 ) {
+		qc_state_finish( state, &job->metrics );
+		fprintf(stderr, "SAC file: %s quality control finished!\n", InputFiles[index]);
+		job->result = 0;
+	}
+/* */
+	sac_stream_close( &stream );
+	free(state);
+
+	return;
+}
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+static int proc_argv( int argc, char *argv[] )
+{
+	for ( int i = 1; i < argc; i++ ) {
+		if ( !strcmp(argv[i], "-v") ) {
+			fprintf(stdout, "%s\n", PROG_NAME);
+			fprintf(stdout, "Version: %s\n", VERSION);
+			fprintf(stdout, "Author:  %s\n", AUTHOR);
+			fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-h") ) {
+			usage();
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-c") && i < argc - 1 ) {
+			Param.clip_level = atof(argv[++i]);
+		}
+		else if ( !strcmp(argv[i], "-k") && i < argc - 1 ) {
+			Param.spike_factor = atof(argv[++i]);
+		}
+		else if ( !strcmp(argv[i], "-ds") && i < argc - 1 ) {
+			Param.dead_std = atof(argv[++i]);
+		}
+		else if ( !strcmp(argv[i], "-dc") && i < argc - 1 ) {
+			Param.dc_ratio = atof(argv[++i]);
+		}
+		else if ( !strcmp(argv[i], "-t") && i < argc - 1 ) {
+			NumThreads = atoi(argv[++i]);
+		}
+		else if ( argv[i][0] == '-' ) {
+			fprintf(stderr, "Unknown option: %s\n\n", argv[i]);
+			return -1;
+		}
+		else {
+		/* All the remained arguments are input files */
+			InputFiles = argv + i;
+			NumInputs  = argc - i;
+			break;
+		}
+	}
+/* */
+	if ( !NumInputs ) {
+		fprintf(stderr, "No input file was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ */
+static void usage( void )
+{
+	fprintf(stdout, "\n%s\n", PROG_NAME);
+	fprintf(stdout, "Version: %s\n", VERSION);
+	fprintf(stdout, "Author:  %s\n", AUTHOR);
+	fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+	fprintf(stdout, "***************************\n");
+	fprintf(stdout, "Usage: %s [options] <input SAC files...> > <output table>\n\n", PROG_NAME);
+	fprintf(stdout,
+		"*** Options ***\n"
+		" -v             Report program version\n"
+		" -h             Show this usage message\n"
+		" -c clip_level  Specify the clip level in counts, default is %.0f\n"
+		" -k factor      Specify the spike threshold in scaled MAD, default is %.1f\n"
+		" -ds std        Specify the standard deviation of dead channel in counts, default is %.1f\n"
+		" -dc ratio      Specify the ratio of |mean| to standard deviation of DC offset, default is %.1f\n"
+		" -t threads     Specify the number of threads, default is the number of processors\n"
+		"\n"
+		"This program will calculate the data quality metrics of the raw input SAC files within\n"
+		"one pass & output them as a tab separated table.\n"
+		"\n",
+		QC_DEF_CLIP_LEVEL, QC_DEF_SPIKE_FACTOR, QC_DEF_DEAD_STD, QC_DEF_DC_RATIO
+	);
+
+	return;
+}
@@ -0,0 +1,262 @@
+/**
+ * @file sac_resample.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+/* */
+#include <sachead.h>
+#include <sac.h>
+#include <resample.h>
+
+/* */
+#define PROG_NAME       "sac_resample"
+#define VERSION         "1.0.0 - 2026-10-18"
+#define AUTHOR          "Benjamin Ming Yang"
+/* */
+#define DEF_BLOCK_SAMPLES   65536
+#define RATE_RESOLUTION     1000.0
+/* */
+static int  proc_argv( int , char * [] );
+static void usage( void );
+static int  ratio_from_rate( const double, const double, int *, int * );
+/* */
+static char  *InputFile  = NULL;
+static char  *OutputFile = NULL;
+static double NewRate    = 0.0;
+static int    UpFactor   = 0;
+static int    DownFactor = 0;
+static int    BlockSize  = DEF_BLOCK_SAMPLES;
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main( int argc, char **argv )
+{
+	int            result = -1;
+	int            nin, nout, maxout;
+	long           total  = 0;
+	FILE          *ofp    = stdout;
+	float         *inbuf  = NULL;
+	float         *outbuf = NULL;
+	SAC_STREAM     stream = { 0 };
+	RESAMPLE_STATE state  = { 0 };
+	struct SAChead sh;
+
+/* Check command line arguments */
+	if ( proc_argv( argc, argv ) ) {
+		usage();
+		return -1;
+	}
+
+/* Open the SAC file & only read the header */
+	if ( sac_stream_open( InputFile, &sh, &stream ) < 0 )
+		goto end_process;
+/* Then derive the ratio from the target sampling rate */
+	if ( NewRate > 0.0 && ratio_from_rate( 1.0 / sh.delta, NewRate, &UpFactor, &DownFactor ) ) {
+		fprintf(stderr, "Can't resample %s from %.3f Hz to %.3f Hz!\n", InputFile, 1.0 / sh.delta, NewRate);
+		goto end_process;
+	}
+	if ( resample_state_init( &state, UpFactor, DownFactor ) ) {
+		fprintf(stderr, "Can't design the resampling kernel for the ratio %d/%d!\n", UpFactor, DownFactor);
+		goto end_process;
+	}
+	fprintf(
+		stderr, "SAC file: %s resampling by %d/%d (%d taps per phase)...\n",
+		InputFile, state.kernel->up, state.kernel->down, state.kernel->ntaps
+	);
+/* Allocate the block buffers, the output one should also hold the tail from the zero padding of the flushing */
+	maxout = (int)resample_output_length( BlockSize + state.kernel->half_len / state.kernel->up + 2, state.kernel->up, state.kernel->down );
+	maxout += state.kernel->up + 1;
+	if (
+		(inbuf = (float *)malloc(sizeof(float) * BlockSize)) == NULL ||
+		(outbuf = (float *)malloc(sizeof(float) * maxout)) == NULL
+	) {
+		fprintf(stderr, "ERROR! Out of memory for %d samples block\n", BlockSize);
+		goto end_process;
+	}
+
+/* Update the header by the new sampling rate */
+	sh.delta = sh.delta * state.kernel->down / state.kernel->up;
+	sh.npts  = (int)resample_output_length( sh.npts, state.kernel->up, state.kernel->down );
+	sh.e     = sh.b + (sh.npts - 1) * sh.delta;
+/* If user chose to output the result to local file, then open the file descript to write */
+	if ( OutputFile && (ofp = fopen(OutputFile, "wb")) == (FILE *)NULL ) {
+		fprintf(stderr, "ERROR!! Can't open %s for output! Exiting!\n", OutputFile);
+		goto end_process;
+	}
+	if ( fwrite(&sh, 1, sizeof(struct SAChead), ofp) != sizeof(struct SAChead) )
+		goto write_error;
+/* The main process, stream the input block by block */
+	while ( (nin = sac_stream_read( &stream, inbuf, BlockSize )) > 0 ) {
+		if ( (nout = resample_process( &state, inbuf, nin, outbuf, maxout )) < 0 )
+			goto end_process;
+		if ( fwrite(outbuf, sizeof(float), nout, ofp) != (size_t)nout )
+			goto write_error;
+		total += nout;
+	}
+	if ( nin < 0 || (nout = resample_flush( &state, outbuf, maxout )) < 0 )
+		goto end_process;
+	if ( fwrite(outbuf, sizeof(float), nout, ofp) != (size_t)nout )
+		goto write_error;
+	total += nout;
+/* */
+	if ( total != sh.npts ) {
+		fprintf(stderr, "ERROR! Output %ld samples, but %d samples are expected!\n", total, sh.npts);
+		goto end_process;
+	}
+	fprintf(stderr, "SAC file: %s resampling finished! Total %d samples with %f delta.\n", InputFile, sh.npts, sh.delta);
+	result = 0;
+	goto end_process;
+
+write_error:
+	fprintf(stderr, "Error writing SAC file: %s\n", strerror(errno));
+end_process:
+	if ( ofp && ofp != stdout ) {
+		fclose(ofp);
+	/* Never leave the truncated output whose header claims the full length */
+		if ( result )
+			remove(OutputFile);
+	}
+	sac_stream_close( &stream );
+	resample_state_free( &state );
+	resample_kernel_cache_free();
+	if ( inbuf )
+		free(inbuf);
+	if ( outbuf )
+		free(outbuf);
+
+	return result;
+}
+
+/**
+ * @brief Derive the rational factors from the original & target sampling rate.
+ *
+ * @param rate
+ * @param new_rate
+ * @param up
+ * @param down
+ * @return int
+ */
+static int ratio_from_rate( const double rate, const double new_rate, int *up, int *down )
+{
+	*up   = (int)(new_rate * RATE_RESOLUTION + 0.5);
+	*down = (int)(rate * RATE_RESOLUTION + 0.5);
+
+	return resample_ratio_reduce( up, down );
+}
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+static int proc_argv( int argc, char *argv[] )
+{
+	for ( int i = 1; i < argc; i++ ) {
+		if ( !strcmp(argv[i], "-v") ) {
+			fprintf(stdout, "%s\n", PROG_NAME);
+			fprintf(stdout, "Version: %s\n", VERSION);
+			fprintf(stdout, "Author:  %s\n", AUTHOR);
+			fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-h") ) {
+			usage();
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-r") ) {
+			NewRate = atof(argv[++i]);
+		}
+		else if ( !strcmp(argv[i], "-u") ) {
+			UpFactor = atoi(argv[++i]);
+		}
+		else if ( !strcmp(argv[i], "-d") ) {
+			DownFactor = atoi(argv[++i]);
+		}
+		else if ( !strcmp(argv[i], "-b") ) {
+			BlockSize = atoi(argv[++i]);
+		}
+		else if ( i == argc - 1 ) {
+#ifdef _WINNT
+			usage();
+			return -1;
+#else
+			InputFile = argv[i];
+			OutputFile = NULL;
+#endif
+		}
+		else if ( i == argc - 2 ) {
+			InputFile = argv[i++];
+			OutputFile = argv[i];
+			break;
+		}
+		else {
+			fprintf(stderr, "Unknown option: %s\n\n", argv[i]);
+			return -1;
+		}
+	}
+/* */
+	if ( NewRate <= 0.0 && (UpFactor < 1 || DownFactor < 1) ) {
+		fprintf(stderr, "No target sampling rate or resampling factors were specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+	if ( BlockSize < 1 ) {
+		fprintf(stderr, "Invalid block size: %d; ", BlockSize);
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+	if ( !InputFile ) {
+		fprintf(stderr, "No input file was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ */
+static void usage( void )
+{
+	fprintf(stdout, "\n%s\n", PROG_NAME);
+	fprintf(stdout, "Version: %s\n", VERSION);
+	fprintf(stdout, "Author:  %s\n", AUTHOR);
+	fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+	fprintf(stdout, "***************************\n");
+	fprintf(stdout, "Usage: %s [options] <input SAC file> > <output SAC file>\n", PROG_NAME);
+	fprintf(stdout, "       or %s [options] <input SAC file> <output SAC file>\n\n", PROG_NAME);
+	fprintf(stdout,
+		"*** Options ***\n"
+		" -v             Report program version\n"
+		" -h             Show this usage message\n"
+		" -r rate        Specify the target sampling rate in Hz\n"
+		" -u up          Specify the interpolation factor, used with -d\n"
+		" -d down        Specify the decimation factor, used with -u\n"
+		" -b samples     Specify the number of samples of each streaming block, default is 65536\n"
+		"\n"
+		"This program will resample the input SAC file by the polyphase FIR filter. The gaps\n"
+		"should be filled (e.g. by sac_preproc) before resampling.\n"
+		"\n"
+	);
+
+	return;
+}
@@ -0,0 +1,241 @@
+/**
+ * @file sac_rmresp.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+/* */
+#include <sachead.h>
+#include <sac.h>
+#include <response.h>
+#include <fft.h>
+#include <batch.h>
+
+/* */
+#define PROG_NAME       "sac_rmresp"
+#define VERSION         "1.0.0 - 2026-10-18"
+#define AUTHOR          "Benjamin Ming Yang"
+/* */
+static int  proc_argv( int , char * [] );
+static void usage( void );
+static void rmresp_job_func( void *, const int );
+/* */
+static char         *RespFile   = NULL;
+static char         *OutputDir  = ".";
+static char        **InputFiles = NULL;
+static int           NumInputs  = 0;
+static int           NumThreads = 0;
+static RESP_CHANNEL *Channels   = NULL;
+static int           NumChannels = 0;
+static RESP_PARAM    Param = { RESP_DEF_WATER_LEVEL, { 0.0, 0.0, 0.0, 0.0 } };
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main( int argc, char **argv )
+{
+	int *results = NULL;
+	int  result  = 0;
+
+/* Check command line arguments */
+	if ( proc_argv( argc, argv ) ) {
+		usage();
+		return -1;
+	}
+/* Load the responses of all the channels */
+	if ( (NumChannels = response_file_load( RespFile, &Channels )) <= 0 ) {
+		fprintf(stderr, "Can't load any response from %s! Exiting!\n", RespFile);
+		return -1;
+	}
+	if ( (results = (int *)calloc(NumInputs, sizeof(int))) == NULL ) {
+		fprintf(stderr, "ERROR! Out of memory for %d input files\n", NumInputs);
+		result = -2;
+		goto end_process;
+	}
+/* The main process, farm out the input files to threads */
+	batch_jobs_run( NumInputs, NumThreads, rmresp_job_func, results );
+	bufpool_stats_report( stderr );
+	for ( int i = 0; i < NumInputs; i++ )
+		if ( results[i] )
+			result = -1;
+
+end_process:
+	if ( results )
+		free(results);
+	free(Channels);
+	response_cache_free();
+	fft_plan_cache_free();
+
+	return result;
+}
+
+/**
+ * @brief The job function of each input file, it will be called by the batch threads.
+ *
+ * @param arg
+ * @param index
+ */
+static void rmresp_job_func( void *arg, const int index )
+{
+	int                *result = (int *)arg + index;
+	float              *seis   = NULL;
+	FILE               *ofp    = NULL;
+	const char         *basename;
+	const RESP_CHANNEL *channel;
+	char                path[SAC_MAX_PATH_LENGTH];
+	struct SAChead      sh;
+
+/* Output to the same file name under the output directory, the raw input should never be overwritten */
+	*result  = -1;
+	basename = strrchr(InputFiles[index], '/');
+	basename = basename ? basename + 1 : InputFiles[index];
+	snprintf(path, sizeof(path), "%s/%s", OutputDir, basename);
+	if ( sac_file_same( path, InputFiles[index] ) ) {
+		fprintf(stderr, "The output %s is the input file itself, please specify another directory by -o!\n", path);
+		return;
+	}
+/* Load the SAC file to local memory */
+	if ( sac_file_load( InputFiles[index], &sh, &seis ) < 0 )
+		return;
+	if ( (channel = response_channel_find( Channels, NumChannels, sac_scnl_print( &sh ) )) == NULL ) {
+		fprintf(stderr, "Can't find the response of %s for %s!\n", sac_scnl_print( &sh ), InputFiles[index]);
+		goto end_process;
+	}
+/* First, preprocess the raw seismic data, then remove the response */
+	sac_data_preprocess( &sh, seis, 1.0 );
+	if ( response_remove( seis, sh.npts, sh.delta, &channel->pz, &Param ) ) {
+		fprintf(stderr, "Error removing the response of %s\n", InputFiles[index]);
+		goto end_process;
+	}
+/* Output the result */
+	if ( (ofp = fopen(path, "wb")) == (FILE *)NULL ) {
+		fprintf(stderr, "ERROR!! Can't open %s for output!\n", path);
+		goto end_process;
+	}
+	if (
+		fwrite(&sh, 1, sizeof(struct SAChead), ofp) != sizeof(struct SAChead) ||
+		fwrite(seis, sizeof(float), sh.npts, ofp) != (size_t)sh.npts
+	) {
+		fprintf(stderr, "Error writing SAC file: %s\n", strerror(errno));
+		fclose(ofp);
+		remove(path);
+		goto end_process;
+	}
+	fclose(ofp);
+	fprintf(stderr, "SAC file: %s response removal finished!\n", InputFiles[index]);
+	*result = 0;
+
+end_process:
+	bufpool_free( seis );
+	return;
+}
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+static int proc_argv( int argc, char *argv[] )
+{
+	for ( int i = 1; i < argc; i++ ) {
+		if ( !strcmp(argv[i], "-v") ) {
+			fprintf(stdout, "%s\n", PROG_NAME);
+			fprintf(stdout, "Version: %s\n", VERSION);
+			fprintf(stdout, "Author:  %s\n", AUTHOR);
+			fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-h") ) {
+			usage();
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-r") && i < argc - 1 ) {
+			RespFile = argv[++i];
+		}
+		else if ( !strcmp(argv[i], "-wl") && i < argc - 1 ) {
+			Param.water_level = atof(argv[++i]);
+		}
+		else if ( !strcmp(argv[i], "-pf") && i < argc - 4 ) {
+			for ( int j = 0; j < 4; j++ )
+				Param.freqs[j] = atof(argv[++i]);
+			if ( Param.freqs[0] >= Param.freqs[1] || Param.freqs[1] > Param.freqs[2] || Param.freqs[2] >= Param.freqs[3] ) {
+				fprintf(stderr, "Invalid pre-filter frequencies!\n\n");
+				return -1;
+			}
+		}
+		else if ( !strcmp(argv[i], "-o") && i < argc - 1 ) {
+			OutputDir = argv[++i];
+		}
+		else if ( !strcmp(argv[i], "-t") && i < argc - 1 ) {
+			NumThreads = atoi(argv[++i]);
+		}
+		else if ( argv[i][0] == '-' ) {
+			fprintf(stderr, "Unknown option: %s\n\n", argv[i]);
+			return -1;
+		}
+		else {
+		/* All the remained arguments are input files */
+			InputFiles = argv + i;
+			NumInputs  = argc - i;
+			break;
+		}
+	}
+/* */
+	if ( !RespFile ) {
+		fprintf(stderr, "No response file was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+	if ( !NumInputs ) {
+		fprintf(stderr, "No input file was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ */
+static void usage( void )
+{
+	fprintf(stdout, "\n%s\n", PROG_NAME);
+	fprintf(stdout, "Version: %s\n", VERSION);
+	fprintf(stdout, "Author:  %s\n", AUTHOR);
+	fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+	fprintf(stdout, "***************************\n");
+	fprintf(stdout, "Usage: %s [options] -r <response file> <input SAC files...>\n\n", PROG_NAME);
+	fprintf(stdout,
+		"*** Options ***\n"
+		" -v                Report program version\n"
+		" -h                Show this usage message\n"
+		" -r resp_file      Specify the poles & zeros response file of all the channels\n"
+		" -wl water_level   Specify the water level in dB below the maximum, default is 60\n"
+		" -pf f1 f2 f3 f4   Specify the cosine taper pre-filter frequencies in Hz\n"
+		" -o output_dir     Specify the output directory, default is current directory, the input\n"
+		"                   files won't be overwritten\n"
+		" -t threads        Specify the number of threads, default is the number of processors\n"
+		"\n"
+		"This program will remove the instrument response of the input SAC files. The output\n"
+		"unit is the ground motion that the poles & zeros were defined for.\n"
+		"\n"
+	);
+
+	return;
+}
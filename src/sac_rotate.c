@@ -0,0 +1,359 @@
+/**
+ * @file sac_rotate.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+/* */
+#include <sachead.h>
+#include <sac.h>
+#include <rotate.h>
+#include <batch.h>
+
+/* */
+#define PROG_NAME       "sac_rotate"
+#define VERSION         "1.0.0 - 2026-10-18"
+#define AUTHOR          "Benjamin Ming Yang"
+/* */
+#define HORIZONTAL_INC  90.0
+#define MAX_INC_ERROR   1.0
+/* */
+static int  proc_argv( int , char * [] );
+static void usage( void );
+static void rotate_job_func( void *, const int );
+static int  check_component( const char *, struct SAChead * );
+static void prepare_component( struct SAChead *, const char, const double, char * );
+static int  output_component( const char *, const char *, const struct SAChead *, const float * );
+/* */
+static char  *OutputDir   = ".";
+static char **InputFiles  = NULL;
+static int    NumInputs   = 0;
+static int    NumThreads  = 0;
+static int    NumPerSta   = 2;
+static int    RadialTrans = 0;
+static double BackAzimuth = SACUNDEF;
+static double OrientCorr  = 0.0;
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main( int argc, char **argv )
+{
+	int  nsta;
+	int *results = NULL;
+	int  result  = 0;
+
+/* Check command line arguments */
+	if ( proc_argv( argc, argv ) ) {
+		usage();
+		return -1;
+	}
+	nsta = NumInputs / NumPerSta;
+	if ( (results = (int *)calloc(nsta, sizeof(int))) == NULL ) {
+		fprintf(stderr, "ERROR! Out of memory for %d stations\n", nsta);
+		return -2;
+	}
+/* The main process, farm out the stations to threads */
+	batch_jobs_run( nsta, NumThreads, rotate_job_func, results );
+	bufpool_stats_report( stderr );
+	for ( int i = 0; i < nsta; i++ )
+		if ( results[i] )
+			result = -1;
+/* */
+	free(results);
+
+	return result;
+}
+
+/**
+ * @brief The job function of each station, it will be called by the batch threads.
+ *
+ * @param arg
+ * @param index
+ */
+static void rotate_job_func( void *arg, const int index )
+{
+	int            *result  = (int *)arg + index;
+	char          **files   = InputFiles + index * NumPerSta;
+	char          **hfiles  = files + NumPerSta - 2;
+	float          *seis[3] = { NULL };
+	float         **hseis   = seis + NumPerSta - 2;
+	double          taz[2];
+	double          baz;
+	char            tchan[2];
+	char            paths[3][SAC_MAX_PATH_LENGTH];
+	ROTATE_MATRIX   matrix;
+	struct SAChead  sh[3];
+	struct SAChead *hsh     = sh + NumPerSta - 2;
+
+/* Load all the components of this station */
+	*result = -1;
+	for ( int i = 0; i < NumPerSta; i++ )
+		if ( sac_file_load( files[i], sh + i, seis + i ) < 0 )
+			goto end_process;
+/* The components should be the same station with the same sampling & timing */
+	for ( int i = 1; i < NumPerSta; i++ ) {
+		if (
+			strncmp(sh[i].kstnm, sh[0].kstnm, K_LEN) || strncmp(sh[i].knetwk, sh[0].knetwk, K_LEN) ||
+			strncmp(sh[i].khole, sh[0].khole, K_LEN) || sh[i].npts != sh[0].npts || sh[i].delta != sh[0].delta ||
+			fabs((sac_reftime_fetch( sh + i ) + sh[i].b) - (sac_reftime_fetch( sh ) + sh[0].b)) > sh[0].delta * 0.5
+		) {
+			fprintf(stderr, "SAC files: %s & %s are not the same station with the same timing!\n", files[0], files[i]);
+			goto end_process;
+		}
+	}
+/* The horizontal components are always the last two */
+	if ( check_component( hfiles[0], hsh ) || check_component( hfiles[1], hsh + 1 ) )
+		goto end_process;
+/* Target azimuths, radial is pointing from the event to the station & transverse is 90 deg clockwise of it */
+	if ( RadialTrans ) {
+		baz = BackAzimuth != SACUNDEF ? BackAzimuth : hsh[0].baz;
+		if ( baz == SACUNDEF ) {
+			fprintf(stderr, "No back-azimuth for %s, please specify it by -b!\n", hfiles[0]);
+			goto end_process;
+		}
+		taz[0]   = rotate_azimuth_normalize( baz + 180.0 );
+		taz[1]   = rotate_azimuth_normalize( baz + 270.0 );
+		tchan[0] = 'R';
+		tchan[1] = 'T';
+	}
+	else {
+		baz      = BackAzimuth;
+		taz[0]   = 0.0;
+		taz[1]   = 90.0;
+		tchan[0] = 'N';
+		tchan[1] = 'E';
+	}
+/* The pair of components is rotated within one pass */
+	if ( rotate_matrix_calc( hsh[0].cmpaz + OrientCorr, hsh[1].cmpaz + OrientCorr, taz[0], taz[1], &matrix ) ) {
+		fprintf(stderr, "SAC files: %s & %s are nearly parallel, can't be rotated!\n", hfiles[0], hfiles[1]);
+		goto end_process;
+	}
+	rotate_horizontal( hseis[0], hseis[1], hsh[0].npts, &matrix );
+/* The vertical component (if any) is kept as is & the rotated components have the new orientations */
+	if ( NumPerSta == 3 )
+		prepare_component( sh, '\0', baz, paths[0] );
+	for ( int i = 0; i < 2; i++ ) {
+		hsh[i].cmpaz  = taz[i];
+		hsh[i].cmpinc = HORIZONTAL_INC;
+		prepare_component( hsh + i, tchan[i], baz, paths[NumPerSta - 2 + i] );
+	}
+/* None of the outputs should be any of the inputs, so the station won't be left half-rotated */
+	for ( int i = 0; i < NumPerSta; i++ ) {
+		for ( int j = 0; j < NumPerSta; j++ ) {
+			if ( sac_file_same( paths[i], files[j] ) ) {
+				fprintf(stderr, "The output %s is the input file itself, please specify another directory by -o!\n", paths[i]);
+				goto end_process;
+			}
+		}
+	}
+	for ( int i = 0; i < NumPerSta; i++ )
+		if ( output_component( files[i], paths[i], sh + i, seis[i] ) )
+			goto end_process;
+	fprintf(stderr, "SAC files: %s & %s rotation finished!\n", hfiles[0], hfiles[1]);
+	*result = 0;
+
+end_process:
+	for ( int i = 0; i < NumPerSta; i++ )
+		bufpool_free( seis[i] );
+	return;
+}
+
+/**
+ * @brief Check the orientation of the horizontal component, the undefined azimuth will be
+ *        derived from the channel code.
+ *
+ * @param filename
+ * @param sh
+ * @return int
+ */
+static int check_component( const char *filename, struct SAChead *sh )
+{
+	if ( sh->cmpaz == SACUNDEF )
+		sac_az_inc_modify( sh, SACUNDEF, sh->cmpinc );
+	if ( sh->cmpaz == SACUNDEF ) {
+		fprintf(stderr, "SAC file: %s has no component azimuth, please set it by sac_mscnl!\n", filename);
+		return -1;
+	}
+	if ( sh->cmpinc != SACUNDEF && fabs(sh->cmpinc - HORIZONTAL_INC) > MAX_INC_ERROR ) {
+		fprintf(stderr, "SAC file: %s is not a horizontal component (inc %.1f)!\n", filename, sh->cmpinc);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Update the header of the component by the new orientation, then derive its output path
+ *        under the output directory, the file name is the new SCNL.
+ *
+ * @param sh
+ * @param orient the new orientation code of the channel, '\0' means unchanged
+ * @param baz
+ * @param path
+ */
+static void prepare_component( struct SAChead *sh, const char orient, const double baz, char *path )
+{
+	char sta[K_LEN + 1]  = { 0 };
+	char chan[K_LEN + 1] = { 0 };
+	char net[K_LEN + 1]  = { 0 };
+	char loc[K_LEN + 1]  = { 0 };
+
+/* The orientation code is the third character of the channel code */
+	sscanf(sac_scnl_print( sh ), "%8[^.].%8[^.].%8[^.].%8s", sta, chan, net, loc);
+	if ( orient ) {
+		if ( strlen(chan) < 3 )
+			strcat(chan, "  ");
+		chan[2] = orient;
+		sac_scnl_modify( sh, NULL, chan, NULL, NULL );
+	}
+	if ( baz != SACUNDEF )
+		sh->baz = baz;
+	snprintf(path, SAC_MAX_PATH_LENGTH, SAC_FILE_NAME_FORMAT, OutputDir, sta, chan, net, loc);
+
+	return;
+}
+
+/**
+ * @brief Write the component to its output path.
+ *
+ * @param filename
+ * @param path
+ * @param sh
+ * @param seis
+ * @return int
+ */
+static int output_component( const char *filename, const char *path, const struct SAChead *sh, const float *seis )
+{
+	FILE *ofp;
+
+/* */
+	if ( (ofp = fopen(path, "wb")) == (FILE *)NULL ) {
+		fprintf(stderr, "ERROR!! Can't open %s for output!\n", path);
+		return -1;
+	}
+	if (
+		fwrite(sh, 1, sizeof(struct SAChead), ofp) != sizeof(struct SAChead) ||
+		fwrite(seis, sizeof(float), sh->npts, ofp) != (size_t)sh->npts
+	) {
+		fprintf(stderr, "Error writing SAC file: %s\n", strerror(errno));
+		fclose(ofp);
+		remove(path);
+		return -1;
+	}
+	fclose(ofp);
+	fprintf(stderr, "SAC file: %s has been written to %s!\n", filename, path);
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+static int proc_argv( int argc, char *argv[] )
+{
+	for ( int i = 1; i < argc; i++ ) {
+		if ( !strcmp(argv[i], "-v") ) {
+			fprintf(stdout, "%s\n", PROG_NAME);
+			fprintf(stdout, "Version: %s\n", VERSION);
+			fprintf(stdout, "Author:  %s\n", AUTHOR);
+			fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-h") ) {
+			usage();
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-rt") ) {
+			RadialTrans = 1;
+		}
+		else if ( !strcmp(argv[i], "-b") && i < argc - 1 ) {
+			BackAzimuth = rotate_azimuth_normalize( atof(argv[++i]) );
+		}
+		else if ( !strcmp(argv[i], "-oc") && i < argc - 1 ) {
+			OrientCorr = atof(argv[++i]);
+		}
+		else if ( !strcmp(argv[i], "-z") ) {
+			NumPerSta = 3;
+		}
+		else if ( !strcmp(argv[i], "-o") && i < argc - 1 ) {
+			OutputDir = argv[++i];
+		}
+		else if ( !strcmp(argv[i], "-t") && i < argc - 1 ) {
+			NumThreads = atoi(argv[++i]);
+		}
+		else if ( argv[i][0] == '-' ) {
+			fprintf(stderr, "Unknown option: %s\n\n", argv[i]);
+			return -1;
+		}
+		else {
+		/* All the remained arguments are input files */
+			InputFiles = argv + i;
+			NumInputs  = argc - i;
+			break;
+		}
+	}
+/* */
+	if ( !NumInputs ) {
+		fprintf(stderr, "No input file was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+	if ( NumInputs % NumPerSta ) {
+		fprintf(stderr, "The input files should be %s groups; ", NumPerSta == 3 ? "Z/H1/H2" : "H1/H2");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ */
+static void usage( void )
+{
+	fprintf(stdout, "\n%s\n", PROG_NAME);
+	fprintf(stdout, "Version: %s\n", VERSION);
+	fprintf(stdout, "Author:  %s\n", AUTHOR);
+	fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+	fprintf(stdout, "***************************\n");
+	fprintf(stdout, "Usage: %s [options] <H1 SAC file> <H2 SAC file> [<H1 SAC file> <H2 SAC file>...]\n", PROG_NAME);
+	fprintf(stdout, "       or %s -z [options] <Z SAC file> <H1 SAC file> <H2 SAC file> [...]\n\n", PROG_NAME);
+	fprintf(stdout,
+		"*** Options ***\n"
+		" -v               Report program version\n"
+		" -h               Show this usage message\n"
+		" -rt              Rotate to radial & transverse instead of true north & east\n"
+		" -b back_azimuth  Specify the event back-azimuth in deg, default is the baz in header\n"
+		" -oc correction   Specify the orientation correction in deg added to both component azimuths\n"
+		" -z               Input files are Z/H1/H2 triplets, the Z component will be output as is\n"
+		" -o output_dir    Specify the output directory, default is current directory, the input\n"
+		"                  files won't be overwritten\n"
+		" -t threads       Specify the number of threads, default is the number of processors\n"
+		"\n"
+		"This program will rotate the horizontal components of each station by their component\n"
+		"azimuths (cmpaz) & output them as sta.chan.net.loc with the updated orientation headers.\n"
+		"\n"
+	);
+
+	return;
+}
@@ -0,0 +1,266 @@
+/**
+ * @file sac_rsp.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+/* */
+#include <sachead.h>
+#include <sac.h>
+#include <respspec.h>
+#include <batch.h>
+
+/* */
+#define PROG_NAME       "sac_rsp"
+#define VERSION         "1.0.0 - 2026-10-18"
+#define AUTHOR          "Benjamin Ming Yang"
+/* */
+#define MAX_NUM_DAMPINGS  16
+/* */
+typedef struct {
+	char        scnl[SAC_MAX_SCNL_LENGTH];
+	int         nosc;
+	RSP_RESULT *results;
+} RSP_JOB;
+
+/* */
+static int  proc_argv( int , char * [] );
+static void usage( void );
+static void rsp_job_func( void *, const int );
+static int  parse_dampings( const char * );
+/* */
+static float   GainFactor = 1.0;
+static char  **InputFiles = NULL;
+static int     NumInputs  = 0;
+static int     NumThreads = 0;
+static int     NumPeriods = RSP_DEF_NUM_PERIODS;
+static double  MinPeriod  = RSP_DEF_MIN_PERIOD;
+static double  MaxPeriod  = RSP_DEF_MAX_PERIOD;
+static double *Periods    = NULL;
+static int     NumDampings = 1;
+static double  Dampings[MAX_NUM_DAMPINGS] = { RSP_DEF_DAMPING };
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main( int argc, char **argv )
+{
+	int      result = 0;
+	RSP_JOB *jobs   = NULL;
+
+/* Check command line arguments */
+	if ( proc_argv( argc, argv ) ) {
+		usage();
+		return -1;
+	}
+/* Generate the oscillator periods which will be shared by all the inputs */
+	if (
+		(Periods = (double *)calloc(NumPeriods, sizeof(double))) == NULL ||
+		(jobs = (RSP_JOB *)calloc(NumInputs, sizeof(RSP_JOB))) == NULL
+	) {
+		fprintf(stderr, "ERROR! Out of memory for %d input files\n", NumInputs);
+		result = -2;
+		goto end_process;
+	}
+	respspec_periods_gen( Periods, NumPeriods, MinPeriod, MaxPeriod );
+
+/* The main process, farm out the input files to threads */
+	batch_jobs_run( NumInputs, NumThreads, rsp_job_func, jobs );
+	bufpool_stats_report( stderr );
+/* Output the result table in the order of the inputs */
+	fprintf(stdout, "#SCNL Damping Period SD PSV PSA SA\n");
+	for ( int i = 0; i < NumInputs; i++ ) {
+		if ( !jobs[i].results ) {
+			result = -1;
+			continue;
+		}
+		for ( int j = 0; j < jobs[i].nosc; j++ ) {
+			fprintf(
+				stdout, "%s %.3f %.4f %.6e %.6e %.6e %.6e\n", jobs[i].scnl,
+				jobs[i].results[j].damping, jobs[i].results[j].period, jobs[i].results[j].sd,
+				jobs[i].results[j].psv, jobs[i].results[j].psa, jobs[i].results[j].sa
+			);
+		}
+	}
+
+end_process:
+	if ( jobs ) {
+		for ( int i = 0; i < NumInputs; i++ )
+			if ( jobs[i].results )
+				free(jobs[i].results);
+		free(jobs);
+	}
+	if ( Periods )
+		free(Periods);
+
+	return result;
+}
+
+/**
+ * @brief The job function of each input file, it will be called by the batch threads.
+ *
+ * @param arg
+ * @param index
+ */
+static void rsp_job_func( void *arg, const int index )
+{
+	RSP_JOB       *job  = (RSP_JOB *)arg + index;
+	float         *seis = NULL;
+	struct SAChead sh;
+
+/* Load the SAC file to local memory */
+	if ( sac_file_load( InputFiles[index], &sh, &seis ) < 0 )
+		return;
+/* */
+	if ( (job->results = (RSP_RESULT *)calloc(NumPeriods * NumDampings, sizeof(RSP_RESULT))) == NULL ) {
+		fprintf(stderr, "ERROR! Out of memory for the response spectrum of %s\n", InputFiles[index]);
+		goto end_process;
+	}
+	strcpy(job->scnl, sac_scnl_print( &sh ));
+/* First, preprocess the raw seismic data */
+	sac_data_preprocess( &sh, seis, GainFactor );
+/* Then, drive all the oscillators with one pass */
+	job->nosc = respspec_calc( seis, sh.npts, sh.delta, Periods, NumPeriods, Dampings, NumDampings, job->results );
+	if ( job->nosc < 0 ) {
+		fprintf(stderr, "Error calculating the response spectrum of %s\n", InputFiles[index]);
+		free(job->results);
+		job->results = NULL;
+	}
+	else {
+		fprintf(stderr, "SAC file: %s response spectrum finished!\n", InputFiles[index]);
+	}
+
+end_process:
+	bufpool_free( seis );
+	return;
+}
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+static int proc_argv( int argc, char *argv[] )
+{
+	for ( int i = 1; i < argc; i++ ) {
+		if ( !strcmp(argv[i], "-v") ) {
+			fprintf(stdout, "%s\n", PROG_NAME);
+			fprintf(stdout, "Version: %s\n", VERSION);
+			fprintf(stdout, "Author:  %s\n", AUTHOR);
+			fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-h") ) {
+			usage();
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-g") && i < argc - 1 ) {
+			GainFactor = atof(argv[++i]);
+		}
+		else if ( !strcmp(argv[i], "-d") && i < argc - 1 ) {
+			if ( parse_dampings( argv[++i] ) )
+				return -1;
+		}
+		else if ( !strcmp(argv[i], "-p") && i < argc - 3 ) {
+			MinPeriod  = atof(argv[++i]);
+			MaxPeriod  = atof(argv[++i]);
+			NumPeriods = atoi(argv[++i]);
+			if ( NumPeriods < 1 || MinPeriod <= 0.0 || MaxPeriod < MinPeriod ) {
+				fprintf(stderr, "Invalid period range: %s %s %s\n\n", argv[i - 2], argv[i - 1], argv[i]);
+				return -1;
+			}
+		}
+		else if ( !strcmp(argv[i], "-t") && i < argc - 1 ) {
+			NumThreads = atoi(argv[++i]);
+		}
+		else if ( argv[i][0] == '-' ) {
+			fprintf(stderr, "Unknown option: %s\n\n", argv[i]);
+			return -1;
+		}
+		else {
+		/* All the remained arguments are input files */
+			InputFiles = argv + i;
+			NumInputs  = argc - i;
+			break;
+		}
+	}
+/* */
+	if ( !NumInputs ) {
+		fprintf(stderr, "No input file was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Parse the comma separated damping ratios.
+ *
+ * @param arg
+ * @return int
+ */
+static int parse_dampings( const char *arg )
+{
+	char *end;
+
+/* */
+	NumDampings = 0;
+	do {
+		if ( NumDampings >= MAX_NUM_DAMPINGS ) {
+			fprintf(stderr, "Too many damping ratios, max is %d\n\n", MAX_NUM_DAMPINGS);
+			return -1;
+		}
+		Dampings[NumDampings] = strtod(arg, &end);
+		if ( end == arg || Dampings[NumDampings] < 0.0 || Dampings[NumDampings] >= 1.0 ) {
+			fprintf(stderr, "Invalid damping ratio: %s\n\n", arg);
+			return -1;
+		}
+		NumDampings++;
+		arg = end + 1;
+	} while ( *end == ',' );
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ */
+static void usage( void )
+{
+	fprintf(stdout, "\n%s\n", PROG_NAME);
+	fprintf(stdout, "Version: %s\n", VERSION);
+	fprintf(stdout, "Author:  %s\n", AUTHOR);
+	fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+	fprintf(stdout, "***************************\n");
+	fprintf(stdout, "Usage: %s [options] <input SAC files...> > <output table>\n\n", PROG_NAME);
+	fprintf(stdout,
+		"*** Options ***\n"
+		" -v                  Report program version\n"
+		" -h                  Show this usage message\n"
+		" -g gain_factor      Specify the gain factor, it should be floating value\n"
+		" -d d1,d2,...        Specify the damping ratios, default is 0.05\n"
+		" -p min max number   Specify the log-spaced periods in sec, default is 0.01 10.0 100\n"
+		" -t threads          Specify the number of threads, default is the number of processors\n"
+		"\n"
+		"This program will calculate the response spectra (SD, PSV, PSA & SA) of the input acceleration SAC files.\n"
+		"\n"
+	);
+
+	return;
+}
@@ -0,0 +1,477 @@
+/**
+ * @file sac_spec.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <time.h>
+/* */
+#include <sachead.h>
+#include <sac.h>
+#include <fft.h>
+#include <batch.h>
+
+/* */
+#define PROG_NAME       "sac_spec"
+#define VERSION         "1.0.0 - 2026-10-18"
+#define AUTHOR          "Benjamin Ming Yang"
+/* */
+#define SPEC_PRODUCT_FAS   0x01
+#define SPEC_PRODUCT_PSD   0x02
+#define SPEC_PRODUCT_SPG   0x04
+/* */
+#define DEF_PSD_SEGMENT_SEC  60.0
+#define DEF_SPG_WINDOW_SEC   10.0
+#define DEF_OVERLAP          0.5
+#define PSD_DB_FLOOR         1.0E-30
+/* */
+static int  proc_argv( int , char * [] );
+static void usage( void );
+static void spec_job_func( void *, const int );
+static int  output_fas( const char *, const float *, const int, const double );
+static int  output_psd( const char *, const float *, const int, const double );
+static int  output_spg( const char *, const float *, const int, const double, const double );
+static int  segment_power( const FFT_PLAN *, const float *, const double *, const double, double *, double _Complex *, double * );
+static double *hann_window_gen( const int, double * );
+static FILE   *open_output( const char *, const char * );
+/* */
+static float   GainFactor  = 1.0;
+static char  **InputFiles  = NULL;
+static char   *OutputDir   = ".";
+static int     NumInputs   = 0;
+static int     NumThreads  = 0;
+static int     Products    = 0;
+static double  PsdSegment  = DEF_PSD_SEGMENT_SEC;
+static double  SpgWindow   = DEF_SPG_WINDOW_SEC;
+static double  Overlap     = DEF_OVERLAP;
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main( int argc, char **argv )
+{
+	int *results = NULL;
+	int  result  = 0;
+
+/* Check command line arguments */
+	if ( proc_argv( argc, argv ) ) {
+		usage();
+		return -1;
+	}
+/* */
+	if ( (results = (int *)calloc(NumInputs, sizeof(int))) == NULL ) {
+		fprintf(stderr, "ERROR! Out of memory for %d input files\n", NumInputs);
+		return -2;
+	}
+/* The main process, farm out the input files to threads */
+	batch_jobs_run( NumInputs, NumThreads, spec_job_func, results );
+	bufpool_stats_report( stderr );
+	for ( int i = 0; i < NumInputs; i++ )
+		if ( results[i] )
+			result = -1;
+/* */
+	free(results);
+	fft_plan_cache_free();
+
+	return result;
+}
+
+/**
+ * @brief The job function of each input file, it will be called by the batch threads.
+ *
+ * @param arg
+ * @param index
+ */
+static void spec_job_func( void *arg, const int index )
+{
+	int           *result = (int *)arg + index;
+	float         *seis   = NULL;
+	char           path[SAC_MAX_PATH_LENGTH];
+	time_t         start;
+	struct tm      tms;
+	struct SAChead sh;
+
+/* Load the SAC file to local memory */
+	*result = -1;
+	if ( sac_file_load( InputFiles[index], &sh, &seis ) < 0 )
+		return;
+/* First, preprocess the raw seismic data */
+	sac_data_preprocess( &sh, seis, GainFactor );
+/* The start time is a part of the name, so the day files of one channel won't share the products */
+	start = (time_t)floor(sac_reftime_fetch( &sh ) + sh.b);
+	gmtime_r(&start, &tms);
+	snprintf(
+		path, sizeof(path), "%s/%s.%04d%03d%02d%02d%02d", OutputDir, sac_scnl_print( &sh ),
+		tms.tm_year + 1900, tms.tm_yday + 1, tms.tm_hour, tms.tm_min, tms.tm_sec
+	);
+/* Then, generate all the products */
+	*result = 0;
+	if ( (Products & SPEC_PRODUCT_FAS) && output_fas( path, seis, sh.npts, sh.delta ) )
+		*result = -1;
+	if ( (Products & SPEC_PRODUCT_PSD) && output_psd( path, seis, sh.npts, sh.delta ) )
+		*result = -1;
+	if ( (Products & SPEC_PRODUCT_SPG) && output_spg( path, seis, sh.npts, sh.delta, sh.b ) )
+		*result = -1;
+/* */
+	if ( *result )
+		fprintf(stderr, "Error generating the spectra of %s\n", InputFiles[index]);
+	else
+		fprintf(stderr, "SAC file: %s spectra finished!\n", InputFiles[index]);
+
+	bufpool_free( seis );
+	return;
+}
+
+/**
+ * @brief Output the Fourier amplitude spectrum of the whole trace, the trace is zero padded
+ *        to the next 2, 3 & 5 composite length.
+ *
+ * @param path
+ * @param seis
+ * @param npts
+ * @param delta
+ * @return int
+ */
+static int output_fas( const char *path, const float *seis, const int npts, const double delta )
+{
+	const int       nfft = fft_size_good( npts );
+	const FFT_PLAN *plan = fft_plan_get( nfft );
+	double         *buffer;
+	FILE           *ofp;
+	int             result = -1;
+
+/* */
+	if ( !plan || (buffer = (double *)calloc(nfft + (nfft / 2 + 1) * 2, sizeof(double))) == NULL )
+		return -1;
+	for ( int i = 0; i < npts; i++ )
+		buffer[i] = seis[i];
+	if ( fft_real_forward( plan, buffer, (double _Complex *)(buffer + nfft) ) )
+		goto end_process;
+/* */
+	if ( (ofp = open_output( path, "fas" )) == NULL )
+		goto end_process;
+	fprintf(ofp, "#Frequency(Hz) Amplitude\n");
+	for ( int k = 0; k <= nfft / 2; k++ )
+		fprintf(ofp, "%.6e %.6e\n", k / (nfft * delta), cabs(((double _Complex *)(buffer + nfft))[k]) * delta);
+	result = fclose(ofp) ? -1 : 0;
+
+end_process:
+	free(buffer);
+	return result;
+}
+
+/**
+ * @brief Output the one-sided power spectral density by the Welch's method, the segments are
+ *        demeaned & Hann windowed.
+ *
+ * @param path
+ * @param seis
+ * @param npts
+ * @param delta
+ * @return int
+ */
+static int output_psd( const char *path, const float *seis, const int npts, const double delta )
+{
+	int             nseg   = (int)(PsdSegment / delta + 0.5);
+	int             step;
+	int             count  = 0;
+	int             result = -1;
+	const FFT_PLAN *plan;
+	double         *window = NULL;
+	double         *work   = NULL;
+	double         *psd    = NULL;
+	double          wss;
+	FILE           *ofp;
+
+/* */
+	if ( nseg > npts )
+		nseg = npts;
+	if ( (step = (int)(nseg * (1.0 - Overlap))) < 1 )
+		step = 1;
+	if (
+		!(plan = fft_plan_get( nseg )) ||
+		!(window = hann_window_gen( nseg, &wss )) ||
+		!(work = (double *)malloc(sizeof(double) * (nseg + (nseg / 2 + 1) * 2))) ||
+		!(psd = (double *)calloc(nseg / 2 + 1, sizeof(double)))
+	) {
+		goto end_process;
+	}
+/* Average the power of all the segments */
+	for ( int i = 0; i + nseg <= npts; i += step, count++ )
+		if ( segment_power( plan, seis + i, window, delta / wss, work, (double _Complex *)(work + nseg), psd ) )
+			goto end_process;
+/* */
+	if ( (ofp = open_output( path, "psd" )) == NULL )
+		goto end_process;
+	fprintf(ofp, "#Frequency(Hz) PSD PSD(dB) Segments: %d\n", count);
+	for ( int k = 0; k <= nseg / 2; k++ ) {
+		psd[k] /= count;
+		fprintf(ofp, "%.6e %.6e %.3f\n", k / (nseg * delta), psd[k], 10.0 * log10(psd[k] > PSD_DB_FLOOR ? psd[k] : PSD_DB_FLOOR));
+	}
+	result = fclose(ofp) ? -1 : 0;
+
+end_process:
+	free(window);
+	free(work);
+	free(psd);
+	return result;
+}
+
+/**
+ * @brief Output the spectrogram as (time, frequency, PSD in dB) triplets, the time is the
+ *        center of each window relative to the reference time.
+ *
+ * @param path
+ * @param seis
+ * @param npts
+ * @param delta
+ * @param begin
+ * @return int
+ */
+static int output_spg( const char *path, const float *seis, const int npts, const double delta, const double begin )
+{
+	int             nwin   = (int)(SpgWindow / delta + 0.5);
+	int             step;
+	int             result = -1;
+	const FFT_PLAN *plan;
+	double         *window = NULL;
+	double         *work   = NULL;
+	double         *power  = NULL;
+	double          wss;
+	FILE           *ofp    = NULL;
+
+/* */
+	if ( nwin > npts )
+		nwin = npts;
+	if ( (step = (int)(nwin * (1.0 - Overlap))) < 1 )
+		step = 1;
+	if (
+		!(plan = fft_plan_get( nwin )) ||
+		!(window = hann_window_gen( nwin, &wss )) ||
+		!(work = (double *)malloc(sizeof(double) * (nwin + (nwin / 2 + 1) * 2))) ||
+		!(power = (double *)malloc(sizeof(double) * (nwin / 2 + 1))) ||
+		!(ofp = open_output( path, "spg" ))
+	) {
+		goto end_process;
+	}
+/* */
+	fprintf(ofp, "#Time(sec) Frequency(Hz) PSD(dB)\n");
+	for ( int i = 0; i + nwin <= npts; i += step ) {
+		memset(power, 0, sizeof(double) * (nwin / 2 + 1));
+		if ( segment_power( plan, seis + i, window, delta / wss, work, (double _Complex *)(work + nwin), power ) )
+			goto end_process;
+		for ( int k = 0; k <= nwin / 2; k++ ) {
+			fprintf(
+				ofp, "%.3f %.6e %.3f\n", begin + (i + nwin * 0.5) * delta, k / (nwin * delta),
+				10.0 * log10(power[k] > PSD_DB_FLOOR ? power[k] : PSD_DB_FLOOR)
+			);
+		}
+	}
+	result = 0;
+
+end_process:
+	if ( ofp && fclose(ofp) )
+		result = -1;
+	free(window);
+	free(work);
+	free(power);
+	return result;
+}
+
+/**
+ * @brief Accumulate the one-sided power of one segment into the output.
+ *
+ * @param plan
+ * @param seis
+ * @param window
+ * @param scale
+ * @param work
+ * @param spec
+ * @param output
+ * @return int
+ */
+static int segment_power(
+	const FFT_PLAN *plan, const float *seis, const double *window, const double scale,
+	double *work, double _Complex *spec, double *output
+) {
+	const int n = plan->n;
+	double    mean = 0.0;
+
+/* */
+	for ( int i = 0; i < n; i++ )
+		mean += seis[i];
+	mean /= n;
+	for ( int i = 0; i < n; i++ )
+		work[i] = (seis[i] - mean) * window[i];
+	if ( fft_real_forward( plan, work, spec ) )
+		return -1;
+/* The DC & Nyquist terms are not doubled */
+	for ( int k = 0; k <= n / 2; k++ ) {
+		const double pw = creal(spec[k]) * creal(spec[k]) + cimag(spec[k]) * cimag(spec[k]);
+
+		output[k] += pw * scale * ((k == 0 || (k * 2 == n)) ? 1.0 : 2.0);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Generate the periodic Hann window & its sum of squares.
+ *
+ * @param n
+ * @param wss
+ * @return double*
+ */
+static double *hann_window_gen( const int n, double *wss )
+{
+	double *result = (double *)malloc(sizeof(double) * n);
+
+/* */
+	if ( result ) {
+		*wss = 0.0;
+		for ( int i = 0; i < n; i++ ) {
+			result[i] = n > 1 ? 0.5 - 0.5 * cos(2.0 * M_PI * i / n) : 1.0;
+			*wss += result[i] * result[i];
+		}
+	}
+
+	return result;
+}
+
+/**
+ * @brief
+ *
+ * @param path
+ * @param ext
+ * @return FILE*
+ */
+static FILE *open_output( const char *path, const char *ext )
+{
+	char  filename[SAC_MAX_PATH_LENGTH];
+	FILE *result;
+
+/* */
+	snprintf(filename, sizeof(filename), "%s.%s", path, ext);
+	if ( (result = fopen(filename, "w")) == NULL )
+		fprintf(stderr, "ERROR!! Can't open %s for output: %s\n", filename, strerror(errno));
+
+	return result;
+}
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+static int proc_argv( int argc, char *argv[] )
+{
+	for ( int i = 1; i < argc; i++ ) {
+		if ( !strcmp(argv[i], "-v") ) {
+			fprintf(stdout, "%s\n", PROG_NAME);
+			fprintf(stdout, "Version: %s\n", VERSION);
+			fprintf(stdout, "Author:  %s\n", AUTHOR);
+			fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-h") ) {
+			usage();
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-g") && i < argc - 1 ) {
+			GainFactor = atof(argv[++i]);
+		}
+		else if ( !strcmp(argv[i], "-a") ) {
+			Products |= SPEC_PRODUCT_FAS;
+		}
+		else if ( !strcmp(argv[i], "-p") && i < argc - 1 ) {
+			Products  |= SPEC_PRODUCT_PSD;
+			PsdSegment = atof(argv[++i]);
+		}
+		else if ( !strcmp(argv[i], "-s") && i < argc - 1 ) {
+			Products |= SPEC_PRODUCT_SPG;
+			SpgWindow = atof(argv[++i]);
+		}
+		else if ( !strcmp(argv[i], "-ov") && i < argc - 1 ) {
+			Overlap = atof(argv[++i]);
+		}
+		else if ( !strcmp(argv[i], "-o") && i < argc - 1 ) {
+			OutputDir = argv[++i];
+		}
+		else if ( !strcmp(argv[i], "-t") && i < argc - 1 ) {
+			NumThreads = atoi(argv[++i]);
+		}
+		else if ( argv[i][0] == '-' ) {
+			fprintf(stderr, "Unknown option: %s\n\n", argv[i]);
+			return -1;
+		}
+		else {
+		/* All the remained arguments are input files */
+			InputFiles = argv + i;
+			NumInputs  = argc - i;
+			break;
+		}
+	}
+/* */
+	if ( !Products )
+		Products = SPEC_PRODUCT_FAS | SPEC_PRODUCT_PSD | SPEC_PRODUCT_SPG;
+	if ( PsdSegment <= 0.0 || SpgWindow <= 0.0 || Overlap < 0.0 || Overlap >= 1.0 ) {
+		fprintf(stderr, "Invalid segment length or overlap; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+	if ( !NumInputs ) {
+		fprintf(stderr, "No input file was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ */
+static void usage( void )
+{
+	fprintf(stdout, "\n%s\n", PROG_NAME);
+	fprintf(stdout, "Version: %s\n", VERSION);
+	fprintf(stdout, "Author:  %s\n", AUTHOR);
+	fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+	fprintf(stdout, "***************************\n");
+	fprintf(stdout, "Usage: %s [options] <input SAC files...>\n\n", PROG_NAME);
+	fprintf(stdout,
+		"*** Options ***\n"
+		" -v             Report program version\n"
+		" -h             Show this usage message\n"
+		" -g gain_factor Specify the gain factor, it should be floating value\n"
+		" -a             Output the Fourier amplitude spectrum (<SCNL>.<start>.fas)\n"
+		" -p segment     Output the Welch PSD with segment length in sec (<SCNL>.<start>.psd), default is 60\n"
+		" -s window      Output the spectrogram with window length in sec (<SCNL>.<start>.spg), default is 10\n"
+		" -ov overlap    Specify the overlap ratio of the segments & windows, default is 0.5\n"
+		" -o output_dir  Specify the output directory, default is current directory\n"
+		" -t threads     Specify the number of threads, default is the number of processors\n"
+		"\n"
+		"This program will output the spectra of the input SAC files, all the products will be\n"
+		"output when none of them was specified. The <start> of the names is the start time of the\n"
+		"trace in YYYYJJJHHMMSS, so the day files of one channel can be processed together.\n"
+		"\n"
+	);
+
+	return;
+}
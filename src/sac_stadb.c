@@ -0,0 +1,152 @@
+/**
+ * @file sac_stadb.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/* */
+#include <sachead.h>
+#include <stadb.h>
+
+/* */
+#define PROG_NAME       "sac_stadb"
+#define VERSION         "1.0.0 - 2026-10-18"
+#define AUTHOR          "Benjamin Ming Yang"
+/* */
+static int  proc_argv( int , char * [] );
+static void usage( void );
+/* */
+static char *InputFile    = NULL;
+static char *SnapshotFile = NULL;
+static char *QueryScnl[4] = { NULL };
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main( int argc, char **argv )
+{
+	STADB              db;
+	const STADB_ENTRY *entry;
+	int                result = -1;
+
+/* Check command line arguments */
+	if ( proc_argv( argc, argv ) ) {
+		usage();
+		return -1;
+	}
+/* Either the station list or the snapshot */
+	if ( stadb_open( InputFile, &db ) < 0 ) {
+		fprintf(stderr, "Can't open the station database %s! Exiting!\n", InputFile);
+		return -1;
+	}
+	fprintf(stderr, "Station database %s has %u channels within %u slots!\n", InputFile, db.count, db.capacity);
+/* Query the channel */
+	if ( QueryScnl[0] ) {
+		if ( (entry = stadb_find( &db, QueryScnl[0], QueryScnl[1], QueryScnl[2], QueryScnl[3] )) == NULL ) {
+			fprintf(stderr, "Can't find %s.%s.%s.%s!\n", QueryScnl[0], QueryScnl[1], QueryScnl[2], QueryScnl[3]);
+			goto end_process;
+		}
+		fprintf(
+			stdout, "%s %s %s %s %.6f %.6f %.3f %.10g %.1f %.1f\n",
+			QueryScnl[0], QueryScnl[1], QueryScnl[2], QueryScnl[3],
+			entry->latitude, entry->longitude, entry->elevation, entry->gain, entry->cmpaz, entry->cmpinc
+		);
+	}
+/* Persist the table as the snapshot */
+	if ( SnapshotFile ) {
+		if ( stadb_snapshot_save( &db, SnapshotFile ) )
+			goto end_process;
+		fprintf(stderr, "Station snapshot %s has been written!\n", SnapshotFile);
+	}
+	result = 0;
+
+end_process:
+	stadb_close( &db );
+	return result;
+}
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+static int proc_argv( int argc, char *argv[] )
+{
+	for ( int i = 1; i < argc; i++ ) {
+		if ( !strcmp(argv[i], "-v") ) {
+			fprintf(stdout, "%s\n", PROG_NAME);
+			fprintf(stdout, "Version: %s\n", VERSION);
+			fprintf(stdout, "Author:  %s\n", AUTHOR);
+			fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-h") ) {
+			usage();
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-q") && i < argc - 4 ) {
+			for ( int j = 0; j < 4; j++ )
+				QueryScnl[j] = argv[++i];
+		}
+		else if ( i == argc - 1 ) {
+			InputFile = argv[i];
+		}
+		else if ( i == argc - 2 ) {
+			InputFile = argv[i++];
+			SnapshotFile = argv[i];
+			break;
+		}
+		else {
+			fprintf(stderr, "Unknown option: %s\n\n", argv[i]);
+			return -1;
+		}
+	}
+/* */
+	if ( !InputFile ) {
+		fprintf(stderr, "No station list was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ */
+static void usage( void )
+{
+	fprintf(stdout, "\n%s\n", PROG_NAME);
+	fprintf(stdout, "Version: %s\n", VERSION);
+	fprintf(stdout, "Author:  %s\n", AUTHOR);
+	fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+	fprintf(stdout, "***************************\n");
+	fprintf(stdout, "Usage: %s [options] <station list or snapshot> [output snapshot]\n\n", PROG_NAME);
+	fprintf(stdout,
+		"*** Options ***\n"
+		" -v                 Report program version\n"
+		" -h                 Show this usage message\n"
+		" -q sta chan net loc Query the channel & print its coordinates, gain & orientation\n"
+		"\n"
+		"This program will build the station database from the station list, each line is:\n"
+		"  sta net loc lat lon elev chanZ gainZ chanN gainN chanE gainE [azZ incZ azN incN azE incE]\n"
+		"and save it as the binary snapshot which can be mapped by the other tools with -db.\n"
+		"\n"
+	);
+
+	return;
+}
@@ -0,0 +1,403 @@
+/**
+ * @file sac_swap.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#define _GNU_SOURCE  /* For renameat2() */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+/* */
+#include <sachead.h>
+#include <sac.h>
+#include <batch.h>
+
+/* */
+#define PROG_NAME       "sac_swap"
+#define VERSION         "1.0.0 - 2026-10-18"
+#define AUTHOR          "Benjamin Ming Yang"
+/* */
+#define MAX_SWAP_PAIRS   8
+#define MAX_LINE_LENGTH  1024
+/* */
+typedef struct {
+	char comp[2];
+} SWAP_PAIR;
+
+/* */
+static int  proc_argv( int , char * [] );
+static void usage( void );
+static void swap_job_func( void *, const int );
+static int  swap_components( const int, const char *, const SWAP_PAIR * );
+static int  open_component( const int, const char *, const char, char *, struct SAChead *, int * );
+static int  parse_pairs( const char * );
+static int  load_station_list( const char * );
+/* */
+static char      *StationFile = NULL;
+static char      *WorkingDir  = NULL;
+static char      *ChanPrefix  = "HL";
+static char      *NetCode     = "TW";
+static char      *LocCode     = "--";
+static int        NumThreads  = 0;
+static SWAP_PAIR  Pairs[MAX_SWAP_PAIRS];
+static int        NumPairs    = 0;
+static char     (*Stations)[K_LEN + 1] = NULL;
+static int        NumStations = 0;
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main( int argc, char **argv )
+{
+	int *results = NULL;
+	int  result  = 0;
+	int  nswap   = 0;
+
+/* Check command line arguments */
+	if ( proc_argv( argc, argv ) ) {
+		usage();
+		return -1;
+	}
+/* */
+	if ( load_station_list( StationFile ) <= 0 ) {
+		fprintf(stderr, "Can't load any station from %s! Exiting!\n", StationFile);
+		result = -1;
+		goto end_process;
+	}
+	if ( (results = (int *)calloc(NumStations, sizeof(int))) == NULL ) {
+		fprintf(stderr, "ERROR! Out of memory for %d stations\n", NumStations);
+		result = -2;
+		goto end_process;
+	}
+/* The main process, each station is one job */
+	batch_jobs_run( NumStations, NumThreads, swap_job_func, results );
+	for ( int i = 0; i < NumStations; i++ ) {
+		if ( results[i] < 0 )
+			result = -1;
+		else
+			nswap += results[i];
+	}
+	fprintf(stderr, "Swapped %d pairs of components within %d stations!\n", nswap, NumStations);
+
+end_process:
+	free(results);
+	free(Stations);
+
+	return result;
+}
+
+/**
+ * @brief The job function of each station, the pairs will be swapped in order.
+ *
+ * @param arg
+ * @param index
+ */
+static void swap_job_func( void *arg, const int index )
+{
+	int *result = (int *)arg + index;
+	int  dirfd;
+
+/* */
+	*result = -1;
+	if ( (dirfd = open(WorkingDir, O_RDONLY | O_DIRECTORY)) < 0 ) {
+		fprintf(stderr, "Error opening the directory %s: %s\n", WorkingDir, strerror(errno));
+		return;
+	}
+	*result = 0;
+	for ( int i = 0; i < NumPairs; i++ ) {
+		if ( swap_components( dirfd, Stations[index], Pairs + i ) ) {
+			*result = -1;
+			break;
+		}
+		(*result)++;
+	}
+	close(dirfd);
+
+	return;
+}
+
+/**
+ * @brief Swap the two components of the station: the channel code & the orientation in the headers
+ *        are exchanged by one pwrite() of each header, then the file names are exchanged atomically
+ *        by renameat2(RENAME_EXCHANGE), so there is no moment that any of the channels is missing.
+ *        If the exchange fails, the original headers will be written back.
+ *
+ * @param dirfd
+ * @param sta
+ * @param pair
+ * @return int
+ */
+static int swap_components( const int dirfd, const char *sta, const SWAP_PAIR *pair )
+{
+	int            result = -1;
+	int            fd[2]  = { -1, -1 };
+	int            swap[2];
+	char           name[2][SAC_MAX_PATH_LENGTH];
+	struct SAChead sh[2], nsh[2];
+
+/* */
+	for ( int i = 0; i < 2; i++ )
+		if ( (fd[i] = open_component( dirfd, sta, pair->comp[i], name[i], sh + i, swap + i )) < 0 )
+			goto end_process;
+/* Exchange the channel code & the orientation, the others belong to the data */
+	for ( int i = 0; i < 2; i++ ) {
+		nsh[i] = sh[i];
+		memcpy(nsh[i].kcmpnm, sh[1 - i].kcmpnm, K_LEN);
+		nsh[i].cmpaz  = sh[1 - i].cmpaz;
+		nsh[i].cmpinc = sh[1 - i].cmpinc;
+	}
+/* */
+	if ( sac_header_pwrite( fd[0], swap[0], nsh ) )
+		goto end_process;
+	if ( sac_header_pwrite( fd[1], swap[1], nsh + 1 ) ) {
+		sac_header_pwrite( fd[0], swap[0], sh );
+		goto end_process;
+	}
+	if ( renameat2(dirfd, name[0], dirfd, name[1], RENAME_EXCHANGE) ) {
+		fprintf(stderr, "Error exchanging %s & %s: %s, roll back the headers!\n", name[0], name[1], strerror(errno));
+		sac_header_pwrite( fd[0], swap[0], sh );
+		sac_header_pwrite( fd[1], swap[1], sh + 1 );
+		goto end_process;
+	}
+	fprintf(stderr, "Station %s: %s & %s have been swapped!\n", sta, name[0], name[1]);
+	result = 0;
+
+end_process:
+	for ( int i = 0; i < 2; i++ )
+		if ( fd[i] >= 0 )
+			close(fd[i]);
+
+	return result;
+}
+
+/**
+ * @brief Open the file of the component & read its header, the channel code in the header should be
+ *        the same as the file name.
+ *
+ * @param dirfd
+ * @param sta
+ * @param comp
+ * @param name
+ * @param sh
+ * @param swap
+ * @return int
+ * @returns: the file descriptor on success
+ *          -1 on error
+ */
+static int open_component( const int dirfd, const char *sta, const char comp, char *name, struct SAChead *sh, int *swap )
+{
+	int  fd;
+	char chan[K_LEN + 1];
+	char scnl[SAC_MAX_SCNL_LENGTH];
+
+/* */
+	snprintf(chan, sizeof(chan), "%s%c", ChanPrefix, comp);
+	snprintf(name, SAC_MAX_PATH_LENGTH, "%s.%s.%s.%s", sta, chan, NetCode, LocCode);
+	if ( (fd = openat(dirfd, name, O_RDWR)) < 0 ) {
+		fprintf(stderr, "Error opening %s/%s: %s\n", WorkingDir, name, strerror(errno));
+		return -1;
+	}
+	if ( (*swap = sac_header_pread( fd, sh )) < 0 ) {
+		close(fd);
+		return -1;
+	}
+	if ( strcmp(name, sac_scnl_print( sh )) ) {
+		strcpy(scnl, sac_scnl_print( sh ));
+		fprintf(stderr, "The SCNL %s in the header doesn't match the file %s, skip it!\n", scnl, name);
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+/**
+ * @brief Parse the comma separated pairs of the component codes, e.g. ZE,NE.
+ *
+ * @param list
+ * @return int
+ */
+static int parse_pairs( const char *list )
+{
+	const char *pos = list;
+
+/* */
+	while ( *pos ) {
+		if ( NumPairs >= MAX_SWAP_PAIRS ) {
+			fprintf(stderr, "Too many pairs to swap, max is %d\n", MAX_SWAP_PAIRS);
+			return -1;
+		}
+		if ( !pos[0] || !pos[1] || (pos[2] && pos[2] != ',') || pos[0] == pos[1] ) {
+			fprintf(stderr, "Invalid pair of the components: %s\n", pos);
+			return -1;
+		}
+		Pairs[NumPairs].comp[0] = pos[0];
+		Pairs[NumPairs].comp[1] = pos[1];
+		NumPairs++;
+		pos += pos[2] ? 3 : 2;
+	}
+
+	return NumPairs;
+}
+
+/**
+ * @brief Load the station list, the station codes are separated by blanks & the line starts with '#'
+ *        is the comment.
+ *
+ * @param filename
+ * @return int
+ * @returns: number of the stations on success
+ *          -1 on error opening file
+ *          -2 on out of memory
+ */
+static int load_station_list( const char *filename )
+{
+	FILE *fp;
+	int   capacity = 0;
+	char  line[MAX_LINE_LENGTH];
+	char *save;
+	void *stations;
+
+/* */
+	if ( (fp = fopen(filename, "r")) == NULL ) {
+		fprintf(stderr, "Error opening %s\n", filename);
+		return -1;
+	}
+	while ( fgets(line, sizeof(line), fp) ) {
+		if ( line[0] == '#' )
+			continue;
+		for ( char *sta = strtok_r(line, " \t\r\n", &save); sta; sta = strtok_r(NULL, " \t\r\n", &save) ) {
+			if ( NumStations >= capacity ) {
+				capacity = capacity ? capacity << 1 : 64;
+				if ( (stations = realloc(Stations, capacity * sizeof(*Stations))) == NULL ) {
+					fprintf(stderr, "ERROR! Out of memory for %d stations\n", capacity);
+					fclose(fp);
+					return -2;
+				}
+				Stations = stations;
+			}
+			snprintf(Stations[NumStations++], K_LEN + 1, "%s", sta);
+		}
+	}
+	fclose(fp);
+
+	return NumStations;
+}
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+static int proc_argv( int argc, char *argv[] )
+{
+	for ( int i = 1; i < argc; i++ ) {
+		if ( !strcmp(argv[i], "-v") ) {
+			fprintf(stdout, "%s\n", PROG_NAME);
+			fprintf(stdout, "Version: %s\n", VERSION);
+			fprintf(stdout, "Author:  %s\n", AUTHOR);
+			fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-h") ) {
+			usage();
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-p") && i < argc - 1 ) {
+			if ( parse_pairs( argv[++i] ) < 0 )
+				return -1;
+		}
+		else if ( !strcmp(argv[i], "-s") && i < argc - 1 ) {
+			StationFile = argv[++i];
+		}
+		else if ( !strcmp(argv[i], "-c") && i < argc - 1 ) {
+			ChanPrefix = argv[++i];
+		}
+		else if ( !strcmp(argv[i], "-n") && i < argc - 1 ) {
+			NetCode = argv[++i];
+		}
+		else if ( !strcmp(argv[i], "-l") && i < argc - 1 ) {
+			LocCode = argv[++i];
+		}
+		else if ( !strcmp(argv[i], "-t") && i < argc - 1 ) {
+			NumThreads = atoi(argv[++i]);
+		}
+		else if ( i == argc - 1 ) {
+			WorkingDir = argv[i];
+		}
+		else {
+			fprintf(stderr, "Unknown option: %s\n\n", argv[i]);
+			return -1;
+		}
+	}
+/* */
+	if ( !NumPairs ) {
+		fprintf(stderr, "No pair of the components was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+	if ( !StationFile ) {
+		fprintf(stderr, "No station list was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+	if ( !WorkingDir ) {
+		fprintf(stderr, "No directory was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+	if ( strlen(ChanPrefix) >= K_LEN ) {
+		fprintf(stderr, "The channel prefix %s is too long; ", ChanPrefix);
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ */
+static void usage( void )
+{
+	fprintf(stdout, "\n%s\n", PROG_NAME);
+	fprintf(stdout, "Version: %s\n", VERSION);
+	fprintf(stdout, "Author:  %s\n", AUTHOR);
+	fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+	fprintf(stdout, "***************************\n");
+	fprintf(stdout, "Usage: %s -p <pairs> -s <station list> [options] <directory>\n\n", PROG_NAME);
+	fprintf(stdout,
+		"*** Options ***\n"
+		" -v             Report program version\n"
+		" -h             Show this usage message\n"
+		" -p pairs       Specify the comma separated pairs of the components to swap in order, e.g. ZE or\n"
+		"                ZE,NE (the permutation Z->N->E->Z)\n"
+		" -s sta_list    Specify the list of the station codes separated by blanks\n"
+		" -c chan_prefix Specify the prefix of the channel codes, default is HL\n"
+		" -n network     Specify the network code, default is TW\n"
+		" -l location    Specify the location code, default is --\n"
+		" -t threads     Specify the number of threads, default is the number of processors\n"
+		"\n"
+		"This program will swap the components of the stations on the list within the directory, the\n"
+		"files are sta.chan.net.loc. Only the channel codes & orientations in the headers are rewritten,\n"
+		"then the file names are exchanged atomically.\n"
+		"\n"
+	);
+
+	return;
+}
@@ -0,0 +1,285 @@
+/**
+ * @file sac_zip.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+/* */
+#include <sachead.h>
+#include <sac.h>
+#include <sacz.h>
+#include <batch.h>
+
+/* */
+#define PROG_NAME       "sac_zip"
+#define VERSION         "1.0.0 - 2026-10-18"
+#define AUTHOR          "Benjamin Ming Yang"
+/* */
+#define SACZ_FILE_EXT   ".sacz"
+/* */
+typedef struct {
+	long input;   /* Size of the input file */
+	long output;  /* Size of the output file, negative on error */
+} ZIP_RESULT;
+
+/* */
+static int  proc_argv( int , char * [] );
+static void usage( void );
+static void zip_job_func( void *, const int );
+static int  gen_output_path( const char *, char *, const size_t );
+static long write_plain_file( const char *, const struct SAChead *, const float * );
+/* */
+static char **InputFiles   = NULL;
+static int    NumInputs    = 0;
+static int    NumThreads   = 0;
+static char  *OutputDir    = NULL;
+static int    Decompress   = 0;
+static int    FrameSamples = SACZ_DEF_FRAME_SAMPLES;
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main( int argc, char **argv )
+{
+	ZIP_RESULT *results = NULL;
+	long        insize  = 0;
+	long        outsize = 0;
+	int         result  = 0;
+
+/* Check command line arguments */
+	if ( proc_argv( argc, argv ) ) {
+		usage();
+		return -1;
+	}
+	if ( (results = (ZIP_RESULT *)calloc(NumInputs, sizeof(ZIP_RESULT))) == NULL ) {
+		fprintf(stderr, "ERROR! Out of memory for %d input files\n", NumInputs);
+		return -2;
+	}
+/* The main process, the queue of the input files is shared by the threads */
+	batch_jobs_run( NumInputs, NumThreads, zip_job_func, results );
+	bufpool_stats_report( stderr );
+	for ( int i = 0; i < NumInputs; i++ ) {
+		if ( results[i].output < 0 ) {
+			result = -1;
+			continue;
+		}
+		insize  += results[i].input;
+		outsize += results[i].output;
+	}
+	fprintf(
+		stderr, "%s %ld bytes into %ld bytes (%.2f%%)!\n",
+		Decompress ? "Decompressed" : "Compressed", insize, outsize, insize ? outsize * 100.0 / insize : 0.0
+	);
+	free(results);
+
+	return result;
+}
+
+/**
+ * @brief The job function of each input file, it will be called by the batch threads.
+ *
+ * @param arg
+ * @param index
+ */
+static void zip_job_func( void *arg, const int index )
+{
+	ZIP_RESULT    *result = (ZIP_RESULT *)arg + index;
+	struct SAChead sh;
+	struct stat    st;
+	float         *seis = NULL;
+	char           path[SAC_MAX_PATH_LENGTH];
+
+/* */
+	result->output = -1;
+	if ( gen_output_path( InputFiles[index], path, sizeof(path) ) )
+		return;
+	if ( sac_file_load( InputFiles[index], &sh, &seis ) < 0 ) {
+		fprintf(stderr, "Error loading SAC file: %s!\n", InputFiles[index]);
+		return;
+	}
+/* The size on disk, the loaded size is always the decoded one */
+	result->input = stat(InputFiles[index], &st) ? 0 : (long)st.st_size;
+	result->output = Decompress ? write_plain_file( path, &sh, seis ) : sacz_file_write( path, &sh, seis, FrameSamples );
+	if ( result->output >= 0 ) {
+		fprintf(
+			stderr, "SAC file: %s -> %s, %ld bytes into %ld bytes!\n",
+			InputFiles[index], path, result->input, result->output
+		);
+	}
+	bufpool_free( seis );
+
+	return;
+}
+
+/**
+ * @brief Generate the output path, the extension is appended when compressing & removed when
+ *        decompressing.
+ *
+ * @param input
+ * @param output
+ * @param size
+ * @return int
+ */
+static int gen_output_path( const char *input, char *output, const size_t size )
+{
+	const char  *base = OutputDir && strrchr(input, '/') ? strrchr(input, '/') + 1 : input;
+	const size_t ext  = strlen(SACZ_FILE_EXT);
+	const char  *tail = SACZ_FILE_EXT;
+	int          len  = strlen(base);
+	int          ret;
+
+/* */
+	if ( Decompress ) {
+		if ( len > (int)ext && !strcmp(base + len - ext, SACZ_FILE_EXT) ) {
+			len -= ext;
+			tail = "";
+		}
+		else {
+			fprintf(stderr, "WARNING: %s doesn't have the extension %s!\n", input, SACZ_FILE_EXT);
+			tail = ".sac";
+		}
+	}
+	ret = OutputDir ?
+		snprintf(output, size, "%s/%.*s%s", OutputDir, len, base, tail) :
+		snprintf(output, size, "%.*s%s", len, base, tail);
+	if ( ret < 0 || (size_t)ret >= size ) {
+		fprintf(stderr, "The output path of %s is too long!\n", input);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ * @param filename
+ * @param sh
+ * @param seis
+ * @return long
+ */
+static long write_plain_file( const char *filename, const struct SAChead *sh, const float *seis )
+{
+	FILE *fp;
+
+/* */
+	if ( (fp = fopen(filename, "wb")) == (FILE *)NULL ) {
+		fprintf(stderr, "ERROR!! Can't open %s for output!\n", filename);
+		return -1;
+	}
+	if (
+		fwrite(sh, 1, sizeof(struct SAChead), fp) != sizeof(struct SAChead) ||
+		fwrite(seis, sizeof(float), sh->npts, fp) != (size_t)sh->npts
+	) {
+		fprintf(stderr, "Error writing SAC file: %s\n", strerror(errno));
+		fclose(fp);
+		remove(filename);
+		return -1;
+	}
+	fclose(fp);
+
+	return sizeof(struct SAChead) + (long)sh->npts * sizeof(float);
+}
+
+/**
+ * @brief
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+static int proc_argv( int argc, char *argv[] )
+{
+	for ( int i = 1; i < argc; i++ ) {
+		if ( !strcmp(argv[i], "-v") ) {
+			fprintf(stdout, "%s\n", PROG_NAME);
+			fprintf(stdout, "Version: %s\n", VERSION);
+			fprintf(stdout, "Author:  %s\n", AUTHOR);
+			fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-h") ) {
+			usage();
+			exit(0);
+		}
+		else if ( !strcmp(argv[i], "-d") ) {
+			Decompress = 1;
+		}
+		else if ( !strcmp(argv[i], "-fs") && i < argc - 1 ) {
+			FrameSamples = atoi(argv[++i]);
+		}
+		else if ( !strcmp(argv[i], "-o") && i < argc - 1 ) {
+			OutputDir = argv[++i];
+		}
+		else if ( !strcmp(argv[i], "-t") && i < argc - 1 ) {
+			NumThreads = atoi(argv[++i]);
+		}
+		else if ( argv[i][0] == '-' ) {
+			fprintf(stderr, "Unknown option: %s\n\n", argv[i]);
+			return -1;
+		}
+		else {
+		/* All the remained arguments are input files */
+			InputFiles = argv + i;
+			NumInputs  = argc - i;
+			break;
+		}
+	}
+/* */
+	if ( FrameSamples <= 0 || FrameSamples % SACZ_BLOCK_SAMPLES ) {
+		fprintf(stderr, "The samples of the frame should be the multiple of %d; ", SACZ_BLOCK_SAMPLES);
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+	if ( !NumInputs ) {
+		fprintf(stderr, "No input file was specified; ");
+		fprintf(stderr, "exiting with error!\n\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ */
+static void usage( void )
+{
+	fprintf(stdout, "\n%s\n", PROG_NAME);
+	fprintf(stdout, "Version: %s\n", VERSION);
+	fprintf(stdout, "Author:  %s\n", AUTHOR);
+	fprintf(stdout, "Compiled at %s %s\n", __DATE__, __TIME__);
+	fprintf(stdout, "***************************\n");
+	fprintf(stdout, "Usage: %s [options] <input SAC files...>\n\n", PROG_NAME);
+	fprintf(stdout,
+		"*** Options ***\n"
+		" -v             Report program version\n"
+		" -h             Show this usage message\n"
+		" -d             Decompress the input files back to the plain SAC files\n"
+		" -fs samples    Specify the samples of each compressed frame, it should be the multiple of 16,\n"
+		"                default is 4096\n"
+		" -o output_dir  Specify the output directory, default is the same as the input file\n"
+		" -t threads     Specify the number of threads, default is the number of processors\n"
+		"\n"
+		"This program will compress the input SAC files into the seekable containers (" SACZ_FILE_EXT "), the\n"
+		"header is kept as is & the samples are stored by independent frames, so the other programs can\n"
+		"read them directly. The lossless codec works best with the integer counts.\n"
+		"\n"
+	);
+
+	return;
+}
@@ -0,0 +1,281 @@
+/**
+ * @file sacbundle.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Main source code for the multi-trace event bundle. All the SAC headers of the event are
+ *        stored as the sorted directory up front & the samples of each trace start at the page
+ *        boundary, so the whole event is loaded by one mmap() & every trace is found by the
+ *        binary search of its SCNL.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+/* */
+#include <sachead.h>
+#include <sac.h>
+#include <sacbundle.h>
+
+/* */
+#define PAGE_ALIGN(__SIZE)  (((__SIZE) + SACB_PAGE_SIZE - 1) & ~(uint64_t)(SACB_PAGE_SIZE - 1))
+
+/* */
+static int  compare_entry( const void *, const void * );
+static int  write_padding( FILE *, const uint64_t );
+
+/**
+ * @brief Map the bundle & set up the traces, nothing will be parsed or copied.
+ *
+ * @param filename
+ * @param bundle
+ * @return int
+ * @returns: number of the traces on success
+ *          -1 on error opening file or invalid bundle
+ *          -2 on out of memory
+ */
+int sacbundle_open( const char *filename, SAC_BUNDLE *bundle )
+{
+	int                     fd;
+	struct stat             st;
+	const SACB_FILE_HEADER *header;
+	const SACB_ENTRY       *entry;
+
+/* */
+	memset(bundle, 0, sizeof(SAC_BUNDLE));
+	if ( (fd = open(filename, O_RDONLY)) < 0 ) {
+		fprintf(stderr, "Error opening %s\n", filename);
+		return -1;
+	}
+	if ( fstat(fd, &st) || st.st_size < (off_t)sizeof(SACB_FILE_HEADER) ) {
+		fprintf(stderr, "Invalid SAC bundle %s\n", filename);
+		close(fd);
+		return -1;
+	}
+	bundle->map = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if ( bundle->map == MAP_FAILED ) {
+		fprintf(stderr, "Error mapping %s: %s\n", filename, strerror(errno));
+		bundle->map = NULL;
+		return -1;
+	}
+	bundle->map_size = st.st_size;
+/* */
+	header = (const SACB_FILE_HEADER *)bundle->map;
+	if (
+		header->magic != SACB_MAGIC || header->version != SACB_VERSION ||
+		header->entry_size != sizeof(SACB_ENTRY) || header->page_size != SACB_PAGE_SIZE ||
+		header->size != bundle->map_size ||
+		bundle->map_size < sizeof(SACB_FILE_HEADER) + (size_t)header->count * sizeof(SACB_ENTRY)
+	) {
+		fprintf(stderr, "Invalid SAC bundle %s\n", filename);
+		sacbundle_close( bundle );
+		return -1;
+	}
+	bundle->entries = (SACB_ENTRY *)(header + 1);
+	bundle->count   = header->count;
+	if ( (bundle->traces = (SACB_TRACE *)calloc(bundle->count ? bundle->count : 1, sizeof(SACB_TRACE))) == NULL ) {
+		fprintf(stderr, "ERROR! Out of memory for %d traces\n", bundle->count);
+		sacbundle_close( bundle );
+		return -2;
+	}
+/* Every sample block should be within the file */
+	for ( int i = 0; i < bundle->count; i++ ) {
+		entry = bundle->entries + i;
+		if (
+			entry->sh.npts < 0 || entry->offset % SACB_PAGE_SIZE ||
+			entry->offset + (uint64_t)entry->sh.npts * sizeof(float) > bundle->map_size
+		) {
+			fprintf(stderr, "Invalid trace #%d of the SAC bundle %s\n", i, filename);
+			sacbundle_close( bundle );
+			return -1;
+		}
+		bundle->traces[i].sh   = &bundle->entries[i].sh;
+		bundle->traces[i].seis = (float *)((uint8_t *)bundle->map + entry->offset);
+	}
+
+	return bundle->count;
+}
+
+/**
+ * @brief
+ *
+ * @param bundle
+ */
+void sacbundle_close( SAC_BUNDLE *bundle )
+{
+	if ( bundle->map )
+		munmap(bundle->map, bundle->map_size);
+	free(bundle->traces);
+	memset(bundle, 0, sizeof(SAC_BUNDLE));
+
+	return;
+}
+
+/**
+ * @brief
+ *
+ * @param bundle
+ * @param sta
+ * @param chan
+ * @param net
+ * @param loc
+ * @return const SACB_TRACE*
+ */
+const SACB_TRACE *sacbundle_find( const SAC_BUNDLE *bundle, const char *sta, const char *chan, const char *net, const char *loc )
+{
+	SACB_ENTRY        key;
+	const SACB_ENTRY *result;
+
+/* */
+	sac_scnl_key_pack( key.key, sta, chan, net, loc );
+	result = (const SACB_ENTRY *)bsearch(&key, bundle->entries, bundle->count, sizeof(SACB_ENTRY), compare_entry);
+
+	return result ? bundle->traces + (result - bundle->entries) : NULL;
+}
+
+/**
+ * @brief Find the trace by the SCNL of the SAC header.
+ *
+ * @param bundle
+ * @param sh
+ * @return const SACB_TRACE*
+ */
+const SACB_TRACE *sacbundle_find_sac( const SAC_BUNDLE *bundle, const struct SAChead *sh )
+{
+	SACB_ENTRY        key;
+	const SACB_ENTRY *result;
+
+/* */
+	sac_scnl_key_fetch( key.key, sh );
+	result = (const SACB_ENTRY *)bsearch(&key, bundle->entries, bundle->count, sizeof(SACB_ENTRY), compare_entry);
+
+	return result ? bundle->traces + (result - bundle->entries) : NULL;
+}
+
+/**
+ * @brief Write the traces into the bundle, the directory will be sorted by the SCNL & the duplicated
+ *        SCNL is not allowed. The headers should be in the native byte order.
+ *
+ * @param filename
+ * @param traces
+ * @param count
+ * @return long
+ * @returns: the size of the output file on success
+ *          -1 on error writing file or the duplicated SCNL
+ *          -2 on out of memory
+ */
+long sacbundle_write( const char *filename, const SACB_TRACE *traces, const int count )
+{
+	FILE            *fp      = NULL;
+	SACB_FILE_HEADER header  = { 0 };
+	SACB_ENTRY      *entries = NULL;
+	uint64_t         offset;
+	long             result  = -1;
+
+/* */
+	if ( (entries = (SACB_ENTRY *)calloc(count ? count : 1, sizeof(SACB_ENTRY))) == NULL ) {
+		fprintf(stderr, "ERROR! Out of memory for %d traces\n", count);
+		return -2;
+	}
+/* The reserved field keeps the index of the trace while sorting */
+	for ( int i = 0; i < count; i++ ) {
+		entries[i].sh       = *traces[i].sh;
+		entries[i].reserved = i;
+		sac_scnl_key_fetch( entries[i].key, traces[i].sh );
+	}
+	qsort(entries, count, sizeof(SACB_ENTRY), compare_entry);
+/* The layout of the sample blocks */
+	offset = PAGE_ALIGN(sizeof(SACB_FILE_HEADER) + (uint64_t)count * sizeof(SACB_ENTRY));
+	for ( int i = 0; i < count; i++ ) {
+		if ( i && !compare_entry( entries + i - 1, entries + i ) ) {
+			fprintf(
+				stderr, "Duplicated trace %.*s.%.*s.%.*s.%.*s in the SAC bundle!\n",
+				K_LEN, entries[i].key, K_LEN, entries[i].key + K_LEN, K_LEN, entries[i].key + K_LEN * 2, K_LEN, entries[i].key + K_LEN * 3
+			);
+			goto end_process;
+		}
+		entries[i].offset = offset;
+		offset = PAGE_ALIGN(offset + (uint64_t)entries[i].sh.npts * sizeof(float));
+	}
+	header.magic      = SACB_MAGIC;
+	header.version    = SACB_VERSION;
+	header.entry_size = sizeof(SACB_ENTRY);
+	header.count      = count;
+	header.page_size  = SACB_PAGE_SIZE;
+	header.size       = count ? entries[count - 1].offset + (uint64_t)entries[count - 1].sh.npts * sizeof(float) : sizeof(header);
+/* */
+	if ( (fp = fopen(filename, "wb")) == NULL ) {
+		fprintf(stderr, "ERROR!! Can't open %s for output!\n", filename);
+		goto end_process;
+	}
+	offset = sizeof(SACB_FILE_HEADER) + (uint64_t)count * sizeof(SACB_ENTRY);
+	if ( fwrite(&header, sizeof(header), 1, fp) != 1 )
+		goto write_error;
+	for ( int i = 0; i < count; i++ ) {
+		SACB_ENTRY entry = entries[i];
+
+		entry.reserved = 0;
+		if ( fwrite(&entry, sizeof(SACB_ENTRY), 1, fp) != 1 )
+			goto write_error;
+	}
+	for ( int i = 0; i < count; i++ ) {
+		if (
+			write_padding( fp, entries[i].offset - offset ) ||
+			fwrite(traces[entries[i].reserved].seis, sizeof(float), entries[i].sh.npts, fp) != (size_t)entries[i].sh.npts
+		) {
+			goto write_error;
+		}
+		offset = entries[i].offset + (uint64_t)entries[i].sh.npts * sizeof(float);
+	}
+	if ( fclose(fp) ) {
+		fp = NULL;
+		goto write_error;
+	}
+	result = (long)header.size;
+	goto end_process;
+
+write_error:
+	fprintf(stderr, "Error writing SAC bundle: %s\n", strerror(errno));
+	if ( fp )
+		fclose(fp);
+	remove(filename);
+end_process:
+	free(entries);
+	return result;
+}
+
+/**
+ * @brief
+ *
+ * @param a
+ * @param b
+ * @return int
+ */
+static int compare_entry( const void *a, const void *b )
+{
+	return memcmp(((const SACB_ENTRY *)a)->key, ((const SACB_ENTRY *)b)->key, SACB_KEY_LENGTH);
+}
+
+/**
+ * @brief
+ *
+ * @param fp
+ * @param size
+ * @return int
+ */
+static int write_padding( FILE *fp, const uint64_t size )
+{
+	static const uint8_t zeros[SACB_PAGE_SIZE] = { 0 };
+
+/* The gap is always less than one page */
+	return size > SACB_PAGE_SIZE || fwrite(zeros, 1, size, fp) != size ? -1 : 0;
+}
@@ -0,0 +1,215 @@
+/**
+ * @file sacfield.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Main source code for accessing the SAC header fields by name. Each field is one entry of
+ *        the static table with its offset within the header, so the name is only resolved once &
+ *        the value is fetched directly from the header after that.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stddef.h>
+/* */
+#include <sachead.h>
+#include <sac.h>
+#include <sacfield.h>
+
+/* */
+#define FLOAT_FIELD(__NAME)   { #__NAME, offsetof(struct SAChead, __NAME), SAC_FIELD_FLOAT, sizeof(float) }
+#define INT_FIELD(__NAME)     { #__NAME, offsetof(struct SAChead, __NAME), SAC_FIELD_INT, sizeof(int) }
+#define STRING_FIELD(__NAME)  { #__NAME, offsetof(struct SAChead, __NAME), SAC_FIELD_STRING, sizeof(((struct SAChead *)0)->__NAME) }
+#define TIME_FIELD(__NAME, __REL) \
+		{ __NAME, offsetof(struct SAChead, __REL), SAC_FIELD_TIME, sizeof(float) }
+#define FIELD_PTR(__SH, __FIELD)  ((const uint8_t *)(__SH) + (__FIELD)->offset)
+
+/* All the named fields of the header */
+static const SAC_FIELD FieldTable[] = {
+	FLOAT_FIELD(delta), FLOAT_FIELD(depmin), FLOAT_FIELD(depmax), FLOAT_FIELD(scale), FLOAT_FIELD(odelta),
+	FLOAT_FIELD(b), FLOAT_FIELD(e), FLOAT_FIELD(o), FLOAT_FIELD(a),
+	FLOAT_FIELD(t0), FLOAT_FIELD(t1), FLOAT_FIELD(t2), FLOAT_FIELD(t3), FLOAT_FIELD(t4),
+	FLOAT_FIELD(t5), FLOAT_FIELD(t6), FLOAT_FIELD(t7), FLOAT_FIELD(t8), FLOAT_FIELD(t9), FLOAT_FIELD(f),
+	FLOAT_FIELD(resp0), FLOAT_FIELD(resp1), FLOAT_FIELD(resp2), FLOAT_FIELD(resp3), FLOAT_FIELD(resp4),
+	FLOAT_FIELD(resp5), FLOAT_FIELD(resp6), FLOAT_FIELD(resp7), FLOAT_FIELD(resp8), FLOAT_FIELD(resp9),
+	FLOAT_FIELD(stla), FLOAT_FIELD(stlo), FLOAT_FIELD(stel), FLOAT_FIELD(stdp),
+	FLOAT_FIELD(evla), FLOAT_FIELD(evlo), FLOAT_FIELD(evel), FLOAT_FIELD(evdp),
+	FLOAT_FIELD(user0), FLOAT_FIELD(user1), FLOAT_FIELD(user2), FLOAT_FIELD(user3), FLOAT_FIELD(user4),
+	FLOAT_FIELD(user5), FLOAT_FIELD(user6), FLOAT_FIELD(user7), FLOAT_FIELD(user8), FLOAT_FIELD(user9),
+	FLOAT_FIELD(dist), FLOAT_FIELD(az), FLOAT_FIELD(baz), FLOAT_FIELD(gcarc),
+	FLOAT_FIELD(depmen), FLOAT_FIELD(cmpaz), FLOAT_FIELD(cmpinc),
+	INT_FIELD(nzyear), INT_FIELD(nzjday), INT_FIELD(nzhour), INT_FIELD(nzmin), INT_FIELD(nzsec), INT_FIELD(nzmsec),
+	{ "nvhdr", offsetof(struct SAChead, internal4), SAC_FIELD_INT, sizeof(int) },
+	INT_FIELD(npts), INT_FIELD(iftype), INT_FIELD(idep), INT_FIELD(iztype), INT_FIELD(iinst),
+	INT_FIELD(istreg), INT_FIELD(ievreg), INT_FIELD(ievtyp), INT_FIELD(iqual), INT_FIELD(isynth),
+	INT_FIELD(leven), INT_FIELD(lpspol), INT_FIELD(lovrok), INT_FIELD(lcalda),
+	STRING_FIELD(kstnm), STRING_FIELD(kevnm), STRING_FIELD(khole), STRING_FIELD(ko), STRING_FIELD(ka),
+	STRING_FIELD(kt0), STRING_FIELD(kt1), STRING_FIELD(kt2), STRING_FIELD(kt3), STRING_FIELD(kt4),
+	STRING_FIELD(kt5), STRING_FIELD(kt6), STRING_FIELD(kt7), STRING_FIELD(kt8), STRING_FIELD(kt9),
+	STRING_FIELD(kf), STRING_FIELD(kuser0), STRING_FIELD(kuser1), STRING_FIELD(kuser2),
+	STRING_FIELD(kcmpnm), STRING_FIELD(knetwk), STRING_FIELD(kdatrd), STRING_FIELD(kinst),
+/* The pseudo fields of the absolute time */
+	TIME_FIELD("starttime", b), TIME_FIELD("endtime", e), TIME_FIELD("origin", o)
+};
+
+/**
+ * @brief Find the field by the name (case insensitive).
+ *
+ * @param name
+ * @return const SAC_FIELD*
+ * @returns: the field on success
+ *           NULL if the name is not a header field
+ */
+const SAC_FIELD *sacfield_find( const char *name )
+{
+	for ( size_t i = 0; i < sizeof(FieldTable) / sizeof(SAC_FIELD); i++ )
+		if ( !strcasecmp(FieldTable[i].name, name) )
+			return FieldTable + i;
+
+	return NULL;
+}
+
+/**
+ * @brief
+ *
+ * @param field
+ * @return int
+ */
+int sacfield_is_numeric( const SAC_FIELD *field )
+{
+	return field->type != SAC_FIELD_STRING;
+}
+
+/**
+ * @brief Fetch the value of the numeric field, the undefined relative time will be kept as undefined.
+ *
+ * @param sh
+ * @param field
+ * @return double
+ */
+double sacfield_number_get( const struct SAChead *sh, const SAC_FIELD *field )
+{
+	float fvalue;
+	int   ivalue;
+
+/* */
+	switch ( field->type ) {
+	case SAC_FIELD_FLOAT:
+		memcpy(&fvalue, FIELD_PTR(sh, field), sizeof(float));
+		return fvalue;
+	case SAC_FIELD_INT:
+		memcpy(&ivalue, FIELD_PTR(sh, field), sizeof(int));
+		return ivalue;
+	case SAC_FIELD_TIME:
+		memcpy(&fvalue, FIELD_PTR(sh, field), sizeof(float));
+		return fvalue == SACUNDEF ? SACUNDEF : sac_reftime_fetch( sh ) + fvalue;
+	default:
+		break;
+	}
+
+	return SACUNDEF;
+}
+
+/**
+ * @brief Fetch the string field without the trailing blanks, the buffer should be at least
+ *        KEVNMLEN + 1 bytes.
+ *
+ * @param sh
+ * @param field
+ * @param buffer
+ * @return char*
+ */
+char *sacfield_string_get( const struct SAChead *sh, const SAC_FIELD *field, char *buffer )
+{
+	int len = field->type == SAC_FIELD_STRING ? field->length : 0;
+
+/* */
+	memcpy(buffer, FIELD_PTR(sh, field), len);
+	buffer[len] = '\0';
+	while ( len > 0 && (buffer[len - 1] == ' ' || buffer[len - 1] == '\0') )
+		buffer[--len] = '\0';
+
+	return buffer;
+}
+
+/**
+ * @brief Print the value of the field into the buffer.
+ *
+ * @param sh
+ * @param field
+ * @param buffer
+ * @param size
+ * @return int
+ * @returns: the length of the printed value
+ */
+int sacfield_value_print( const struct SAChead *sh, const SAC_FIELD *field, char *buffer, const int size )
+{
+	char string[KEVNMLEN + 1];
+
+/* */
+	switch ( field->type ) {
+	case SAC_FIELD_FLOAT:
+		return snprintf(buffer, size, "%.7g", sacfield_number_get( sh, field ));
+	case SAC_FIELD_INT:
+		return snprintf(buffer, size, "%d", (int)sacfield_number_get( sh, field ));
+	case SAC_FIELD_TIME:
+		return snprintf(buffer, size, "%.3f", sacfield_number_get( sh, field ));
+	default:
+		return snprintf(buffer, size, "%s", sacfield_string_get( sh, field, string ));
+	}
+}
+
+/**
+ * @brief Set the field from the value string, the string field will be blank padded & the absolute
+ *        time field accepts the epoch seconds or YYYY-MM-DDThh:mm:ss.sss (UTC).
+ *
+ * @param sh
+ * @param field
+ * @param value
+ * @return int
+ * @returns: 0 on success
+ *          -1 on invalid value
+ */
+int sacfield_value_set( struct SAChead *sh, const SAC_FIELD *field, const char *value )
+{
+	uint8_t *dest = (uint8_t *)sh + field->offset;
+	char    *end;
+	float    fvalue;
+	int      ivalue;
+	double   time;
+	int      len;
+
+/* */
+	switch ( field->type ) {
+	case SAC_FIELD_FLOAT:
+		fvalue = strtof(value, &end);
+		if ( end == value || *end != '\0' )
+			return -1;
+		memcpy(dest, &fvalue, sizeof(float));
+		break;
+	case SAC_FIELD_INT:
+		ivalue = (int)strtol(value, &end, 10);
+		if ( end == value || *end != '\0' )
+			return -1;
+		memcpy(dest, &ivalue, sizeof(int));
+		break;
+	case SAC_FIELD_TIME:
+		if ( (time = sac_time_parse( value )) < 0.0 )
+			return -1;
+		fvalue = time - sac_reftime_fetch( sh );
+		memcpy(dest, &fvalue, sizeof(float));
+		break;
+	default:
+		if ( (len = strlen(value)) > field->length )
+			return -1;
+		memcpy(dest, value, len);
+		memset(dest + len, ' ', field->length - len);
+		break;
+	}
+
+	return 0;
+}
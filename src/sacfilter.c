@@ -0,0 +1,394 @@
+/**
+ * @file sacfilter.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Main source code for the SAC header filter expression. The expression, e.g.
+ *          kcmpnm ~ HL? && delta == 0.01 && (npts < 1000 || starttime >= 2024-04-01T00:00:00)
+ *        is parsed by recursive descent & compiled into the postfix instructions once, the field
+ *        names & constants are resolved at that time, so matching one header is only a short loop.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <fnmatch.h>
+/* */
+#include <sachead.h>
+#include <sac.h>
+#include <sacfield.h>
+#include <sacfilter.h>
+
+/*----------------------------------------------------------------------*
+ * Definition of the parser state                                       *
+ *----------------------------------------------------------------------*/
+typedef struct {
+	const char *pos;
+	SAC_FILTER *filter;
+} FILTER_PARSER;
+
+/* */
+static int  parse_or( FILTER_PARSER * );
+static int  parse_and( FILTER_PARSER * );
+static int  parse_unary( FILTER_PARSER * );
+static int  parse_compare( FILTER_PARSER * );
+static int  parse_relation( FILTER_PARSER * );
+static int  parse_value( FILTER_PARSER *, char * );
+static int  emit_insn( FILTER_PARSER *, const SAC_FILTER_INSN * );
+static int  match_token( FILTER_PARSER *, const char * );
+static int  compare_insn( const SAC_FILTER_INSN *, const struct SAChead * );
+
+/**
+ * @brief Compile the filter expression, the operators are || && ! ( ) and the comparisons are
+ *        == (or =) != < <= > >= for all fields, ~ & !~ (glob pattern) for the string fields.
+ *
+ * @param expr
+ * @param filter
+ * @return int
+ * @returns: number of the instructions on success
+ *          -1 on invalid expression
+ */
+int sacfilter_compile( const char *expr, SAC_FILTER *filter )
+{
+	FILTER_PARSER parser = { expr, filter };
+
+/* */
+	filter->count = 0;
+	if ( !expr )
+		return 0;
+	while ( isspace(*parser.pos) )
+		parser.pos++;
+	if ( *parser.pos == '\0' )
+		return 0;
+/* */
+	if ( parse_or( &parser ) )
+		return -1;
+	if ( *parser.pos != '\0' ) {
+		fprintf(stderr, "Invalid filter expression near: %s\n", parser.pos);
+		filter->count = 0;
+		return -1;
+	}
+
+	return filter->count;
+}
+
+/**
+ * @brief
+ *
+ * @param filter
+ * @param sh
+ * @return int
+ * @returns: 1 if the header matches the filter
+ *           0 if not
+ */
+int sacfilter_match( const SAC_FILTER *filter, const struct SAChead *sh )
+{
+	uint8_t stack[SAC_FILTER_MAX_INSNS];
+	int     top = 0;
+
+/* */
+	if ( !filter->count )
+		return 1;
+	for ( int i = 0; i < filter->count; i++ ) {
+		const SAC_FILTER_INSN *insn = filter->insns + i;
+
+		switch ( insn->op ) {
+		case SAC_FILTER_OP_CMP:
+			stack[top++] = compare_insn( insn, sh );
+			break;
+		case SAC_FILTER_OP_AND:
+			top--;
+			stack[top - 1] &= stack[top];
+			break;
+		case SAC_FILTER_OP_OR:
+			top--;
+			stack[top - 1] |= stack[top];
+			break;
+		case SAC_FILTER_OP_NOT:
+			stack[top - 1] ^= 1;
+			break;
+		}
+	}
+
+	return stack[0];
+}
+
+/**
+ * @brief
+ *
+ * @param parser
+ * @return int
+ */
+static int parse_or( FILTER_PARSER *parser )
+{
+	const SAC_FILTER_INSN insn = { .op = SAC_FILTER_OP_OR };
+
+/* */
+	if ( parse_and( parser ) )
+		return -1;
+	while ( match_token( parser, "||" ) )
+		if ( parse_and( parser ) || emit_insn( parser, &insn ) )
+			return -1;
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ * @param parser
+ * @return int
+ */
+static int parse_and( FILTER_PARSER *parser )
+{
+	const SAC_FILTER_INSN insn = { .op = SAC_FILTER_OP_AND };
+
+/* */
+	if ( parse_unary( parser ) )
+		return -1;
+	while ( match_token( parser, "&&" ) )
+		if ( parse_unary( parser ) || emit_insn( parser, &insn ) )
+			return -1;
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ * @param parser
+ * @return int
+ */
+static int parse_unary( FILTER_PARSER *parser )
+{
+	const SAC_FILTER_INSN insn = { .op = SAC_FILTER_OP_NOT };
+
+/* */
+	if ( match_token( parser, "!" ) )
+		return parse_unary( parser ) || emit_insn( parser, &insn ) ? -1 : 0;
+	if ( match_token( parser, "(" ) ) {
+		if ( parse_or( parser ) )
+			return -1;
+		if ( !match_token( parser, ")" ) ) {
+			fprintf(stderr, "Missing ')' in filter expression near: %s\n", parser->pos);
+			return -1;
+		}
+		return 0;
+	}
+
+	return parse_compare( parser );
+}
+
+/**
+ * @brief Parse the comparison of one field & the constant, the constant will be converted to the
+ *        type of the field here.
+ *
+ * @param parser
+ * @return int
+ */
+static int parse_compare( FILTER_PARSER *parser )
+{
+	SAC_FILTER_INSN insn = { .op = SAC_FILTER_OP_CMP };
+	char            name[SAC_FIELD_NAME_LENGTH];
+	char           *end;
+	int             len = 0;
+
+/* The field name */
+	while ( (isalnum(parser->pos[len]) || parser->pos[len] == '_') && len < SAC_FIELD_NAME_LENGTH - 1 ) {
+		name[len] = parser->pos[len];
+		len++;
+	}
+	name[len] = '\0';
+	if ( !len || (insn.field = sacfield_find( name )) == NULL ) {
+		fprintf(stderr, "Unknown header field in filter expression near: %s\n", parser->pos);
+		return -1;
+	}
+	parser->pos += len;
+	while ( isspace(*parser->pos) )
+		parser->pos++;
+/* The relation & the constant */
+	if ( (len = parse_relation( parser )) < 0 || parse_value( parser, insn.string ) )
+		return -1;
+	insn.rel = len;
+	if ( sacfield_is_numeric( insn.field ) ) {
+		if ( insn.rel == SAC_FILTER_REL_MATCH || insn.rel == SAC_FILTER_REL_NMATCH ) {
+			fprintf(stderr, "Pattern matching is only for the string field: %s\n", insn.field->name);
+			return -1;
+		}
+		if ( insn.field->type == SAC_FIELD_TIME ) {
+			if ( (insn.number = sac_time_parse( insn.string )) < 0.0 ) {
+				fprintf(stderr, "Invalid time %s for the field %s\n", insn.string, insn.field->name);
+				return -1;
+			}
+		}
+		else {
+			insn.number = strtod(insn.string, &end);
+			if ( end == insn.string || *end != '\0' ) {
+				fprintf(stderr, "Invalid number %s for the field %s\n", insn.string, insn.field->name);
+				return -1;
+			}
+		/* Keep the same precision as the header, so the equality is exact */
+			if ( insn.field->type == SAC_FIELD_FLOAT )
+				insn.number = (float)insn.number;
+		}
+	}
+
+	return emit_insn( parser, &insn );
+}
+
+/**
+ * @brief
+ *
+ * @param parser
+ * @return int
+ * @returns: the relation on success
+ *          -1 on invalid operator
+ */
+static int parse_relation( FILTER_PARSER *parser )
+{
+	if ( match_token( parser, "==" ) || match_token( parser, "=" ) )
+		return SAC_FILTER_REL_EQ;
+	if ( match_token( parser, "!=" ) )
+		return SAC_FILTER_REL_NE;
+	if ( match_token( parser, "!~" ) )
+		return SAC_FILTER_REL_NMATCH;
+	if ( match_token( parser, "<=" ) )
+		return SAC_FILTER_REL_LE;
+	if ( match_token( parser, ">=" ) )
+		return SAC_FILTER_REL_GE;
+	if ( match_token( parser, "<" ) )
+		return SAC_FILTER_REL_LT;
+	if ( match_token( parser, ">" ) )
+		return SAC_FILTER_REL_GT;
+	if ( match_token( parser, "~" ) )
+		return SAC_FILTER_REL_MATCH;
+
+	fprintf(stderr, "Invalid operator in filter expression near: %s\n", parser->pos);
+	return -1;
+}
+
+/**
+ * @brief Parse the constant, it is either quoted or ended by the blank, ')', '&' or '|'.
+ *
+ * @param parser
+ * @param value
+ * @return int
+ */
+static int parse_value( FILTER_PARSER *parser, char *value )
+{
+	const char *pos   = parser->pos;
+	const char  quote = (*pos == '"' || *pos == '\'') ? *pos++ : '\0';
+	int         len   = 0;
+
+/* */
+	while ( *pos != '\0' && len < SAC_FIELD_VALUE_LENGTH - 1 ) {
+		if ( quote ? *pos == quote : (isspace(*pos) || strchr(")&|", *pos) != NULL) )
+			break;
+		value[len++] = *pos++;
+	}
+	value[len] = '\0';
+	if ( quote && *pos++ != quote ) {
+		fprintf(stderr, "Unterminated string in filter expression near: %s\n", parser->pos);
+		return -1;
+	}
+	if ( !len && !quote ) {
+		fprintf(stderr, "Missing value in filter expression near: %s\n", parser->pos);
+		return -1;
+	}
+/* */
+	parser->pos = pos;
+	while ( isspace(*parser->pos) )
+		parser->pos++;
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ * @param parser
+ * @param insn
+ * @return int
+ */
+static int emit_insn( FILTER_PARSER *parser, const SAC_FILTER_INSN *insn )
+{
+	if ( parser->filter->count >= SAC_FILTER_MAX_INSNS ) {
+		fprintf(stderr, "Filter expression is too long, max is %d terms\n", SAC_FILTER_MAX_INSNS);
+		return -1;
+	}
+	parser->filter->insns[parser->filter->count++] = *insn;
+
+	return 0;
+}
+
+/**
+ * @brief Consume the token & the following blanks if it is at the current position, the single '!'
+ *        won't match the beginning of "!=" or "!~".
+ *
+ * @param parser
+ * @param token
+ * @return int
+ */
+static int match_token( FILTER_PARSER *parser, const char *token )
+{
+	const int len = strlen(token);
+
+/* */
+	if ( strncmp(parser->pos, token, len) )
+		return 0;
+	if ( !strcmp(token, "!") && (parser->pos[1] == '=' || parser->pos[1] == '~') )
+		return 0;
+	if ( !strcmp(token, "=") && parser->pos[1] == '=' )
+		return 0;
+	parser->pos += len;
+	while ( isspace(*parser->pos) )
+		parser->pos++;
+
+	return 1;
+}
+
+/**
+ * @brief
+ *
+ * @param insn
+ * @param sh
+ * @return int
+ */
+static int compare_insn( const SAC_FILTER_INSN *insn, const struct SAChead *sh )
+{
+	char   string[KEVNMLEN + 1];
+	double diff;
+
+/* */
+	if ( sacfield_is_numeric( insn->field ) ) {
+		diff = sacfield_number_get( sh, insn->field ) - insn->number;
+	}
+	else {
+		sacfield_string_get( sh, insn->field, string );
+		if ( insn->rel == SAC_FILTER_REL_MATCH || insn->rel == SAC_FILTER_REL_NMATCH )
+			return (fnmatch(insn->string, string, 0) == 0) ^ (insn->rel == SAC_FILTER_REL_NMATCH);
+		diff = strcmp(string, insn->string);
+	}
+/* */
+	switch ( insn->rel ) {
+	case SAC_FILTER_REL_EQ:
+		return diff == 0.0;
+	case SAC_FILTER_REL_NE:
+		return diff != 0.0;
+	case SAC_FILTER_REL_LT:
+		return diff < 0.0;
+	case SAC_FILTER_REL_LE:
+		return diff <= 0.0;
+	case SAC_FILTER_REL_GT:
+		return diff > 0.0;
+	case SAC_FILTER_REL_GE:
+		return diff >= 0.0;
+	default:
+		break;
+	}
+
+	return 0;
+}
@@ -0,0 +1,610 @@
+/**
+ * @file sacz.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Main source code for the compressed SAC container (SACZ). The original SAC header is kept
+ *        as is, then the samples are stored by independent frames with the offset index, so any
+ *        range of samples can be decoded without touching the other frames. Within each frame,
+ *        the residuals (differences of the integer counts or XOR of the float bit patterns) are
+ *        bit-packed by blocks of 16 samples which share the same bit width, the decoding is just
+ *        fixed-length loops & prefix sums.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+/* */
+#include <sachead.h>
+#include <sacz.h>
+
+/* */
+#define ZIGZAG_ENCODE(__D)  (((uint32_t)(__D) << 1) ^ (uint32_t)((int32_t)(__D) >> 31))
+#define ZIGZAG_DECODE(__R)  (((__R) >> 1) ^ (uint32_t)-(int32_t)((__R) & 1))
+#define NUM_BLOCKS(__NSAMP) (((__NSAMP) + SACZ_BLOCK_SAMPLES - 1) / SACZ_BLOCK_SAMPLES)
+
+/* */
+static int      is_integer_frame( const float *, const int );
+static void     residual_block( const float *, const int, const int, const int, const int, uint32_t * );
+static int      width_block( const uint32_t * );
+static size_t   pack_block( const uint32_t *, const int, uint8_t * );
+static void     unpack_block( const uint8_t *, const int, uint32_t * );
+static uint64_t load_le64( const uint8_t * );
+static int      pread_full( const int, void *, const size_t, const off_t );
+
+/**
+ * @brief Check if the opened file is the container by the magic number after the SAC header, the
+ *        header should still be in the original byte order.
+ *
+ * @param fd
+ * @param sh
+ * @return int
+ * @returns: 1 if the file is the container
+ *           0 if it is not
+ */
+int sacz_file_check( const int fd, const struct SAChead *sh )
+{
+	SACZ_FILE_HEADER zh;
+
+/* */
+	if ( pread(fd, &zh, sizeof(zh), sizeof(struct SAChead)) != (ssize_t)sizeof(zh) )
+		return 0;
+
+	return zh.magic == SACZ_MAGIC && zh.version == SACZ_VERSION && zh.npts == (uint32_t)sh->npts;
+}
+
+/**
+ * @brief Write the header & the samples into the container file.
+ *
+ * @param filename
+ * @param sh
+ * @param seis
+ * @param frame_samples
+ * @return long
+ * @returns: the size of the output file on success
+ *          -1 on error writing file
+ *          -2 on out of memory
+ */
+long sacz_file_write( const char *filename, const struct SAChead *sh, const float *seis, const int frame_samples )
+{
+	FILE            *fp;
+	SACZ_FILE_HEADER zh      = { 0 };
+	uint64_t        *offsets = NULL;
+	uint8_t         *cbuf    = NULL;
+	size_t           csize;
+	int              nsamp;
+	long             result  = -1;
+
+/* */
+	if ( frame_samples <= 0 || frame_samples % SACZ_BLOCK_SAMPLES ) {
+		fprintf(stderr, "The samples of the frame should be the multiple of %d!\n", SACZ_BLOCK_SAMPLES);
+		return -1;
+	}
+	zh.magic         = SACZ_MAGIC;
+	zh.version       = SACZ_VERSION;
+	zh.npts          = sh->npts;
+	zh.frame_samples = frame_samples;
+	zh.nframes       = (sh->npts + frame_samples - 1) / frame_samples;
+	if (
+		(offsets = (uint64_t *)calloc(zh.nframes + 1, sizeof(uint64_t))) == NULL ||
+		(cbuf = (uint8_t *)malloc(SACZ_FRAME_MAX_SIZE(frame_samples))) == NULL
+	) {
+		fprintf(stderr, "ERROR! Out of memory for the compressed frames!\n");
+		free(offsets);
+		return -2;
+	}
+/* */
+	if ( (fp = fopen(filename, "wb")) == (FILE *)NULL ) {
+		fprintf(stderr, "ERROR!! Can't open %s for output!\n", filename);
+		goto end_process;
+	}
+	offsets[0] = sizeof(struct SAChead) + sizeof(zh) + (zh.nframes + 1) * sizeof(uint64_t);
+	if (
+		fwrite(sh, 1, sizeof(struct SAChead), fp) != sizeof(struct SAChead) ||
+		fwrite(&zh, 1, sizeof(zh), fp) != sizeof(zh) ||
+		fwrite(offsets, sizeof(uint64_t), zh.nframes + 1, fp) != zh.nframes + 1
+	) {
+		goto write_error;
+	}
+/* Each frame is encoded independently */
+	for ( uint32_t i = 0; i < zh.nframes; i++ ) {
+		nsamp = sh->npts - i * frame_samples;
+		nsamp = nsamp < frame_samples ? nsamp : frame_samples;
+		csize = sacz_frame_encode( seis + (size_t)i * frame_samples, nsamp, cbuf );
+		if ( fwrite(cbuf, 1, csize, fp) != csize )
+			goto write_error;
+		offsets[i + 1] = offsets[i] + csize;
+	}
+/* Then the index */
+	if (
+		fseek(fp, sizeof(struct SAChead) + sizeof(zh), SEEK_SET) ||
+		fwrite(offsets, sizeof(uint64_t), zh.nframes + 1, fp) != zh.nframes + 1
+	) {
+		goto write_error;
+	}
+	if ( fclose(fp) ) {
+		fp = NULL;
+		goto write_error;
+	}
+	result = (long)offsets[zh.nframes];
+	goto end_process;
+
+write_error:
+	fprintf(stderr, "Error writing SAC file: %s\n", strerror(errno));
+	if ( fp )
+		fclose(fp);
+	remove(filename);
+end_process:
+	free(offsets);
+	free(cbuf);
+	return result;
+}
+
+/**
+ * @brief Decode the range of samples [start, start + nsamp) of the opened container file, only the
+ *        frames covered by the range will be read.
+ *
+ * @param fd
+ * @param buffer
+ * @param start
+ * @param nsamp
+ * @return int
+ * @returns: number of samples read
+ *          -1 on error reading file
+ *          -2 on out of memory
+ */
+int sacz_data_pread( const int fd, float *buffer, const int start, const int nsamp )
+{
+	SACZ_READER reader;
+	int         result;
+
+/* */
+	if ( (result = sacz_reader_open( &reader, fd )) < 0 )
+		return result;
+	result = sacz_reader_read( &reader, buffer, start, nsamp );
+	sacz_reader_close( &reader );
+
+	return result;
+}
+
+/**
+ * @brief Open the reader on the opened container file, the frame index will be loaded.
+ *
+ * @param reader
+ * @param fd
+ * @return int
+ * @returns: 0 on success
+ *          -1 on error reading file or the broken container
+ *          -2 on out of memory
+ */
+int sacz_reader_open( SACZ_READER *reader, const int fd )
+{
+	SACZ_FILE_HEADER zh;
+
+/* */
+	memset(reader, 0, sizeof(SACZ_READER));
+	reader->fd     = fd;
+	reader->cached = -1;
+	if ( pread_full( fd, &zh, sizeof(zh), sizeof(struct SAChead) ) )
+		return -1;
+	if (
+		zh.magic != SACZ_MAGIC || zh.version != SACZ_VERSION ||
+		!zh.frame_samples || zh.frame_samples % SACZ_BLOCK_SAMPLES || zh.npts > INT32_MAX ||
+		zh.nframes != (zh.npts + zh.frame_samples - 1) / zh.frame_samples
+	) {
+		fprintf(stderr, "Error reading SAC data: broken compressed container!\n");
+		return -1;
+	}
+	reader->npts          = zh.npts;
+	reader->frame_samples = zh.frame_samples;
+	reader->nframes       = zh.nframes;
+/* */
+	if (
+		(reader->offsets = (uint64_t *)malloc((zh.nframes + 1) * sizeof(uint64_t))) == NULL ||
+		(reader->cbuf = (uint8_t *)malloc(SACZ_FRAME_MAX_SIZE(zh.frame_samples))) == NULL ||
+		(reader->frame = (float *)malloc(zh.frame_samples * sizeof(float))) == NULL
+	) {
+		fprintf(stderr, "ERROR! Out of memory for the compressed frames!\n");
+		sacz_reader_close( reader );
+		return -2;
+	}
+	if ( pread_full( fd, reader->offsets, (zh.nframes + 1) * sizeof(uint64_t), sizeof(struct SAChead) + sizeof(zh) ) ) {
+		sacz_reader_close( reader );
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Read the range of samples [start, start + nsamp), the frames fully covered by the range
+ *        are decoded into the buffer directly, the partial ones through the frame cache.
+ *
+ * @param reader
+ * @param buffer
+ * @param start
+ * @param nsamp
+ * @return int
+ * @returns: number of samples read
+ *          -1 on error reading file or the broken frame
+ */
+int sacz_reader_read( SACZ_READER *reader, float *buffer, const int start, const int nsamp )
+{
+	const int end = start + nsamp;
+
+	int    first, count, fsamp;
+	size_t csize;
+	float *dest;
+
+/* */
+	if ( start < 0 || nsamp < 0 || end > reader->npts ) {
+		fprintf(stderr, "Error reading SAC data: range [%d, %d) is out of the data!\n", start, end);
+		return -1;
+	}
+	for ( int pos = start; pos < end; pos += count ) {
+		const int index = pos / reader->frame_samples;
+
+		first = index * reader->frame_samples;
+		fsamp = reader->npts - first < reader->frame_samples ? reader->npts - first : reader->frame_samples;
+		count = (first + fsamp < end ? first + fsamp : end) - pos;
+	/* */
+		if ( index != reader->cached ) {
+			csize = reader->offsets[index + 1] - reader->offsets[index];
+			if ( reader->offsets[index + 1] < reader->offsets[index] || csize > SACZ_FRAME_MAX_SIZE(reader->frame_samples) - SACZ_FRAME_PADDING ) {
+				fprintf(stderr, "Error reading SAC data: broken index of frame #%d!\n", index);
+				return -1;
+			}
+			if ( pread_full( reader->fd, reader->cbuf, csize, reader->offsets[index] ) )
+				return -1;
+			dest = count == fsamp ? buffer + (pos - start) : reader->frame;
+			if ( sacz_frame_decode( reader->cbuf, csize, fsamp, dest ) ) {
+				fprintf(stderr, "Error reading SAC data: broken frame #%d!\n", index);
+				return -1;
+			}
+			if ( dest != reader->frame )
+				continue;
+			reader->cached = index;
+		}
+		memcpy(buffer + (pos - start), reader->frame + (pos - first), count * sizeof(float));
+	}
+
+	return nsamp;
+}
+
+/**
+ * @brief
+ *
+ * @param reader
+ */
+void sacz_reader_close( SACZ_READER *reader )
+{
+	free(reader->offsets);
+	free(reader->cbuf);
+	free(reader->frame);
+	reader->offsets = NULL;
+	reader->cbuf    = NULL;
+	reader->frame   = NULL;
+	reader->cached  = -1;
+
+	return;
+}
+
+/**
+ * @brief Encode one frame, the integer codec is tried with both the 1st & 2nd order differences,
+ *        the raw samples will be kept if the packed residuals are not smaller. The output buffer
+ *        should be at least SACZ_FRAME_MAX_SIZE(nsamp) bytes.
+ *
+ * @param seis
+ * @param nsamp
+ * @param output
+ * @return size_t
+ * @returns: the size of the encoded frame
+ */
+size_t sacz_frame_encode( const float *seis, const int nsamp, uint8_t *output )
+{
+	const int nblocks = NUM_BLOCKS(nsamp);
+	const size_t rawsize = sizeof(SACZ_FRAME_HEADER) + nsamp * sizeof(float);
+
+	SACZ_FRAME_HEADER fh = { SACZ_CODEC_FLOAT, 0, 0, 0 };
+	uint32_t          res[SACZ_BLOCK_SAMPLES];
+	uint8_t          *widths = output + sizeof(SACZ_FRAME_HEADER);
+	uint8_t          *packed = widths + nblocks;
+	size_t            cost[3] = { 0 };
+	int               ivalue;
+
+/* Choose the codec & the order by the total width of the blocks */
+	if ( nsamp > 0 && is_integer_frame( seis, nsamp ) ) {
+		for ( int order = 1; order <= 2; order++ ) {
+			for ( int i = 0; i < nblocks; i++ ) {
+				residual_block( seis, nsamp, SACZ_CODEC_INT, order, i * SACZ_BLOCK_SAMPLES, res );
+				cost[order] += width_block( res );
+			}
+		}
+		fh.codec = SACZ_CODEC_INT;
+		fh.order = cost[2] < cost[1] ? 2 : 1;
+		ivalue   = (int32_t)seis[0];
+		memcpy(&fh.first, &ivalue, sizeof(uint32_t));
+	}
+	else if ( nsamp > 0 ) {
+		memcpy(&fh.first, seis, sizeof(uint32_t));
+	}
+/* */
+	for ( int i = 0; i < nblocks; i++ ) {
+		residual_block( seis, nsamp, fh.codec, fh.order, i * SACZ_BLOCK_SAMPLES, res );
+		widths[i] = width_block( res );
+		packed   += pack_block( res, widths[i], packed );
+		if ( (size_t)(packed - output) >= rawsize )
+			break;
+	}
+/* The packed one is not smaller, just keep the raw samples */
+	if ( (size_t)(packed - output) >= rawsize ) {
+		fh.codec = SACZ_CODEC_RAW;
+		fh.order = 0;
+		fh.first = 0;
+		memcpy(output + sizeof(SACZ_FRAME_HEADER), seis, nsamp * sizeof(float));
+		packed = output + rawsize;
+	}
+	memcpy(output, &fh, sizeof(SACZ_FRAME_HEADER));
+
+	return packed - output;
+}
+
+/**
+ * @brief Decode one frame into the output buffer of nsamp samples. The input buffer should be
+ *        readable for SACZ_FRAME_PADDING bytes after the frame.
+ *
+ * @param input
+ * @param size
+ * @param nsamp
+ * @param output
+ * @return int
+ * @returns: 0 on success
+ *          -1 on the broken frame
+ */
+int sacz_frame_decode( const uint8_t *input, const size_t size, const int nsamp, float *output )
+{
+	const int nblocks = NUM_BLOCKS(nsamp);
+
+	SACZ_FRAME_HEADER fh;
+	const uint8_t    *widths = input + sizeof(SACZ_FRAME_HEADER);
+	const uint8_t    *packed = widths + nblocks;
+	uint32_t          res[SACZ_BLOCK_SAMPLES];
+	uint32_t          value, delta = 0;
+	size_t            total = sizeof(SACZ_FRAME_HEADER) + nblocks;
+	int               count;
+
+/* */
+	if ( size < sizeof(SACZ_FRAME_HEADER) )
+		return -1;
+	memcpy(&fh, input, sizeof(SACZ_FRAME_HEADER));
+	if ( fh.codec == SACZ_CODEC_RAW ) {
+		if ( size != sizeof(SACZ_FRAME_HEADER) + nsamp * sizeof(float) )
+			return -1;
+		memcpy(output, input + sizeof(SACZ_FRAME_HEADER), nsamp * sizeof(float));
+		return 0;
+	}
+	if ( (fh.codec != SACZ_CODEC_INT && fh.codec != SACZ_CODEC_FLOAT) || (fh.codec == SACZ_CODEC_INT && (fh.order < 1 || fh.order > 2)) )
+		return -1;
+/* Check the size with the widths first, so the unpacking won't go out of the frame */
+	if ( size < total )
+		return -1;
+	for ( int i = 0; i < nblocks; i++ ) {
+		if ( widths[i] > 32 )
+			return -1;
+		total += widths[i] * 2;
+	}
+	if ( total != size )
+		return -1;
+/* */
+	value = fh.first;
+	for ( int i = 0; i < nblocks; i++ ) {
+		unpack_block( packed, widths[i], res );
+		packed += widths[i] * 2;
+		count   = nsamp - i * SACZ_BLOCK_SAMPLES;
+		count   = count < SACZ_BLOCK_SAMPLES ? count : SACZ_BLOCK_SAMPLES;
+	/* The prefix sums, the integer ones are in the modular arithmetic, so it is exact */
+		if ( fh.codec == SACZ_CODEC_FLOAT ) {
+			for ( int j = 0; j < count; j++ ) {
+				value ^= res[j];
+				memcpy(output + i * SACZ_BLOCK_SAMPLES + j, &value, sizeof(float));
+			}
+		}
+		else if ( fh.order == 1 ) {
+			for ( int j = 0; j < count; j++ ) {
+				value += ZIGZAG_DECODE(res[j]);
+				output[i * SACZ_BLOCK_SAMPLES + j] = (float)(int32_t)value;
+			}
+		}
+		else {
+			for ( int j = 0; j < count; j++ ) {
+				delta += ZIGZAG_DECODE(res[j]);
+				value += delta;
+				output[i * SACZ_BLOCK_SAMPLES + j] = (float)(int32_t)value;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Check if all the samples are the integers which can be restored bit by bit, i.e. the
+ *        quantized counts. The negative zero is excluded.
+ *
+ * @param seis
+ * @param nsamp
+ * @return int
+ */
+static int is_integer_frame( const float *seis, const int nsamp )
+{
+	float    fvalue;
+	uint32_t bits[2];
+
+/* */
+	for ( int i = 0; i < nsamp; i++ ) {
+		if ( !(seis[i] >= -2147483648.0f && seis[i] < 2147483648.0f) )
+			return 0;
+		fvalue = (float)(int32_t)seis[i];
+		memcpy(bits, seis + i, sizeof(float));
+		memcpy(bits + 1, &fvalue, sizeof(float));
+		if ( bits[0] != bits[1] )
+			return 0;
+	}
+
+	return 1;
+}
+
+/**
+ * @brief Generate the residuals of the block starting at the sample index first, the residual of
+ *        the first sample within the frame & those after the end are zero.
+ *
+ * @param seis
+ * @param nsamp
+ * @param codec
+ * @param order
+ * @param first
+ * @param res
+ */
+static void residual_block( const float *seis, const int nsamp, const int codec, const int order, const int first, uint32_t *res )
+{
+	uint32_t x0, x1, x2;
+
+/* */
+	for ( int j = 0; j < SACZ_BLOCK_SAMPLES; j++ ) {
+		const int i = first + j;
+
+		if ( i < 1 || i >= nsamp ) {
+			res[j] = 0;
+		}
+		else if ( codec == SACZ_CODEC_FLOAT ) {
+			memcpy(&x0, seis + i, sizeof(uint32_t));
+			memcpy(&x1, seis + i - 1, sizeof(uint32_t));
+			res[j] = x0 ^ x1;
+		}
+		else {
+			x0 = (uint32_t)(int32_t)seis[i];
+			x1 = (uint32_t)(int32_t)seis[i - 1];
+			x2 = i > 1 && order == 2 ? (uint32_t)(int32_t)seis[i - 2] : x1;
+			res[j] = order == 2 ? ZIGZAG_ENCODE((x0 - x1) - (x1 - x2)) : ZIGZAG_ENCODE(x0 - x1);
+		}
+	}
+
+	return;
+}
+
+/**
+ * @brief
+ *
+ * @param res
+ * @return int
+ * @returns: the number of bits to hold all the residuals of the block
+ */
+static int width_block( const uint32_t *res )
+{
+	uint32_t bits = 0;
+
+/* */
+	for ( int j = 0; j < SACZ_BLOCK_SAMPLES; j++ )
+		bits |= res[j];
+
+	return bits ? 32 - __builtin_clz(bits) : 0;
+}
+
+/**
+ * @brief Pack the residuals of the block into width * 2 bytes, from the least significant bit.
+ *
+ * @param res
+ * @param width
+ * @param output
+ * @return size_t
+ */
+static size_t pack_block( const uint32_t *res, const int width, uint8_t *output )
+{
+	uint64_t acc   = 0;
+	int      nbits = 0;
+	size_t   size  = 0;
+
+/* */
+	for ( int j = 0; j < SACZ_BLOCK_SAMPLES; j++ ) {
+		acc   |= (uint64_t)res[j] << nbits;
+		nbits += width;
+		for ( ; nbits >= 8; nbits -= 8, acc >>= 8 )
+			output[size++] = (uint8_t)acc;
+	}
+
+	return size;
+}
+
+/**
+ * @brief Unpack the residuals of the block, each one is extracted by a 8-byte load, so there is no
+ *        dependency between the samples.
+ *
+ * @param input
+ * @param width
+ * @param res
+ */
+static void unpack_block( const uint8_t *input, const int width, uint32_t *res )
+{
+	const uint64_t mask = (1ULL << width) - 1;
+
+/* */
+	for ( int j = 0; j < SACZ_BLOCK_SAMPLES; j++ ) {
+		const int pos = j * width;
+
+		res[j] = (uint32_t)((load_le64( input + (pos >> 3) ) >> (pos & 7)) & mask);
+	}
+
+	return;
+}
+
+/**
+ * @brief
+ *
+ * @param input
+ * @return uint64_t
+ */
+static uint64_t load_le64( const uint8_t *input )
+{
+	uint64_t result;
+
+/* */
+	memcpy(&result, input, sizeof(uint64_t));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	result = __builtin_bswap64(result);
+#endif
+
+	return result;
+}
+
+/**
+ * @brief The ranged read might be partial, so keep reading.
+ *
+ * @param fd
+ * @param buffer
+ * @param size
+ * @param offset
+ * @return int
+ * @returns: 0 on success
+ *          -1 on error reading file
+ */
+static int pread_full( const int fd, void *buffer, const size_t size, const off_t offset )
+{
+	size_t  done = 0;
+	ssize_t nread;
+
+/* */
+	while ( done < size ) {
+		if ( (nread = pread(fd, (uint8_t *)buffer + done, size - done, offset + done)) <= 0 ) {
+			fprintf(stderr, "Error reading SAC data: %s\n", nread ? strerror(errno) : "unexpected end of file");
+			return -1;
+		}
+		done += nread;
+	}
+
+	return 0;
+}
@@ -0,0 +1,396 @@
+/**
+ * @file stadb.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Main source code for the station metadata database. The station list is parsed once into
+ *        the open addressing (linear probing) hash table keyed by the packed SCNL, and the table can
+ *        be persisted as the binary snapshot which is mapped back without any parsing.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+/* */
+#include <sachead.h>
+#include <sac.h>
+#include <stadb.h>
+
+/* */
+#define FNV_OFFSET_BASIS  0xcbf29ce484222325ULL
+#define FNV_PRIME         0x100000001b3ULL
+
+/* */
+static uint64_t     hash_scnl_key( const char * );
+static STADB_ENTRY *probe_table( STADB_ENTRY *, const uint32_t, const char * );
+static void         insert_entry( STADB *, const STADB_ENTRY * );
+static void         default_orientation( const char *, float *, float * );
+
+/**
+ * @brief Open the database, the snapshot will be mapped & the others will be parsed as the station list.
+ *
+ * @param path
+ * @param db
+ * @return int
+ * @returns: number of the channels on success
+ *          -1 on error opening or reading file
+ *          -2 on out of memory
+ */
+int stadb_open( const char *path, STADB *db )
+{
+	FILE    *fp;
+	uint64_t magic = 0;
+
+/* Check the magic number of the snapshot */
+	if ( (fp = fopen(path, "rb")) == NULL ) {
+		fprintf(stderr, "Error opening %s\n", path);
+		return -1;
+	}
+	if ( fread(&magic, sizeof(magic), 1, fp) != 1 )
+		magic = 0;
+	fclose(fp);
+
+	return magic == STADB_SNAPSHOT_MAGIC ? stadb_snapshot_map( path, db ) : stadb_list_load( path, db );
+}
+
+/**
+ * @brief Parse the station list, each line is:
+ *          sta net loc lat lon elev chanZ gainZ chanN gainN chanE gainE [azZ incZ azN incN azE incE]
+ *        the orientations will be derived from the channel codes if they are not listed.
+ *
+ * @param filename
+ * @param db
+ * @return int
+ * @returns: number of the channels on success
+ *          -1 on error opening file
+ *          -2 on out of memory
+ */
+int stadb_list_load( const char *filename, STADB *db )
+{
+	FILE       *fp;
+	STADB_ENTRY entry;
+	int         nfields;
+	int         nlines = 0;
+	char        line[STADB_MAX_LINE_LENGTH];
+	char        sta[K_LEN + 1], net[K_LEN + 1], loc[K_LEN + 1];
+	char        chan[STADB_NUM_COMPONENTS][K_LEN + 1];
+	double      lat, lon, elev;
+	double      gain[STADB_NUM_COMPONENTS];
+	float       orient[STADB_NUM_COMPONENTS * 2];
+
+/* */
+	memset(db, 0, sizeof(STADB));
+	if ( (fp = fopen(filename, "r")) == NULL ) {
+		fprintf(stderr, "Error opening %s\n", filename);
+		return -1;
+	}
+/* Count the lines first, so the table won't need to grow */
+	while ( fgets(line, sizeof(line), fp) )
+		nlines++;
+	for ( db->capacity = 16; db->capacity < (uint32_t)nlines * STADB_NUM_COMPONENTS * 2; db->capacity <<= 1 );
+	if ( (db->table = (STADB_ENTRY *)calloc(db->capacity, sizeof(STADB_ENTRY))) == NULL ) {
+		fprintf(stderr, "ERROR! Out of memory for %u station entries\n", db->capacity);
+		fclose(fp);
+		return -2;
+	}
+/* */
+	rewind(fp);
+	while ( fgets(line, sizeof(line), fp) ) {
+		if ( line[0] == '#' )
+			continue;
+		nfields = sscanf(
+			line, "%8s %8s %8s %lf %lf %lf %8s %lf %8s %lf %8s %lf %f %f %f %f %f %f",
+			sta, net, loc, &lat, &lon, &elev, chan[0], &gain[0], chan[1], &gain[1], chan[2], &gain[2],
+			&orient[0], &orient[1], &orient[2], &orient[3], &orient[4], &orient[5]
+		);
+		if ( nfields < 12 )
+			continue;
+	/* One entry of each component */
+		for ( int i = 0; i < STADB_NUM_COMPONENTS; i++ ) {
+			memset(&entry, 0, sizeof(STADB_ENTRY));
+			sac_scnl_key_pack( entry.key, sta, chan[i], net, loc );
+			entry.latitude  = lat;
+			entry.longitude = lon;
+			entry.elevation = elev;
+			entry.gain      = gain[i];
+			if ( nfields >= 18 ) {
+				entry.cmpaz  = orient[i * 2];
+				entry.cmpinc = orient[i * 2 + 1];
+			}
+			else {
+				default_orientation( chan[i], &entry.cmpaz, &entry.cmpinc );
+			}
+			insert_entry( db, &entry );
+		}
+	}
+	fclose(fp);
+
+	return db->count;
+}
+
+/**
+ * @brief Persist the whole hash table as the snapshot.
+ *
+ * @param db
+ * @param filename
+ * @return int
+ * @returns: 0 on success
+ *          -1 on error writing file
+ */
+int stadb_snapshot_save( const STADB *db, const char *filename )
+{
+	FILE                 *fp;
+	STADB_SNAPSHOT_HEADER header;
+
+/* */
+	memset(&header, 0, sizeof(header));
+	header.magic      = STADB_SNAPSHOT_MAGIC;
+	header.version    = STADB_SNAPSHOT_VERSION;
+	header.entry_size = sizeof(STADB_ENTRY);
+	header.capacity   = db->capacity;
+	header.count      = db->count;
+/* */
+	if ( (fp = fopen(filename, "wb")) == NULL ) {
+		fprintf(stderr, "ERROR!! Can't open %s for output!\n", filename);
+		return -1;
+	}
+	if (
+		fwrite(&header, sizeof(header), 1, fp) != 1 ||
+		fwrite(db->table, sizeof(STADB_ENTRY), db->capacity, fp) != db->capacity
+	) {
+		fprintf(stderr, "Error writing station snapshot: %s\n", strerror(errno));
+		fclose(fp);
+		remove(filename);
+		return -1;
+	}
+	fclose(fp);
+
+	return 0;
+}
+
+/**
+ * @brief Map the snapshot as the database, nothing will be parsed or copied.
+ *
+ * @param filename
+ * @param db
+ * @return int
+ * @returns: number of the channels on success
+ *          -1 on error opening file or invalid snapshot
+ */
+int stadb_snapshot_map( const char *filename, STADB *db )
+{
+	int                          fd;
+	struct stat                  st;
+	const STADB_SNAPSHOT_HEADER *header;
+
+/* */
+	memset(db, 0, sizeof(STADB));
+	if ( (fd = open(filename, O_RDONLY)) < 0 ) {
+		fprintf(stderr, "Error opening %s\n", filename);
+		return -1;
+	}
+	if ( fstat(fd, &st) || st.st_size < (off_t)sizeof(STADB_SNAPSHOT_HEADER) ) {
+		fprintf(stderr, "Invalid station snapshot %s\n", filename);
+		close(fd);
+		return -1;
+	}
+	db->map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if ( db->map == MAP_FAILED ) {
+		fprintf(stderr, "Error mapping %s: %s\n", filename, strerror(errno));
+		db->map = NULL;
+		return -1;
+	}
+	db->map_size = st.st_size;
+/* */
+	header = (const STADB_SNAPSHOT_HEADER *)db->map;
+	if (
+		header->magic != STADB_SNAPSHOT_MAGIC || header->version != STADB_SNAPSHOT_VERSION ||
+		header->entry_size != sizeof(STADB_ENTRY) || (header->capacity & (header->capacity - 1)) ||
+		db->map_size != sizeof(STADB_SNAPSHOT_HEADER) + (size_t)header->capacity * sizeof(STADB_ENTRY)
+	) {
+		fprintf(stderr, "Invalid station snapshot %s\n", filename);
+		stadb_close( db );
+		return -1;
+	}
+	db->table    = (STADB_ENTRY *)(header + 1);
+	db->capacity = header->capacity;
+	db->count    = header->count;
+
+	return db->count;
+}
+
+/**
+ * @brief
+ *
+ * @param db
+ */
+void stadb_close( STADB *db )
+{
+	if ( db->map )
+		munmap(db->map, db->map_size);
+	else
+		free(db->table);
+	memset(db, 0, sizeof(STADB));
+
+	return;
+}
+
+/**
+ * @brief
+ *
+ * @param db
+ * @param sta
+ * @param chan
+ * @param net
+ * @param loc
+ * @return const STADB_ENTRY*
+ */
+const STADB_ENTRY *stadb_find( const STADB *db, const char *sta, const char *chan, const char *net, const char *loc )
+{
+	STADB_ENTRY *result;
+	char         key[STADB_KEY_LENGTH];
+
+/* */
+	if ( !db->capacity )
+		return NULL;
+	sac_scnl_key_pack( key, sta, chan, net, loc );
+	result = probe_table( db->table, db->capacity, key );
+
+	return result->used ? result : NULL;
+}
+
+/**
+ * @brief Find the entry by the SCNL of the SAC header, the blank padded codes are packed directly.
+ *
+ * @param db
+ * @param sh
+ * @return const STADB_ENTRY*
+ */
+const STADB_ENTRY *stadb_find_sac( const STADB *db, const struct SAChead *sh )
+{
+	STADB_ENTRY *result;
+	char         key[STADB_KEY_LENGTH];
+
+/* */
+	if ( !db->capacity )
+		return NULL;
+	sac_scnl_key_fetch( key, sh );
+	result = probe_table( db->table, db->capacity, key );
+
+	return result->used ? result : NULL;
+}
+
+/**
+ * @brief Fill the station coordinates & the component orientation into the SAC header.
+ *
+ * @param sh
+ * @param entry
+ * @return struct SAChead*
+ */
+struct SAChead *stadb_header_fill( struct SAChead *sh, const STADB_ENTRY *entry )
+{
+	sh->stla   = entry->latitude;
+	sh->stlo   = entry->longitude;
+	sh->stel   = entry->elevation;
+	sh->cmpaz  = entry->cmpaz;
+	sh->cmpinc = entry->cmpinc;
+
+	return sh;
+}
+
+/**
+ * @brief FNV-1a of the packed key.
+ *
+ * @param key
+ * @return uint64_t
+ */
+static uint64_t hash_scnl_key( const char *key )
+{
+	uint64_t result = FNV_OFFSET_BASIS;
+
+/* */
+	for ( int i = 0; i < STADB_KEY_LENGTH; i++ ) {
+		result ^= (uint8_t)key[i];
+		result *= FNV_PRIME;
+	}
+
+	return result;
+}
+
+/**
+ * @brief Linear probing, it returns the slot of the key or the first empty slot.
+ *
+ * @param table
+ * @param capacity
+ * @param key
+ * @return STADB_ENTRY*
+ */
+static STADB_ENTRY *probe_table( STADB_ENTRY *table, const uint32_t capacity, const char *key )
+{
+	const uint32_t mask = capacity - 1;
+	uint32_t       i    = (uint32_t)hash_scnl_key( key ) & mask;
+
+/* The table is never full, so the probing always stops */
+	while ( table[i].used && memcmp(table[i].key, key, STADB_KEY_LENGTH) )
+		i = (i + 1) & mask;
+
+	return table + i;
+}
+
+/**
+ * @brief Insert or replace the entry, the load factor is kept under 0.5.
+ *
+ * @param db
+ * @param entry
+ */
+static void insert_entry( STADB *db, const STADB_ENTRY *entry )
+{
+	STADB_ENTRY *slot = probe_table( db->table, db->capacity, entry->key );
+
+/* */
+	if ( !slot->used )
+		db->count++;
+	*slot      = *entry;
+	slot->used = 1;
+
+	return;
+}
+
+/**
+ * @brief The same default orientations as sac_az_inc_modify().
+ *
+ * @param chan
+ * @param cmpaz
+ * @param cmpinc
+ */
+static void default_orientation( const char *chan, float *cmpaz, float *cmpinc )
+{
+	switch ( strlen(chan) > 2 ? chan[2] : '\0' ) {
+	case 'Z' : case 'z' :
+		*cmpaz  = 0.0;
+		*cmpinc = 0.0;
+		break;
+	case 'N' : case 'n' :
+		*cmpaz  = 0.0;
+		*cmpinc = 90.0;
+		break;
+	case 'E' : case 'e' :
+		*cmpaz  = 90.0;
+		*cmpinc = 90.0;
+		break;
+	default :
+		*cmpaz  = SACUNDEF;
+		*cmpinc = SACUNDEF;
+		break;
+	}
+
+	return;
+}
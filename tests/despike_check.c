@@ -0,0 +1,127 @@
+/**
+ * @file despike_check.c
+ * @author Benjamin Ming Yang (b98204032@gmail.com)
+ * @brief Regression check of the despike stage: nothing should be replaced on the smooth signal,
+ *        and the spikes at both edges & in the middle should be replaced.
+ * @version 1.0.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026-now
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+/* */
+#include <despike.h>
+
+/* */
+#define CHECK_NPTS      1000
+#define CHECK_WINDOW    21
+#define CHECK_SPIKE     30.0f
+
+/* */
+static void gen_smooth_signal( float *, const int );
+static int  check_smooth( void );
+static int  check_spikes( void );
+
+/**
+ * @brief
+ *
+ * @return int
+ */
+int main( void )
+{
+	int result = 0;
+
+/* */
+	result |= check_smooth();
+	result |= check_spikes();
+	fprintf(stderr, "Despike regression check %s!\n", result ? "failed" : "passed");
+
+	return result;
+}
+
+/**
+ * @brief The sine of 100 samples period with the uniform noise of 0.01.
+ *
+ * @param seis
+ * @param npts
+ */
+static void gen_smooth_signal( float *seis, const int npts )
+{
+	srand(1);
+	for ( int i = 0; i < npts; i++ )
+		seis[i] = sin(2.0 * M_PI * i / 100.0) + 0.01 * ((double)rand() / RAND_MAX - 0.5);
+
+	return;
+}
+
+/**
+ * @brief
+ *
+ * @return int
+ */
+static int check_smooth( void )
+{
+	float seis[CHECK_NPTS];
+	float orig[CHECK_NPTS];
+	int   nspikes;
+	int   nchanged = 0;
+
+/* */
+	gen_smooth_signal( seis, CHECK_NPTS );
+	for ( int i = 0; i < CHECK_NPTS; i++ )
+		orig[i] = seis[i];
+	nspikes = despike_process( seis, CHECK_NPTS, CHECK_WINDOW, DESPIKE_DEF_FACTOR );
+	for ( int i = 0; i < CHECK_NPTS; i++ )
+		nchanged += seis[i] != orig[i];
+	if ( nspikes || nchanged ) {
+		fprintf(stderr, "Smooth signal: %d spikes reported & %d samples changed, expected none!\n", nspikes, nchanged);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief
+ *
+ * @return int
+ */
+static int check_spikes( void )
+{
+	const int spikes[] = { 0, 2, CHECK_WINDOW / 2, 500, CHECK_NPTS - 3, CHECK_NPTS - 1 };
+	const int nspikes  = sizeof(spikes) / sizeof(spikes[0]);
+
+	float seis[CHECK_NPTS];
+	float orig[CHECK_NPTS];
+	int   result = 0;
+	int   count;
+
+/* */
+	gen_smooth_signal( orig, CHECK_NPTS );
+	for ( int i = 0; i < CHECK_NPTS; i++ )
+		seis[i] = orig[i];
+	for ( int i = 0; i < nspikes; i++ )
+		seis[spikes[i]] += CHECK_SPIKE;
+	if ( (count = despike_process( seis, CHECK_NPTS, CHECK_WINDOW, DESPIKE_DEF_FACTOR )) != nspikes ) {
+		fprintf(stderr, "Spikes: %d spikes reported, expected %d!\n", count, nspikes);
+		result = -1;
+	}
+/* The spikes are replaced by the local median within the signal, the others are untouched */
+	for ( int i = 0, j = 0; i < CHECK_NPTS; i++ ) {
+		if ( j < nspikes && i == spikes[j] ) {
+			j++;
+			if ( fabsf(seis[i]) <= 1.01f )
+				continue;
+		}
+		else if ( seis[i] == orig[i] ) {
+			continue;
+		}
+		fprintf(stderr, "Spikes: sample %d is %f, the original is %f!\n", i, seis[i], orig[i]);
+		result = -1;
+	}
+
+	return result;
+}